@@ -1,4 +1,4 @@
-QT += core gui widgets multimedia
+QT += core gui widgets concurrent network
 
 TARGET = cursor-locker
 TEMPLATE = app
@@ -9,21 +9,15 @@ QMAKE_CXXFLAGS += /std:c++17 /O2
 CONFIG(debug, debug|release): DEFINES += DEBUG
 CONFIG(release, debug|release): DEFINES += RELEASE
 
-# SUBMODULE: Qt Process Scanner Widget
-# ==================================================
-INCLUDEPATH += submodules/qt-process-scanner-widget/
-
-SOURCES += \
-    submodules/qt-process-scanner-widget/process_scanner.cpp \
-    submodules/qt-process-scanner-widget/process_scanner_dialog.cxx
-
-HEADERS += \
-    submodules/qt-process-scanner-widget/process_scanner.hpp \
-    submodules/qt-process-scanner-widget/process_scanner_dialog.hxx
-
-FORMS += \
-    submodules/qt-process-scanner-widget/process_scanner_dialog.ui
-# ==================================================
+# Building with CONFIG+=no_sound leaves out the sound cues along with the Qt Multimedia libraries,
+# which are the largest part of the footprint that isn't needed to lock the cursor.
+no_sound {
+    DEFINES += CURSORLOCKER_NO_SOUND
+} else {
+    QT += multimedia
+    SOURCES += source/sound_mixer.cpp
+    RESOURCES += resources/resources.qrc
+}
 
 # SUBMODULE: Qt Hotkey Recorder Widget
 # ==================================================
@@ -39,35 +33,88 @@ HEADERS     += \
 # ==================================================
 
 
-# SUBMODULE: Qt Vkid Table Widget
-# ==================================================
-INCLUDEPATH += submodules/qt-vkid-table-widget/
-SOURCES     += submodules/qt-vkid-table-widget/vkid_table_widget.cpp
-HEADERS     += submodules/qt-vkid-table-widget/vkid_table_widget.hpp
-# ==================================================
-
-
 SOURCES += \
     source/main.cpp \
     source/debugging.cpp \
     source/main_window_dialog.cxx \
     source/json_settings_dialog.cxx \
-    source/vkid_table_widget_dialog.cxx
+    source/vkid_table_widget_dialog.cxx \
+    source/hotkey_registry.cpp \
+    source/low_level_keyboard_hook.cpp \
+    source/key_sequence_matcher.cpp \
+    source/vkid_table.cpp \
+    source/process_snapshot_service.cpp \
+    source/process_snapshot_dialog.cxx \
+    source/process_list_model.cpp \
+    source/cursor_lock.cpp \
+    source/foreground_window_watcher.cpp \
+    source/foreground_owner_resolver.cpp \
+    source/clip_geometry.cpp \
+    source/control_server.cpp \
+    source/control_client.cpp \
+    source/metrics_registry.cpp \
+    source/cursor_escape_watchdog.cpp \
+    source/single_instance_guard.cpp \
+    source/launch_options.cpp \
+    source/stylesheet_cache.cpp \
+    source/activation_engine.cpp \
+    source/activation_rule.cpp \
+    source/activation_recording.cpp \
+    source/power_state_monitor.cpp \
+    source/memory_audit.cpp \
+    source/string_interner.cpp \
+    source/activation_source_manager.cpp \
+    source/fullscreen_detector.cpp
 
 HEADERS += \
     source/anonymous_event_filter.hpp \
     source/debugging.hpp \
     source/main_window_dialog.hxx \
     source/json_settings_dialog.hxx \
-    source/vkid_table_widget_dialog.hxx
+    source/vkid_table_widget_dialog.hxx \
+    source/hotkey_registry.hpp \
+    source/low_level_keyboard_hook.hpp \
+    source/key_sequence_matcher.hpp \
+    source/vkid_table.hpp \
+    source/process_snapshot_service.hpp \
+    source/process_snapshot_dialog.hxx \
+    source/process_list_model.hpp \
+    source/cursor_lock.hpp \
+    source/sound_mixer.hpp \
+    source/foreground_window_watcher.hpp \
+    source/foreground_owner_resolver.hpp \
+    source/clip_geometry.hpp \
+    source/control_server.hpp \
+    source/control_client.hpp \
+    source/metrics_registry.hpp \
+    source/cursor_escape_watchdog.hpp \
+    source/single_instance_guard.hpp \
+    source/launch_options.hpp \
+    source/stylesheet_cache.hpp \
+    source/activation_engine.hpp \
+    source/activation_rule.hpp \
+    source/activation_recording.hpp \
+    source/power_state_monitor.hpp \
+    source/memory_audit.hpp \
+    source/string_interner.hpp \
+    source/activation_source_interface.hpp \
+    source/activation_source_manager.hpp \
+    source/fullscreen_detector.hpp
 
 FORMS += \
     source/main_window_dialog.ui \
     source/json_settings_dialog.ui \
-    source/vkid_table_widget_dialog.ui
+    source/vkid_table_widget_dialog.ui \
+    source/process_snapshot_dialog.ui
 
 LIBS += \
-    -lUser32
-
-RESOURCES += \
-    resources/resources.qrc
+    -lUser32 \
+    -lShell32 \
+    -lWtsapi32 \
+    -lPsapi
+
+# The default stylesheet is compiled into the binary when the indigo-stylesheet submodule is checked
+# out; it's used whenever styles/indigo.qss isn't present next to the executable.
+exists(submodules/indigo-stylesheet/indigo.qss) {
+    RESOURCES += resources/stylesheet.qrc
+}
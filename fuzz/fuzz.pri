@@ -0,0 +1,18 @@
+# Shared by every fuzz target. libFuzzer provides main, and AddressSanitizer turns memory errors into
+# crashes that the fuzzer can report; incremental linking isn't supported alongside it.
+QT -= gui
+QT += core
+
+TEMPLATE = app
+CONFIG  += console
+CONFIG  -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS CURSORLOCKER_NO_SOUND
+QMAKE_CXXFLAGS += /std:c++17 /O2 /Zi /fsanitize=address /fsanitize=fuzzer
+QMAKE_LFLAGS   += /INCREMENTAL:NO /DEBUG
+
+INCLUDEPATH += $$PWD/../source $$PWD
+
+HEADERS += $$PWD/fuzz_check.hpp
+
+LIBS += -lUser32
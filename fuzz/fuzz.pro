@@ -0,0 +1,14 @@
+# libFuzzer targets for the parsers that read untrusted text: the JSON settings, VKIDs, key sequences
+# and activation rules. They need MSVC 2019 16.9 or later for /fsanitize=fuzzer; see run_fuzzers.cmd.
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    settings \
+    vkid \
+    key_sequence \
+    activation_rule
+
+settings.file        = fuzz_settings.pro
+vkid.file            = fuzz_vkid.pro
+key_sequence.file    = fuzz_key_sequence.pro
+activation_rule.file = fuzz_activation_rule.pro
@@ -0,0 +1,123 @@
+#include "activation_rule.hpp"
+#include "fuzz_check.hpp"
+
+#include <QtCore/QSet>
+
+#include <array>
+#include <cstdint>
+
+namespace {
+    // Small pools, so that the operations hit the names the seed rules refer to rather than missing every predicate.
+    const std::array<QString, 4> imageNames    { "game.exe", "launcher.exe", "GAME.EXE", "" };
+    const std::array<QString, 4> windowTitles  { "Game", "Launcher", "game", "" };
+    const std::array<QString, 4> sourceNames   { "fullscreen", "overlay", "Fullscreen", "" };
+
+    struct Model {
+        QSet<QString>    RunningImages;
+        QString          ForegroundTitle;
+        QString          ForegroundImage;
+        QSet<QString>    ActiveSources;
+        bool             Suspended;
+    };
+
+    // Brings a freshly compiled rule up to date the way ActivationEngine::compileRule does.
+    bool evaluateFromScratch(const QString& expression, const Model& model) {
+        ActivationRule rule;
+        Fuzzing::Check(rule.Compile(expression), "a compiled rule's expression compiles again");
+
+        for(const QString& image_name : rule.GetImageNames()) {
+            rule.SetRunning(image_name, model.RunningImages.contains(image_name));
+        }
+
+        rule.SetForegroundTitle(QString {}, model.ForegroundTitle);
+        rule.SetForegroundImage(QString {}, model.ForegroundImage);
+
+        for(const QString& source_name : model.ActiveSources) {
+            rule.SetSourceActive(source_name, true);
+        }
+
+        rule.SetSuspended(model.Suspended);
+        return rule.GetValue();
+    }
+}
+
+/* The input is a rule expression, followed by a newline and a sequence of operations, one per byte.
+ * Each operation changes the world the rule observes through the same setters the activation engine
+ * uses, and the incrementally updated value has to match the value of the same rule compiled from
+ * scratch against the resulting world, which is what the incremental evaluation promises.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static constexpr size_t max_operations { 64 };    // Every operation recompiles the rule, so this bounds the time per input.
+
+    size_t expression_size { 0 };
+
+    while(expression_size < size && data[expression_size] != '\n') {
+        ++expression_size;
+    }
+
+    const QString& expression { QString::fromUtf8(reinterpret_cast<const char*>(data), static_cast<qsizetype>(expression_size)) };
+
+    ActivationRule rule;
+    QString compile_error;
+
+    if(!rule.Compile(expression, &compile_error)) {
+        Fuzzing::Check(!compile_error.isEmpty(), "a rejected rule comes with an error");
+        Fuzzing::Check(!rule.GetValue(), "a rejected rule never holds");
+        return 0;
+    }
+
+    Model model { {}, {}, {}, {}, false };
+    rule.SetSuspended(false);
+
+    Fuzzing::Check(rule.GetValue() == evaluateFromScratch(rule.GetExpression(), model), "a new rule matches its value from scratch");
+
+    for(size_t i { expression_size + 1 }; i < size && i <= expression_size + max_operations; ++i) {
+        const quint8& operation { static_cast<quint8>(data[i] % 5) };
+        const quint8& argument  { static_cast<quint8>((data[i] >> 3) & 0x3) };
+
+        switch(operation) {
+        case 0 : {
+            const QString& image_name { imageNames[argument] };
+            const bool running { !model.RunningImages.remove(image_name) };
+
+            if(running) {
+                model.RunningImages.insert(image_name);
+            }
+
+            rule.SetRunning(image_name, running);
+            break;
+        }
+
+        case 1 :
+            rule.SetForegroundTitle(model.ForegroundTitle, windowTitles[argument]);
+            model.ForegroundTitle = windowTitles[argument];
+            break;
+
+        case 2 :
+            rule.SetForegroundImage(model.ForegroundImage, imageNames[argument]);
+            model.ForegroundImage = imageNames[argument];
+            break;
+
+        case 3 : {
+            const QString& source_name { sourceNames[argument] };
+            const bool active { !model.ActiveSources.remove(source_name) };
+
+            if(active) {
+                model.ActiveSources.insert(source_name);
+            }
+
+            rule.SetSourceActive(source_name, active);
+            break;
+        }
+
+        default :
+            model.Suspended = !model.Suspended;
+            rule.SetSuspended(model.Suspended);
+            break;
+        }
+
+        Fuzzing::Check(rule.GetValue() == evaluateFromScratch(rule.GetExpression(), model), "an incrementally updated rule matches its value from scratch");
+    }
+
+    return 0;
+}
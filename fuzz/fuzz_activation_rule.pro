@@ -0,0 +1,12 @@
+include(fuzz.pri)
+
+TARGET = fuzz_activation_rule
+
+SOURCES += \
+    fuzz_activation_rule.cpp \
+    ../source/activation_rule.cpp \
+    ../source/metrics_registry.cpp
+
+HEADERS += \
+    ../source/activation_rule.hpp \
+    ../source/metrics_registry.hpp
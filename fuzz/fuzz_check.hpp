@@ -0,0 +1,17 @@
+#ifndef FUZZ_CHECK_HPP
+#define FUZZ_CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace Fuzzing {
+    // Aborts with the violated property, which libFuzzer reports as a crash along with the input that caused it.
+    inline void Check(bool condition, const char* property) {
+        if(!condition) {
+            fprintf(stderr, "Property violated: %s\n", property);
+            std::abort();
+        }
+    }
+}
+
+#endif // FUZZ_CHECK_HPP
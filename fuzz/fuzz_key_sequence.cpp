@@ -0,0 +1,41 @@
+#include "key_sequence_matcher.hpp"
+#include "fuzz_check.hpp"
+
+#include <cstdint>
+
+/* Feeds arbitrary UTF-8 to KeySequenceTrie::ParseSequence. A parsed sequence has to consist of valid
+ * chords, has to compile into a trie on its own, and pressing its chords in order has to walk that
+ * trie from the root to the bound action, completing it on the last chord and not before.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const QString& text { QString::fromUtf8(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size)) };
+    KeySequenceTrie::Sequence sequence;
+    QString parse_error;
+
+    if(!KeySequenceTrie::ParseSequence(text, sequence, &parse_error)) {
+        Fuzzing::Check(!parse_error.isEmpty(), "a rejected sequence comes with an error");
+        return 0;
+    }
+
+    Fuzzing::Check(!sequence.isEmpty() && sequence.size() <= KeySequenceTrie::MAX_SEQUENCE_LENGTH, "a parsed sequence has 1 - MAX_SEQUENCE_LENGTH chords");
+
+    for(const KeySequenceTrie::Chord& chord : sequence) {
+        Fuzzing::Check(chord.Modifiers <= 0xF && chord.Vkid >= 0x01 && chord.Vkid <= 0xFE, "a parsed chord has valid modifiers and a valid VKID");
+    }
+
+    KeySequenceTrie key_sequence_trie;
+    QString compile_error;
+
+    Fuzzing::Check(key_sequence_trie.Compile({ qMakePair(sequence, HOTKEY_ACTION::TOGGLE_MUTE) }, &compile_error), "a parsed sequence compiles on its own");
+
+    quint16 node { KeySequenceTrie::ROOT_NODE };
+
+    for(qsizetype i { 0 }; i < sequence.size(); ++i) {
+        node = key_sequence_trie.Step(node, sequence[i].Modifiers, sequence[i].Vkid);
+
+        Fuzzing::Check(node != KeySequenceTrie::NO_NODE, "every chord of a compiled sequence continues it");
+        Fuzzing::Check((key_sequence_trie.GetAcceptedAction(node) == HOTKEY_ACTION::TOGGLE_MUTE) == (i == sequence.size() - 1), "only the last chord completes the sequence");
+    }
+
+    return 0;
+}
@@ -0,0 +1,13 @@
+include(fuzz.pri)
+
+TARGET = fuzz_key_sequence
+
+SOURCES += \
+    fuzz_key_sequence.cpp \
+    ../source/key_sequence_matcher.cpp \
+    ../source/vkid_table.cpp
+
+HEADERS += \
+    ../source/key_sequence_matcher.hpp \
+    ../source/hotkey_registry.hpp \
+    ../source/vkid_table.hpp
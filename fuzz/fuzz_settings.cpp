@@ -0,0 +1,60 @@
+#include "json_settings_dialog.hxx"
+#include "fuzz_check.hpp"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <cstdint>
+
+namespace {
+    const QString& scratchPath(qsizetype index) {
+        static const QString scratch_paths[] {
+            QDir::tempPath() + "/cursor-locker-fuzz-" + QString::number(QCoreApplication::applicationPid()) + "-input.json",
+            QDir::tempPath() + "/cursor-locker-fuzz-" + QString::number(QCoreApplication::applicationPid()) + "-saved.json"
+        };
+
+        return scratch_paths[index];
+    }
+
+    QByteArray readFile(const QString& path) {
+        QFile file { path };
+        return file.open(QFile::ReadOnly) ? file.readAll() : QByteArray {};
+    }
+}
+
+/* Writes the input to a file and loads it through JsonSettings::LoadFromFile, without a calling widget,
+ * so that problems are collected rather than shown. Whatever it accepts is saved and loaded again, and
+ * the second save has to be identical to the first: a settings file the locker wrote itself has to
+ * load without losing or altering any value, however odd the file it was loaded from.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    QFile input_file { scratchPath(0) };
+
+    if(!input_file.open(QFile::WriteOnly | QFile::Truncate)) {
+        return 0;
+    }
+
+    input_file.write(reinterpret_cast<const char*>(data), static_cast<qint64>(size));
+    input_file.close();
+
+    JsonSettingsDialog::JsonSettings loaded_settings;
+    const qsizetype& bytes_read { loaded_settings.LoadFromFile(scratchPath(0)) };
+
+    // Text mode reads line endings as a single character, so an accepted file may come out shorter than it was written.
+    Fuzzing::Check((bytes_read > 0 && bytes_read <= static_cast<qsizetype>(size)) || bytes_read == -2 || bytes_read == -3, "LoadFromFile reads the file, or rejects it");
+
+    if(bytes_read < 0) {
+        return 0;
+    }
+
+    Fuzzing::Check(loaded_settings.SaveToFile(scratchPath(1)) > 0, "accepted settings can be saved");
+    const QByteArray& first_save { readFile(scratchPath(1)) };
+
+    JsonSettingsDialog::JsonSettings reloaded_settings;
+
+    Fuzzing::Check(reloaded_settings.LoadFromFile(scratchPath(1)) > 0, "saved settings load again");
+    Fuzzing::Check(reloaded_settings.SaveToFile(scratchPath(1)) > 0 && readFile(scratchPath(1)) == first_save, "saving loaded settings is a fixed point");
+
+    return 0;
+}
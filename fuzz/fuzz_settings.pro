@@ -0,0 +1,40 @@
+include(fuzz.pri)
+
+# JsonSettings lives in the settings dialog's translation unit, which brings in the widgets it shares
+# a file with, although the harness never constructs one.
+QT += gui widgets
+
+TARGET = fuzz_settings
+
+INCLUDEPATH += ../submodules/qt-hotkey-recorder-widget/
+
+SOURCES += \
+    fuzz_settings.cpp \
+    ../source/json_settings_dialog.cxx \
+    ../source/hotkey_registry.cpp \
+    ../source/low_level_keyboard_hook.cpp \
+    ../source/key_sequence_matcher.cpp \
+    ../source/vkid_table.cpp \
+    ../source/cursor_lock.cpp \
+    ../source/clip_geometry.cpp \
+    ../source/metrics_registry.cpp \
+    ../source/stylesheet_cache.cpp \
+    ../submodules/qt-hotkey-recorder-widget/hotkey_recorder_widget.cpp \
+    ../submodules/qt-hotkey-recorder-widget/keyboard_modifier_list_widget.cpp
+
+HEADERS += \
+    ../source/json_settings_dialog.hxx \
+    ../source/hotkey_registry.hpp \
+    ../source/low_level_keyboard_hook.hpp \
+    ../source/key_sequence_matcher.hpp \
+    ../source/vkid_table.hpp \
+    ../source/cursor_lock.hpp \
+    ../source/clip_geometry.hpp \
+    ../source/metrics_registry.hpp \
+    ../source/stylesheet_cache.hpp \
+    ../source/sound_mixer.hpp \
+    ../submodules/qt-hotkey-recorder-widget/hotkey_recorder_widget.hpp \
+    ../submodules/qt-hotkey-recorder-widget/keyboard_modifier_list_widget.hpp
+
+FORMS += \
+    ../source/json_settings_dialog.ui
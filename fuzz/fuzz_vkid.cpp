@@ -0,0 +1,35 @@
+#include "vkid_table.hpp"
+#include "fuzz_check.hpp"
+
+#include <QtCore/QString>
+
+#include <cstdint>
+
+/* Feeds arbitrary UTF-8 to VkidTable::ParseVkid. Whatever it accepts has to be within 0x01 - 0xFE, and
+ * has to parse back into the same VKID from its "0x??" string, as well as from its name if it has one,
+ * since that's how the settings file and the UI write VKIDs back out.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const QString& text { QString::fromUtf8(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size)) };
+    quint32 vkid { 0 };
+
+    if(!VkidTable::ParseVkid(text, vkid)) {
+        return 0;
+    }
+
+    Fuzzing::Check(vkid >= 0x01 && vkid <= 0xFE, "a parsed VKID is within 0x01 - 0xFE");
+
+    quint32 reparsed_vkid { 0 };
+
+    Fuzzing::Check(VkidTable::ParseVkid(QString::fromLatin1(VkidTable::ToHexString(vkid)), reparsed_vkid) && reparsed_vkid == vkid,
+                   "a VKID parses back from its hexadecimal string");
+
+    const VkidTable::Entry* entry { VkidTable::FromVkid(vkid) };
+
+    if(entry != nullptr) {
+        Fuzzing::Check(VkidTable::ParseVkid(QString::fromLatin1(entry->Name), reparsed_vkid) && reparsed_vkid == vkid,
+                       "a VKID parses back from its name");
+    }
+
+    return 0;
+}
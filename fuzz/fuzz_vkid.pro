@@ -0,0 +1,10 @@
+include(fuzz.pri)
+
+TARGET = fuzz_vkid
+
+SOURCES += \
+    fuzz_vkid.cpp \
+    ../source/vkid_table.cpp
+
+HEADERS += \
+    ../source/vkid_table.hpp
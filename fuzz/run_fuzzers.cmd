@@ -0,0 +1,32 @@
+@echo off
+rem Runs every fuzz target against its seed corpus for a bounded time, and stops at the first crash.
+rem Usage: run_fuzzers.cmd <directory with the fuzz_*.exe binaries> [seconds per target, 300 by default]
+rem
+rem New inputs that reach more code are added to corpus\<target>, next to the seeds; keep the ones
+rem worth sharing, and turn every crash-* file libFuzzer leaves behind into a fix plus a seed.
+
+setlocal
+
+if "%~1"=="" (
+    echo Usage: %~nx0 ^<directory with the fuzz_*.exe binaries^> [seconds per target]
+    exit /b 1
+)
+
+set BINARY_DIR=%~1
+set MAX_TOTAL_TIME=%~2
+if "%MAX_TOTAL_TIME%"=="" set MAX_TOTAL_TIME=300
+
+rem -max_len keeps inputs close to what each parser sees in practice; -timeout flags inputs that hang.
+call :run fuzz_settings        settings        65536 || exit /b 1
+call :run fuzz_vkid            vkid            64    || exit /b 1
+call :run fuzz_key_sequence    key_sequence    512   || exit /b 1
+call :run fuzz_activation_rule activation_rule 1024  || exit /b 1
+
+echo All fuzz targets ran for %MAX_TOTAL_TIME% s without a crash.
+exit /b 0
+
+:run
+echo.
+echo === %1
+"%BINARY_DIR%\%1.exe" "%~dp0corpus\%2" -max_len=%3 -max_total_time=%MAX_TOTAL_TIME% -timeout=10 -rss_limit_mb=2048 -print_final_stats=1
+exit /b %ERRORLEVEL%
@@ -0,0 +1,262 @@
+#include "activation_engine.hpp"
+
+#include <QtCore/QStringList>
+
+const QString ActivationEngine::FullscreenSourceName { "fullscreen" };
+
+void ActivationEngine::addProcess(quint64 pid, const QString& image_name) {
+    // A reused PID replaces the process it used to belong to.
+    removeProcess(pid);
+
+    runningProcesses.insert(pid, image_name);
+
+    if(++imageNameCounts[image_name] == 1) {
+        rule.SetRunning(image_name, true);
+    }
+}
+
+void ActivationEngine::removeProcess(quint64 pid) {
+    const auto& process { runningProcesses.constFind(pid) };
+
+    if(process == runningProcesses.constEnd()) {
+        return;
+    }
+
+    const auto& image_name_count { imageNameCounts.find(process.value()) };
+
+    if(image_name_count != imageNameCounts.end() && --image_name_count.value() == 0) {
+        rule.SetRunning(image_name_count.key(), false);
+        imageNameCounts.erase(image_name_count);
+    }
+
+    runningProcesses.erase(process);
+}
+
+ActivationEngine::Decision ActivationEngine::evaluate(const QString& target, bool target_present) {
+    if(target.isEmpty()) {
+        targetFound = false;
+        return { LOCK_ACTION::UNLOCK, TARGET_EDGE::NONE, false };
+    }
+
+    const TARGET_EDGE& edge {
+        target_present == targetFound ? TARGET_EDGE::NONE  :
+        target_present                ? TARGET_EDGE::FOUND :
+                                        TARGET_EDGE::LOST
+    };
+
+    targetFound = target_present;
+
+    return { target_present ? LOCK_ACTION::LOCK : LOCK_ACTION::UNLOCK, edge, !target_present };
+}
+
+void ActivationEngine::compileRule(const QString& expression) {
+    // An invalid rule is cleared, so that it never locks; the UI validates the expression before it gets this far.
+    if(!rule.Compile(expression)) {
+        rule.Clear();
+        return;
+    }
+
+    for(const QString& image_name : rule.GetImageNames()) {
+        rule.SetRunning(image_name, imageNameCounts.contains(image_name));
+    }
+
+    rule.SetForegroundTitle(QString {}, foregroundTitle);
+    rule.SetForegroundImage(QString {}, foregroundImage);
+
+    for(const QString& source_name : activeSources) {
+        rule.SetSourceActive(source_name, true);
+    }
+
+    rule.SetSuspended(ruleSuspended);
+}
+
+void ActivationEngine::setFullscreenExclusions(const QString& exclusion_list) {
+    fullscreenExclusions.clear();
+
+    for(const QString& image_name : exclusion_list.split(',', Qt::SkipEmptyParts)) {
+        const QString& trimmed_image_name { image_name.trimmed() };
+
+        if(!trimmed_image_name.isEmpty()) {
+            fullscreenExclusions.insert(trimmed_image_name.toLower());
+        }
+    }
+}
+
+ActivationEngine::Decision ActivationEngine::evaluateFullscreen() {
+    // evaluate() treats an empty target as no target at all, which the fullscreen method never lacks.
+    return evaluate(FullscreenSourceName, activeSources.contains(FullscreenSourceName) && !fullscreenExclusions.contains(foregroundImage.toLower()));
+}
+
+ActivationEngine::Decision ActivationEngine::Process(const ActivationEvent& event) {
+    clockUs = event.TimestampUs;
+
+    switch(event.Type) {
+    case ActivationEvent::TYPE::METHOD_CHANGED :
+        method = static_cast<ACTIVATION_METHOD>(event.Value);
+        targetFound = false;
+        ruleSuspended = false;
+        rule.SetSuspended(false);
+        break;
+
+    case ActivationEvent::TYPE::TARGET_CHANGED :
+        if(static_cast<ACTIVATION_METHOD>(event.Value) == ACTIVATION_METHOD::PROCESS_IMAGE) {
+            imageTarget = event.Text;
+        } else if(static_cast<ACTIVATION_METHOD>(event.Value) == ACTIVATION_METHOD::WINDOW_TITLE) {
+            titleTarget = event.Text;
+        } else if(static_cast<ACTIVATION_METHOD>(event.Value) == ACTIVATION_METHOD::RULE) {
+            compileRule(event.Text);
+
+            if(method == ACTIVATION_METHOD::RULE) {
+                return evaluate(rule.GetExpression(), rule.GetValue());
+            }
+        } else if(static_cast<ACTIVATION_METHOD>(event.Value) == ACTIVATION_METHOD::FULLSCREEN) {
+            setFullscreenExclusions(event.Text);
+
+            if(method == ACTIVATION_METHOD::FULLSCREEN) {
+                return evaluateFullscreen();
+            }
+        }
+        break;
+
+    case ActivationEvent::TYPE::PROCESS_STARTED :
+        addProcess(event.Value, event.Text);
+        break;
+
+    case ActivationEvent::TYPE::PROCESS_EXITED :
+        removeProcess(event.Value);
+        break;
+
+    case ActivationEvent::TYPE::PROCESS_SCAN_COMPLETED :
+        if(method == ACTIVATION_METHOD::PROCESS_IMAGE) {
+            return evaluate(imageTarget, foregroundImage == imageTarget);
+        }
+
+        if(method == ACTIVATION_METHOD::RULE) {
+            return evaluate(rule.GetExpression(), rule.GetValue());
+        }
+        break;
+
+    case ActivationEvent::TYPE::FOREGROUND_CHANGED :
+        rule.SetForegroundTitle(foregroundTitle, event.Text);
+        foregroundWindow = event.Value;
+        foregroundTitle = event.Text;
+
+        if(method == ACTIVATION_METHOD::RULE) {
+            return evaluate(rule.GetExpression(), rule.GetValue());
+        }
+
+        // Asks for the lock again, so that it moves over when focus passes from one fullscreen window to another.
+        if(method == ACTIVATION_METHOD::FULLSCREEN) {
+            return evaluateFullscreen();
+        }
+        break;
+
+    case ActivationEvent::TYPE::FOREGROUND_OWNER_CHANGED :
+        rule.SetForegroundImage(foregroundImage, event.Text);
+        foregroundImage = event.Text;
+
+        // Not gated on the process model, as the target can gain focus before the next scan reports it as running.
+        if(method == ACTIVATION_METHOD::PROCESS_IMAGE) {
+            return evaluate(imageTarget, foregroundImage == imageTarget);
+        }
+        break;    // The fullscreen method waits for the FOREGROUND_CHANGED that follows, as the window's SOURCE_CHANGED may come in between.
+
+    case ActivationEvent::TYPE::SOURCE_CHANGED :
+        if(event.Value) {
+            activeSources.insert(event.Text);
+        } else {
+            activeSources.remove(event.Text);
+        }
+
+        rule.SetSourceActive(event.Text, event.Value != 0);
+
+        if(method == ACTIVATION_METHOD::RULE) {
+            return evaluate(rule.GetExpression(), rule.GetValue());
+        }
+
+        if(method == ACTIVATION_METHOD::FULLSCREEN && event.Text == FullscreenSourceName) {
+            return evaluateFullscreen();
+        }
+        break;
+
+    case ActivationEvent::TYPE::TITLE_CHECK :
+        if(method == ACTIVATION_METHOD::WINDOW_TITLE) {
+            return evaluate(titleTarget, foregroundTitle == titleTarget);
+        }
+        break;
+
+    case ActivationEvent::TYPE::GEOMETRY_CHANGED :
+        break;    // The cursor lock follows geometry changes by itself; the fullscreen method gets a SOURCE_CHANGED if one matters to it.
+
+    case ActivationEvent::TYPE::HOTKEY :
+        if(method == ACTIVATION_METHOD::HOTKEY) {
+            return { LOCK_ACTION::TOGGLE, TARGET_EDGE::NONE, false };
+        }
+
+        if(method == ACTIVATION_METHOD::RULE) {
+            ruleSuspended = !ruleSuspended;
+            rule.SetSuspended(ruleSuspended);
+            return evaluate(rule.GetExpression(), rule.GetValue());
+        }
+        break;
+
+    case ActivationEvent::TYPE::LOCK_OVERRIDDEN :
+        return { event.Value ? LOCK_ACTION::LOCK : LOCK_ACTION::UNLOCK, TARGET_EDGE::NONE, false };
+    }
+
+    return { LOCK_ACTION::NONE, TARGET_EDGE::NONE, false };
+}
+
+void ActivationEngine::Reset() {
+    *this = ActivationEngine {};
+}
+
+ACTIVATION_METHOD ActivationEngine::GetMethod() const {
+    return method;
+}
+
+const QString& ActivationEngine::GetTarget() const {
+    static const QString no_target {};
+
+    switch(method) {
+    case ACTIVATION_METHOD::PROCESS_IMAGE : return imageTarget;
+    case ACTIVATION_METHOD::WINDOW_TITLE  : return titleTarget;
+    case ACTIVATION_METHOD::RULE          : return rule.GetExpression();
+    case ACTIVATION_METHOD::FULLSCREEN    : return foregroundImage;
+    case ACTIVATION_METHOD::HOTKEY        :
+    case ACTIVATION_METHOD::NOTHING       : break;
+    }
+
+    return no_target;
+}
+
+const QString& ActivationEngine::GetForegroundTitle() const {
+    return foregroundTitle;
+}
+
+const QString& ActivationEngine::GetForegroundImage() const {
+    return foregroundImage;
+}
+
+bool ActivationEngine::IsImageRunning(const QString& image_name) const {
+    return imageNameCounts.contains(image_name);
+}
+
+const QHash<quint64, QString>& ActivationEngine::GetRunningProcesses() const {
+    return runningProcesses;
+}
+
+qint64 ActivationEngine::GetClockUs() const {
+    return clockUs;
+}
+
+ActivationEngine::ActivationEngine()
+    :
+      method              { ACTIVATION_METHOD::NOTHING },
+      ruleSuspended       { false                      },
+      targetFound         { false                      },
+      foregroundWindow    { 0                          },
+      clockUs             { 0                          }
+{
+
+}
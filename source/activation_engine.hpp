@@ -0,0 +1,123 @@
+#ifndef ACTIVATION_ENGINE_HPP
+#define ACTIVATION_ENGINE_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+
+#include "activation_rule.hpp"
+
+enum struct ACTIVATION_METHOD : quint8 {
+    NOTHING         =   0b00000000,
+    HOTKEY          =   0b00000001,
+    PROCESS_IMAGE   =   0b00000010,
+    WINDOW_TITLE    =   0b00000100,
+    RULE            =   0b00001000,
+    FULLSCREEN      =   0b00010000,
+};
+
+// Everything the activation logic reacts to, in the form it's recorded and replayed in.
+struct ActivationEvent {
+    enum struct TYPE : quint8 {
+        METHOD_CHANGED           =   0x01,    // Value: ACTIVATION_METHOD
+        TARGET_CHANGED           =   0x02,    // Value: the ACTIVATION_METHOD the target belongs to, Text: the target; the exclusion list for FULLSCREEN.
+        PROCESS_STARTED          =   0x03,    // Value: PID, Text: image name.
+        PROCESS_EXITED           =   0x04,    // Value: PID
+        PROCESS_SCAN_COMPLETED   =   0x05,    // Every PROCESS_STARTED/EXITED of one snapshot precedes this.
+        FOREGROUND_CHANGED       =   0x06,    // Value: window handle, Text: window title; also sent when the title changes.
+        TITLE_CHECK              =   0x07,    // The window title method's periodic check.
+        GEOMETRY_CHANGED         =   0x08,    // Value: window handle
+        HOTKEY                   =   0x09,    // The activation method hotkey was pressed; suspends and resumes the rule method.
+        FOREGROUND_OWNER_CHANGED =   0x0A,    // Value: PID, Text: image name of the process owning the foreground window; precedes FOREGROUND_CHANGED.
+        SOURCE_CHANGED           =   0x0B,    // Value: 1 if the source became active, 0 if it became inactive, Text: the activation source's name.
+        LOCK_OVERRIDDEN          =   0x0C     // Value: 1 if the lock was enabled, 0 if it was released, by a force lock hotkey, the control socket or a launch option.
+    };
+
+    qint64     TimestampUs;
+    TYPE       Type;
+    quint64    Value;
+    QString    Text;
+};
+
+/* The decision logic of the activation methods, separated from the WinAPI and the UI, so that a
+ * recorded event stream can be replayed through the exact same code offline. It keeps its own model
+ * of the world (running processes, foreground window) that's built solely from the events it's fed,
+ * and its clock is the timestamp of the most recent event, so replays are deterministic no matter
+ * how fast they run. Decisions are level-triggered like the methods have always been, i.e. a check
+ * that finds the target asks for the lock again even if it's already enabled, so that the clip
+ * follows the foreground window; TARGET_EDGE reports the transitions that deserve a sound cue.
+ * The process image method only finds its target while the target owns the foreground window,
+ * as clipping to whatever else has focus is never what's wanted.
+ * The rule method's ActivationRule is kept up to date with every event, whichever method is
+ * selected, so that switching to it doesn't have to rebuild its state.
+ * The fullscreen method finds its target while the FullscreenSourceName source is active, i.e. the
+ * foreground window covers a whole monitor, unless the image owning it is on the exclusion list.
+ * LOCK_OVERRIDDEN reports a lock change that was made around the activation methods; it's decided
+ * as that change, which the caller has already made, so that a replay's lock follows it.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ActivationEngine {
+public:
+    static const QString FullscreenSourceName;    // The source the main window reports FullscreenDetector's state as; reserved for it.
+
+    enum struct LOCK_ACTION : quint8 {
+        NONE,
+        LOCK,
+        UNLOCK,
+        TOGGLE
+    };
+
+    enum struct TARGET_EDGE : quint8 {
+        NONE,
+        FOUND,
+        LOST
+    };
+
+    struct Decision {
+        LOCK_ACTION    Action;
+        TARGET_EDGE    Edge;
+        bool           Missed;    // A check ran with a target set, but didn't find it.
+    };
+
+protected:
+    ACTIVATION_METHOD           method;
+    QString                     imageTarget;
+    QString                     titleTarget;
+    ActivationRule              rule;
+    QSet<QString>               fullscreenExclusions;       // Lowercase image names, from a list such as "explorer.exe, vlc.exe".
+    bool                        ruleSuspended;       // Toggled by the hotkey while the rule method is selected; the rule's suspended predicate.
+    bool                        targetFound;
+
+    QHash<quint64, QString>     runningProcesses;    // PID -> image name
+    QHash<QString, quint32>     imageNameCounts;     // Image name -> number of running processes with that image.
+
+    quint64                     foregroundWindow;
+    QString                     foregroundTitle;
+    QString                     foregroundImage;     // The image name of the process owning the foreground window.
+
+    QSet<QString>               activeSources;       // Names of the activation source plugins that reported themselves active.
+
+    qint64                      clockUs;
+
+    void                        addProcess(quint64 pid, const QString& image_name);
+    void                        removeProcess(quint64 pid);
+    Decision                    evaluate(const QString& target, bool target_present);
+    void                        compileRule(const QString& expression);    // Also brings the new rule up to date with the model.
+    void                        setFullscreenExclusions(const QString& exclusion_list);
+    Decision                    evaluateFullscreen();
+
+public:
+    Decision                    Process(const ActivationEvent& event);
+    void                        Reset();
+
+    ACTIVATION_METHOD           GetMethod() const;
+    const QString&              GetTarget() const;    // The target of the current method; empty for the hotkey method, the expression for the rule method, the foreground image for the fullscreen method.
+    const QString&              GetForegroundTitle() const;
+    const QString&              GetForegroundImage() const;
+    bool                        IsImageRunning(const QString& image_name) const;
+    const QHash<quint64, QString>& GetRunningProcesses() const;
+    qint64                      GetClockUs() const;   // The timestamp of the most recent event, rather than the wall clock.
+
+    ActivationEngine();
+};
+
+#endif // ACTIVATION_ENGINE_HPP
@@ -0,0 +1,242 @@
+#include "activation_recording.hpp"
+
+#include <QtCore/QElapsedTimer>
+
+namespace {
+    constexpr quint8 HAS_VALUE_FLAG { 0b10000000 };
+    constexpr quint8 HAS_TEXT_FLAG  { 0b01000000 };
+    constexpr quint8 TYPE_MASK      { 0b00111111 };
+
+    void appendVarint(QByteArray& buffer, quint64 value) {
+        do {
+            const quint8& low_bits { static_cast<quint8>(value & 0x7F) };
+            value >>= 7;
+            buffer.append(static_cast<char>(value ? low_bits | 0x80 : low_bits));
+        } while(value);
+    }
+}
+
+bool ActivationRecorder::Open(const QString& path) {
+    Close();
+
+    recordingFile.setFileName(path);
+
+    if(!recordingFile.open(QFile::WriteOnly | QFile::Truncate)) {
+        return false;
+    }
+
+    buffer.append(ActivationRecording::Magic, sizeof(ActivationRecording::Magic));
+    buffer.append(static_cast<char>(ActivationRecording::Version));
+
+    hasRecordedEvent = false;
+    return true;
+}
+
+void ActivationRecorder::Close() {
+    if(recordingFile.isOpen()) {
+        Flush();
+        recordingFile.close();
+    }
+}
+
+bool ActivationRecorder::IsOpen() const {
+    return recordingFile.isOpen();
+}
+
+void ActivationRecorder::Record(const ActivationEvent& event) {
+    if(!recordingFile.isOpen()) {
+        return;
+    }
+
+    const QByteArray& text { event.Text.toUtf8() };
+    const qint64& delta_us { hasRecordedEvent ? qMax<qint64>(event.TimestampUs - previousTimestampUs, 0) : 0 };
+
+    quint8 type_byte { static_cast<quint8>(static_cast<quint8>(event.Type) & TYPE_MASK) };
+
+    if(event.Value) type_byte |= HAS_VALUE_FLAG;
+    if(!text.isEmpty()) type_byte |= HAS_TEXT_FLAG;
+
+    buffer.append(static_cast<char>(type_byte));
+    appendVarint(buffer, static_cast<quint64>(delta_us));
+
+    if(event.Value) {
+        appendVarint(buffer, event.Value);
+    }
+
+    if(!text.isEmpty()) {
+        appendVarint(buffer, static_cast<quint64>(text.size()));
+        buffer.append(text);
+    }
+
+    previousTimestampUs = event.TimestampUs;
+    hasRecordedEvent = true;
+
+    if(buffer.size() >= FlushThreshold) {
+        Flush();
+    }
+}
+
+void ActivationRecorder::Flush() {
+    if(recordingFile.isOpen() && !buffer.isEmpty()) {
+        recordingFile.write(buffer);
+        recordingFile.flush();
+        buffer.resize(0);    // Unlike clear, keeps the capacity, so that the buffer doesn't have to grow again.
+    }
+}
+
+ActivationRecorder::ActivationRecorder()
+    :
+      previousTimestampUs    { 0     },
+      hasRecordedEvent       { false }
+{
+
+}
+
+ActivationRecorder::~ActivationRecorder() {
+    Close();
+}
+
+
+
+bool ActivationReplay::readVarint(quint64& out_value) {
+    out_value = 0;
+
+    for(quint32 shift { 0 }; shift < 64; shift += 7) {
+        if(readOffset >= recording.size()) {
+            return false;
+        }
+
+        const quint8& byte { static_cast<quint8>(recording.at(readOffset++)) };
+        out_value |= static_cast<quint64>(byte & 0x7F) << shift;
+
+        if(!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;    // More than 10 bytes; not something the recorder produces.
+}
+
+bool ActivationReplay::Open(const QString& path, QString& out_error) {
+    QFile recording_file { path };
+
+    if(!recording_file.open(QFile::ReadOnly)) {
+        out_error = "Could not open the recording: " + recording_file.errorString();
+        return false;
+    }
+
+    recording = recording_file.readAll();
+    recording_file.close();
+
+    const qsizetype& header_size { sizeof(ActivationRecording::Magic) + 1 };
+
+    if(recording.size() < header_size || !recording.startsWith(QByteArray::fromRawData(ActivationRecording::Magic, sizeof(ActivationRecording::Magic)))) {
+        out_error = "Not an activation recording: " + path;
+        return false;
+    }
+
+    if(static_cast<quint8>(recording.at(sizeof(ActivationRecording::Magic))) != ActivationRecording::Version) {
+        out_error = "Unsupported activation recording version: " + QString::number(static_cast<quint8>(recording.at(sizeof(ActivationRecording::Magic))));
+        return false;
+    }
+
+    Rewind();
+    return true;
+}
+
+bool ActivationReplay::Next(ActivationEvent& out_event) {
+    if(readOffset >= recording.size()) {
+        return false;
+    }
+
+    const quint8& type_byte { static_cast<quint8>(recording.at(readOffset++)) };
+    quint64 delta_us { 0 }, value { 0 }, text_length { 0 };
+
+    if(!readVarint(delta_us)) {
+        return false;
+    }
+
+    if((type_byte & HAS_VALUE_FLAG) && !readVarint(value)) {
+        return false;
+    }
+
+    if(type_byte & HAS_TEXT_FLAG) {
+        if(!readVarint(text_length) || text_length > static_cast<quint64>(recording.size() - readOffset)) {
+            return false;
+        }
+    }
+
+    clockUs += static_cast<qint64>(delta_us);
+
+    out_event.TimestampUs = clockUs;
+    out_event.Type = static_cast<ActivationEvent::TYPE>(type_byte & TYPE_MASK);
+    out_event.Value = value;
+    out_event.Text = text_length ? QString::fromUtf8(recording.constData() + readOffset, static_cast<qsizetype>(text_length)) : QString {};
+
+    readOffset += static_cast<qsizetype>(text_length);
+    return true;
+}
+
+void ActivationReplay::Rewind() {
+    readOffset = sizeof(ActivationRecording::Magic) + 1;
+    clockUs = 0;
+}
+
+ActivationReplay::Summary ActivationReplay::Run(ActivationEngine& engine, quint32 passes, const TransitionCallback& transition_callback) {
+    Summary summary { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    QElapsedTimer replay_timer;
+    replay_timer.start();
+
+    ActivationEvent event { 0, ActivationEvent::TYPE::METHOD_CHANGED, 0, QString {} };
+
+    for(quint32 pass { 0 }; pass < passes; ++pass) {
+        bool lock_state { false };
+
+        Rewind();
+        engine.Reset();
+
+        while(Next(event)) {
+            const ActivationEngine::Decision& decision { engine.Process(event) };
+            const bool previous_lock_state { lock_state };
+
+            ++summary.EventCount;
+
+            switch(decision.Action) {
+            case ActivationEngine::LOCK_ACTION::LOCK   : ++summary.LockActions;   lock_state = true;        break;
+            case ActivationEngine::LOCK_ACTION::UNLOCK : ++summary.UnlockActions; lock_state = false;       break;
+            case ActivationEngine::LOCK_ACTION::TOGGLE : ++summary.ToggleActions; lock_state = !lock_state; break;
+            case ActivationEngine::LOCK_ACTION::NONE   :                                                    break;
+            }
+
+            // Changing the method always releases the lock.
+            if(event.Type == ActivationEvent::TYPE::METHOD_CHANGED) {
+                lock_state = false;
+            }
+
+            if(decision.Edge == ActivationEngine::TARGET_EDGE::FOUND) ++summary.TargetsFound;
+            if(decision.Edge == ActivationEngine::TARGET_EDGE::LOST)  ++summary.TargetsLost;
+
+            if(lock_state != previous_lock_state) {
+                ++summary.LockTransitions;
+
+                if(pass == 0 && transition_callback) {
+                    transition_callback(event, lock_state);
+                }
+            }
+        }
+
+        summary.RecordedSpanUs = clockUs;
+    }
+
+    summary.ElapsedNs = replay_timer.nsecsElapsed();
+    return summary;
+}
+
+ActivationReplay::ActivationReplay()
+    :
+      readOffset    { 0 },
+      clockUs       { 0 }
+{
+
+}
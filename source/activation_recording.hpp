@@ -0,0 +1,87 @@
+#ifndef ACTIVATION_RECORDING_HPP
+#define ACTIVATION_RECORDING_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+
+#include <functional>
+
+#include "activation_engine.hpp"
+
+/* Activation recordings are a 4 byte magic and a version byte, followed by one record per event:
+ *
+ *     u8      type, with bit 7 set if a value follows, and bit 6 set if text follows
+ *     varint  microseconds since the previous event (the first event is at 0)
+ *     varint  value                                       (if bit 7 is set)
+ *     varint  length, followed by that many bytes of UTF-8 (if bit 6 is set)
+ *
+ * Varints are LEB128, so a typical event takes 2-3 bytes plus its text, and a recording covering
+ * hours of play stays small enough to attach to a bug report.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+namespace ActivationRecording {
+    inline constexpr char     Magic[4] { 'C', 'L', 'A', 'R' };
+    inline constexpr quint8   Version  { 1 };
+}
+
+// Appends events to a recording as they're dispatched; buffered, so recording costs no system calls per event.
+class ActivationRecorder {
+protected:
+    QFile         recordingFile;
+    QByteArray    buffer;
+    qint64        previousTimestampUs;
+    bool          hasRecordedEvent;
+
+    static constexpr qsizetype FlushThreshold { 64 * 1024 };
+
+public:
+    bool          Open(const QString& path);
+    void          Close();
+    bool          IsOpen() const;
+
+    void          Record(const ActivationEvent& event);
+    void          Flush();
+
+    ActivationRecorder();
+    ~ActivationRecorder();
+};
+
+/* Feeds a recording through an ActivationEngine as fast as possible. The engine's clock is driven by
+ * the recorded timestamps, so the outcome is identical to the live run no matter how long it takes,
+ * and the same recording can be repeated to push millions of events through the decision path.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ActivationReplay {
+public:
+    struct Summary {
+        quint64    EventCount;
+        quint64    LockActions;
+        quint64    UnlockActions;
+        quint64    ToggleActions;
+        quint64    LockTransitions;     // Times the simulated lock actually changed state.
+        quint64    TargetsFound;
+        quint64    TargetsLost;
+        qint64     RecordedSpanUs;      // Virtual time covered by one pass over the recording.
+        qint64     ElapsedNs;           // Wall clock time spent replaying, over every pass.
+    };
+
+    // Called for every decision that changes the simulated lock state, on the first pass only.
+    typedef std::function<void(const ActivationEvent& event, bool lock_state)> TransitionCallback;
+
+protected:
+    QByteArray    recording;
+    qsizetype     readOffset;
+    qint64        clockUs;
+
+    bool          readVarint(quint64& out_value);
+
+public:
+    bool          Open(const QString& path, QString& out_error);
+    bool          Next(ActivationEvent& out_event);    // Returns false at the end of the recording, or if the rest of it is truncated.
+    void          Rewind();
+
+    Summary       Run(ActivationEngine& engine, quint32 passes = 1, const TransitionCallback& transition_callback = nullptr);
+
+    ActivationReplay();
+};
+
+#endif // ACTIVATION_RECORDING_HPP
@@ -0,0 +1,397 @@
+#include "activation_rule.hpp"
+#include "metrics_registry.hpp"
+
+#include <functional>
+
+namespace {
+    MetricsRegistry::Counter& ruleUpdatesMetric      { MetricsRegistry::Instance().RegisterCounter("cursorlocker_rule_updates_total", {}, "Number of rule predicate updates that touched at least one predicate.") };
+    MetricsRegistry::Counter& ruleNodeUpdatesMetric  { MetricsRegistry::Instance().RegisterCounter("cursorlocker_rule_node_updates_total", {}, "Number of rule nodes re-evaluated by those updates; the ratio of the two is the cost of an update.") };
+
+    enum struct TOKEN_TYPE : quint8 {
+        IDENTIFIER,
+        STRING,
+        OPEN_PARENTHESIS,
+        CLOSE_PARENTHESIS,
+        NOT,
+        AND,
+        OR,
+        END
+    };
+
+    struct Token {
+        TOKEN_TYPE    Type;
+        QString       Text;
+        qsizetype     Offset;
+    };
+
+    bool tokenize(const QString& expression, QVector<Token>& out_tokens, QString& out_error) {
+        qsizetype offset { 0 };
+
+        while(offset < expression.size()) {
+            const QChar& character { expression.at(offset) };
+
+            if(character.isSpace()) {
+                ++offset;
+            } else if(character == '(' || character == ')') {
+                out_tokens.append({ character == '(' ? TOKEN_TYPE::OPEN_PARENTHESIS : TOKEN_TYPE::CLOSE_PARENTHESIS, QString { character }, offset++ });
+            } else if(character == '!') {
+                out_tokens.append({ TOKEN_TYPE::NOT, "!", offset++ });
+            } else if(expression.mid(offset, 2) == "&&" || expression.mid(offset, 2) == "||") {
+                out_tokens.append({ character == '&' ? TOKEN_TYPE::AND : TOKEN_TYPE::OR, expression.mid(offset, 2), offset });
+                offset += 2;
+            } else if(character == '"') {
+                const qsizetype start_offset { offset++ };
+                QString text;
+
+                while(offset < expression.size() && expression.at(offset) != '"') {
+                    // A backslash escapes the next character, so that titles may contain quotes.
+                    if(expression.at(offset) == '\\' && offset + 1 < expression.size()) {
+                        ++offset;
+                    }
+
+                    text.append(expression.at(offset++));
+                }
+
+                if(offset >= expression.size()) {
+                    out_error = QString { "Unterminated string starting at offset %1." }.arg(start_offset);
+                    return false;
+                }
+
+                ++offset;
+                out_tokens.append({ TOKEN_TYPE::STRING, text, start_offset });
+            } else if(character.isLetter() || character == '_') {
+                const qsizetype start_offset { offset };
+
+                while(offset < expression.size() && (expression.at(offset).isLetterOrNumber() || expression.at(offset) == '_')) {
+                    ++offset;
+                }
+
+                const QString& word { expression.mid(start_offset, offset - start_offset).toLower() };
+
+                const TOKEN_TYPE& type {
+                    word == "not" ? TOKEN_TYPE::NOT :
+                    word == "and" ? TOKEN_TYPE::AND :
+                    word == "or"  ? TOKEN_TYPE::OR  :
+                                    TOKEN_TYPE::IDENTIFIER
+                };
+
+                out_tokens.append({ type, word, start_offset });
+            } else {
+                out_error = QString { "Unexpected character '%1' at offset %2." }.arg(character).arg(offset);
+                return false;
+            }
+        }
+
+        out_tokens.append({ TOKEN_TYPE::END, QString {}, expression.size() });
+        return true;
+    }
+}
+
+void ActivationRule::setLeaves(const QVector<quint16>& leaves, bool value) {
+    if(leaves.isEmpty()) {
+        return;
+    }
+
+    const auto& evaluate {
+        [](const Node& node) -> bool {
+            switch(node.Type) {
+            case NODE_TYPE::NOT : return node.TrueChildren == 0;
+            case NODE_TYPE::AND : return node.TrueChildren == node.ChildCount;
+            case NODE_TYPE::OR  : return node.TrueChildren > 0;
+            case NODE_TYPE::PREDICATE : break;
+            }
+
+            return node.Value;
+        }
+    };
+
+    quint64 node_updates { 0 };
+
+    for(quint16 index : leaves) {
+        if(nodes[index].Value == value) {
+            continue;
+        }
+
+        nodes[index].Value = value;
+        ++node_updates;
+
+        // Walks up only while values change; a parent whose value holds shields the rest of the tree.
+        while(nodes[index].Parent != NO_NODE) {
+            const bool child_value { nodes[index].Value };
+            Node& parent { nodes[nodes[index].Parent] };
+
+            child_value ? ++parent.TrueChildren : --parent.TrueChildren;
+            ++node_updates;
+
+            const bool parent_value { evaluate(parent) };
+
+            if(parent_value == parent.Value) {
+                break;
+            }
+
+            parent.Value = parent_value;
+            index = nodes[index].Parent;
+        }
+    }
+
+    ruleUpdatesMetric.Increment();
+    ruleNodeUpdatesMetric.Increment(node_updates);
+}
+
+void ActivationRule::moveTrueLeaves(const QHash<QString, QVector<quint16>>& leaves, const QString& previous_key, const QString& key) {
+    const auto& previous_key_leaves { leaves.constFind(previous_key) };
+    const auto& key_leaves          { leaves.constFind(key)          };
+
+    if(previous_key_leaves != leaves.constEnd()) {
+        setLeaves(previous_key_leaves.value(), false);
+    }
+
+    if(key_leaves != leaves.constEnd()) {
+        setLeaves(key_leaves.value(), true);
+    }
+}
+
+bool ActivationRule::Compile(const QString& rule_expression, QString* out_error) {
+    Clear();
+
+    QString error;
+    QVector<Token> tokens;
+
+    const auto& fail {
+        [&](const QString& reason) -> bool {
+            Clear();
+            if(out_error != nullptr) *out_error = reason;
+            return false;
+        }
+    };
+
+    if(!tokenize(rule_expression, tokens, error)) {
+        return fail(error);
+    }
+
+    qsizetype position { 0 };
+
+    const auto& add_node {
+        [&](NODE_TYPE type, const QVector<quint16>& children) -> quint16 {
+            if(nodes.size() >= MAX_NODES) {
+                error = QString { "The rule has more than %1 terms." }.arg(MAX_NODES);
+                return NO_NODE;
+            }
+
+            const quint16 index { static_cast<quint16>(nodes.size()) };
+            nodes.append({ type, NO_NODE, static_cast<quint16>(children.size()), 0, false });
+
+            for(quint16 child : children) {
+                nodes[child].Parent = index;
+            }
+
+            return index;
+        }
+    };
+
+    // Recursive descent over: or := and ("or" and)*, and := unary ("and" unary)*, unary := "not" unary | "(" or ")" | predicate.
+    std::function<quint16(qsizetype)> parse_or;
+    std::function<quint16(qsizetype)> parse_and;
+    std::function<quint16(qsizetype)> parse_unary;
+
+    parse_unary = [&](qsizetype depth) -> quint16 {
+        if(depth > MAX_DEPTH) {
+            error = QString { "The rule is nested more than %1 levels deep." }.arg(MAX_DEPTH);
+            return NO_NODE;
+        }
+
+        const Token& token { tokens.at(position++) };
+
+        if(token.Type == TOKEN_TYPE::NOT) {
+            const quint16 operand { parse_unary(depth + 1) };
+            return operand == NO_NODE ? NO_NODE : add_node(NODE_TYPE::NOT, { operand });
+        }
+
+        if(token.Type == TOKEN_TYPE::OPEN_PARENTHESIS) {
+            const quint16 operand { parse_or(depth + 1) };
+
+            if(operand == NO_NODE) {
+                return NO_NODE;
+            }
+
+            if(tokens.at(position).Type != TOKEN_TYPE::CLOSE_PARENTHESIS) {
+                error = QString { "Expected ')' at offset %1." }.arg(tokens.at(position).Offset);
+                return NO_NODE;
+            }
+
+            ++position;
+            return operand;
+        }
+
+        if(token.Type != TOKEN_TYPE::IDENTIFIER) {
+            error = QString { "Expected a predicate at offset %1." }.arg(token.Offset);
+            return NO_NODE;
+        }
+
+        if(token.Text == "suspended") {
+            // The parentheses are optional, as the predicate takes no argument.
+            if(tokens.at(position).Type == TOKEN_TYPE::OPEN_PARENTHESIS && tokens.at(position + 1).Type == TOKEN_TYPE::CLOSE_PARENTHESIS) {
+                position += 2;
+            }
+
+            const quint16 leaf { add_node(NODE_TYPE::PREDICATE, {}) };
+
+            if(leaf != NO_NODE) {
+                suspendedLeaves.append(leaf);
+            }
+
+            return leaf;
+        }
+
+        QHash<QString, QVector<quint16>>* leaves {
+            token.Text == "running"    ? &runningLeaves    :
+            token.Text == "title"      ? &titleLeaves      :
+            token.Text == "foreground" ? &foregroundLeaves :
+            token.Text == "source"     ? &sourceLeaves     :
+                                         nullptr
+        };
+
+        if(leaves == nullptr) {
+            error = QString { "Unknown predicate \"%1\" at offset %2; expected running, title, foreground, source or suspended." }.arg(token.Text).arg(token.Offset);
+            return NO_NODE;
+        }
+
+        if(tokens.at(position).Type != TOKEN_TYPE::OPEN_PARENTHESIS
+                || tokens.at(position + 1).Type != TOKEN_TYPE::STRING
+                || tokens.at(position + 2).Type != TOKEN_TYPE::CLOSE_PARENTHESIS) {
+            error = QString { "Expected %1(\"...\") at offset %2." }.arg(token.Text).arg(token.Offset);
+            return NO_NODE;
+        }
+
+        const QString& argument { tokens.at(position + 1).Text };
+        position += 3;
+
+        const quint16 leaf { add_node(NODE_TYPE::PREDICATE, {}) };
+
+        if(leaf != NO_NODE) {
+            (*leaves)[argument].append(leaf);
+        }
+
+        return leaf;
+    };
+
+    // Consecutive operands of the same operator become the children of a single node.
+    const auto& parse_chain {
+        [&](TOKEN_TYPE separator, NODE_TYPE type, const std::function<quint16(qsizetype)>& parse_operand, qsizetype depth) -> quint16 {
+            QVector<quint16> operands;
+
+            for(;;) {
+                const quint16 operand { parse_operand(depth) };
+
+                if(operand == NO_NODE) {
+                    return NO_NODE;
+                }
+
+                operands.append(operand);
+
+                if(tokens.at(position).Type != separator) {
+                    break;
+                }
+
+                ++position;
+            }
+
+            return operands.size() == 1 ? operands.first() : add_node(type, operands);
+        }
+    };
+
+    parse_and = [&](qsizetype depth) -> quint16 {
+        return parse_chain(TOKEN_TYPE::AND, NODE_TYPE::AND, parse_unary, depth);
+    };
+
+    parse_or = [&](qsizetype depth) -> quint16 {
+        return parse_chain(TOKEN_TYPE::OR, NODE_TYPE::OR, parse_and, depth);
+    };
+
+    if(tokens.size() == 1) {
+        return fail("The rule is empty.");
+    }
+
+    if(parse_or(0) == NO_NODE) {
+        return fail(error);
+    }
+
+    if(tokens.at(position).Type != TOKEN_TYPE::END) {
+        return fail(QString { "Unexpected \"%1\" at offset %2." }.arg(tokens.at(position).Text).arg(tokens.at(position).Offset));
+    }
+
+    // Children precede their parents, so one pass in order settles every value with all predicates false.
+    for(Node& node : nodes) {
+        switch(node.Type) {
+        case NODE_TYPE::PREDICATE : node.Value = false;                                break;
+        case NODE_TYPE::NOT       : node.Value = node.TrueChildren == 0;               break;
+        case NODE_TYPE::AND       : node.Value = node.TrueChildren == node.ChildCount; break;
+        case NODE_TYPE::OR        : node.Value = node.TrueChildren > 0;                break;
+        }
+
+        if(node.Value && node.Parent != NO_NODE) {
+            ++nodes[node.Parent].TrueChildren;
+        }
+    }
+
+    expression = rule_expression;
+    return true;
+}
+
+void ActivationRule::Clear() {
+    expression.clear();
+    nodes.clear();
+    runningLeaves.clear();
+    titleLeaves.clear();
+    foregroundLeaves.clear();
+    sourceLeaves.clear();
+    suspendedLeaves.clear();
+}
+
+bool ActivationRule::IsEmpty() const {
+    return nodes.isEmpty();
+}
+
+bool ActivationRule::GetValue() const {
+    return !nodes.isEmpty() && nodes.last().Value;
+}
+
+const QString& ActivationRule::GetExpression() const {
+    return expression;
+}
+
+QList<QString> ActivationRule::GetImageNames() const {
+    return runningLeaves.keys();
+}
+
+void ActivationRule::SetRunning(const QString& image_name, bool running) {
+    const auto& leaves { runningLeaves.constFind(image_name) };
+
+    if(leaves != runningLeaves.constEnd()) {
+        setLeaves(leaves.value(), running);
+    }
+}
+
+void ActivationRule::SetForegroundTitle(const QString& previous_title, const QString& title) {
+    moveTrueLeaves(titleLeaves, previous_title, title);
+}
+
+void ActivationRule::SetForegroundImage(const QString& previous_image_name, const QString& image_name) {
+    moveTrueLeaves(foregroundLeaves, previous_image_name, image_name);
+}
+
+void ActivationRule::SetSourceActive(const QString& source_name, bool active) {
+    const auto& leaves { sourceLeaves.constFind(source_name) };
+
+    if(leaves != sourceLeaves.constEnd()) {
+        setLeaves(leaves.value(), active);
+    }
+}
+
+void ActivationRule::SetSuspended(bool suspended) {
+    setLeaves(suspendedLeaves, suspended);
+}
+
+ActivationRule::ActivationRule() {
+
+}
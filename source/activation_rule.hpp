@@ -0,0 +1,74 @@
+#ifndef ACTIVATION_RULE_HPP
+#define ACTIVATION_RULE_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+/* A boolean expression over the conditions the other activation methods check one at a time, e.g.
+ *
+ *     running("SkyrimSE.exe") and title("Skyrim Special Edition") and not suspended
+ *
+ * Predicates are running("<image>"), title("<title>"), foreground("<image>"), which holds while the
+ * image owns the foreground window, source("<name>"), which holds while the activation source plugin
+ * of that name reports itself active (source("fullscreen") is built in), and suspended. They're
+ * combined with and/&&, or/||, not/! and parentheses. The expression is compiled into a flat node array whose values are kept up to date
+ * incrementally: an update only touches the predicates keyed by its argument, and walks up from
+ * each one only for as long as values keep changing. AND and OR nodes count their true children,
+ * so re-evaluating one costs the same however many operands it has. The cost of an event is
+ * therefore independent of the size of the rule, other than its depth.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ActivationRule {
+public:
+    static constexpr quint16     NO_NODE      { 0xFFFF };
+    static constexpr qsizetype   MAX_NODES    { 256 };    // Far beyond any rule written by hand; bounds compile time and memory.
+    static constexpr qsizetype   MAX_DEPTH    { 32 };     // Bounds the recursion of the parser on inputs such as "((((...".
+
+protected:
+    enum struct NODE_TYPE : quint8 {
+        PREDICATE,
+        NOT,
+        AND,
+        OR
+    };
+
+    struct Node {
+        NODE_TYPE    Type;
+        quint16      Parent;          // NO_NODE for the root.
+        quint16      ChildCount;
+        quint16      TrueChildren;    // The number of children whose value is true.
+        bool         Value;
+    };
+
+    QString                              expression;
+    QVector<Node>                        nodes;             // Children always precede their parents, so the root is the last node.
+
+    QHash<QString, QVector<quint16>>     runningLeaves;     // Image name -> running() predicates.
+    QHash<QString, QVector<quint16>>     titleLeaves;       // Window title -> title() predicates.
+    QHash<QString, QVector<quint16>>     foregroundLeaves;  // Image name -> foreground() predicates.
+    QHash<QString, QVector<quint16>>     sourceLeaves;      // Activation source name -> source() predicates.
+    QVector<quint16>                     suspendedLeaves;
+
+    void                                 setLeaves(const QVector<quint16>& leaves, bool value);
+    void                                 moveTrueLeaves(const QHash<QString, QVector<quint16>>& leaves, const QString& previous_key, const QString& key);
+
+public:
+    // Replaces the rule. Every predicate starts out false; the caller brings the rule up to date through the setters.
+    bool                 Compile(const QString& rule_expression, QString* out_error = nullptr);
+    void                 Clear();
+
+    bool                 IsEmpty() const;
+    bool                 GetValue() const;    // False for an empty rule.
+    const QString&       GetExpression() const;
+    QList<QString>       GetImageNames() const;    // Every image name referenced by a running() predicate.
+
+    void                 SetRunning(const QString& image_name, bool running);
+    void                 SetForegroundTitle(const QString& previous_title, const QString& title);
+    void                 SetForegroundImage(const QString& previous_image_name, const QString& image_name);
+    void                 SetSourceActive(const QString& source_name, bool active);
+    void                 SetSuspended(bool suspended);
+
+    ActivationRule();
+};
+
+#endif // ACTIVATION_RULE_HPP
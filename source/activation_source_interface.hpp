@@ -0,0 +1,47 @@
+#ifndef ACTIVATION_SOURCE_INTERFACE_HPP
+#define ACTIVATION_SOURCE_INTERFACE_HPP
+
+#include <QtCore/QtPlugin>
+#include <QtCore/QString>
+
+/* Handed to an activation source when it's started; the source reports its state through it.
+ * SetActive may be called from any thread, as often as the source likes, since calls that
+ * don't change the state are dropped before they reach the activation engine.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ActivationSourceSink {
+public:
+    virtual void SetActive(bool active) = 0;
+
+protected:
+    ~ActivationSourceSink() = default;
+};
+
+/* The interface activation source plugins implement, next to QObject, e.g.
+ *
+ *     class FullscreenSource : public QObject, public ActivationSourceInterface {
+ *         Q_OBJECT
+ *         Q_PLUGIN_METADATA(IID ActivationSourceInterface_iid)
+ *         Q_INTERFACES(ActivationSourceInterface)
+ *         ...
+ *     };
+ *
+ * Plugins are loaded from the plugins directory next to the executable, and each one gets a thread
+ * of its own: Start and Stop are called on it, and the plugin object lives on it in between, so
+ * timers it creates in Start fire there and never hold up the GUI thread. A source is referenced in
+ * rules as source("<name>"), and its state is fed through the activation engine like any other event,
+ * so it's recorded and replayed along with everything else.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ActivationSourceInterface {
+public:
+    virtual QString    GetName() const = 0;    // Lowercase letters, digits, '_', '-' and '.'; must be unique among the loaded plugins.
+
+    virtual bool       Start(ActivationSourceSink* sink) = 0;    // The sink stays valid until Stop returns.
+    virtual void       Stop() = 0;                               // Must not call the sink after returning; the GUI thread waits for it.
+
+    virtual ~ActivationSourceInterface() = default;
+};
+
+#define ActivationSourceInterface_iid "CursorLocker.ActivationSourceInterface/1.0"
+Q_DECLARE_INTERFACE(ActivationSourceInterface, ActivationSourceInterface_iid)
+
+#endif // ACTIVATION_SOURCE_INTERFACE_HPP
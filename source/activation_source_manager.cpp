@@ -0,0 +1,262 @@
+#include "activation_source_manager.hpp"
+#include "activation_engine.hpp"
+#include "metrics_registry.hpp"
+
+#include <QtCore/QDir>
+#include <QtCore/QThread>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QtDebug>
+
+#include <atomic>
+
+/* One loaded plugin, along with the thread it runs on. The sink the plugin reports through is the
+ * Source itself; reports are deduplicated with a single atomic exchange on the plugin's thread,
+ * and only actual state changes are queued over to the GUI thread.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ActivationSourceManager::Source : public ActivationSourceSink {
+protected:
+    ActivationSourceManager&       manager;
+    QPluginLoader                  loader;
+    QThread                        thread;
+    ActivationSourceInterface*     plugin;
+    QString                        name;
+
+    std::atomic<HANDLE>            threadHandle;          // Opened on the plugin's thread, as QThread doesn't expose its handle.
+    std::atomic<qint32>            reportedState;         // 1 if active, 0 if inactive, -1 before the first report.
+    quint64                        accountedCpuTimeUs;    // The CPU time of the thread already added to cpuTimeMetric.
+
+    MetricsRegistry::Counter*      stateChangesMetric;
+    MetricsRegistry::Counter*      cpuTimeMetric;
+    MetricsRegistry::Gauge*        activeMetric;
+
+public:
+    virtual void      SetActive(bool active) override;
+
+    bool              Load(QString& out_error);
+    void              Start();
+    void              Stop();
+    void              AccountCpuTime();
+
+    const QString&    GetName() const;
+
+    Source(ActivationSourceManager& source_manager, const QString& file_path);
+    ~Source();
+};
+
+void ActivationSourceManager::Source::SetActive(bool active) {
+    if(reportedState.exchange(active ? 1 : 0) == (active ? 1 : 0)) {
+        return;
+    }
+
+    stateChangesMetric->Increment();
+    activeMetric->Set(active ? 1 : 0);
+
+    QMetaObject::invokeMethod(&manager, [source_manager = &manager, source_name = name, active]() -> void {
+        emit source_manager->SourceStateChanged(source_name, active);
+    }, Qt::QueuedConnection);
+}
+
+bool ActivationSourceManager::Source::Load(QString& out_error) {
+    static const QRegularExpression name_expression { "^[a-z0-9_.-]+$" };
+
+    QObject* const instance { loader.instance() };
+
+    if(instance == nullptr) {
+        out_error = loader.errorString();
+        return false;
+    }
+
+    plugin = qobject_cast<ActivationSourceInterface*>(instance);
+
+    if(plugin == nullptr) {
+        out_error = "The plugin doesn't implement " ActivationSourceInterface_iid;
+        loader.unload();
+        return false;
+    }
+
+    name = plugin->GetName();
+
+    if(!name_expression.match(name).hasMatch()) {
+        out_error = QString { "The plugin's name \"%1\" may only contain lowercase letters, digits, '_', '-' and '.'" }.arg(name);
+        plugin = nullptr;
+        loader.unload();
+        return false;
+    }
+
+    if(name == ActivationEngine::FullscreenSourceName) {
+        out_error = QString { "The name \"%1\" is reserved for the built-in fullscreen detection" }.arg(name);
+        plugin = nullptr;
+        loader.unload();
+        return false;
+    }
+
+    return true;
+}
+
+void ActivationSourceManager::Source::Start() {
+    const QString& labels { "plugin=\"" + name + "\"" };
+
+    stateChangesMetric = &MetricsRegistry::Instance().RegisterCounter("cursorlocker_activation_source_state_changes_total", labels, "Number of state changes reported by an activation source plugin.");
+    cpuTimeMetric      = &MetricsRegistry::Instance().RegisterCounter("cursorlocker_activation_source_cpu_seconds_total", labels, "CPU time used by the thread of an activation source plugin.", 1e-6);
+    activeMetric       = &MetricsRegistry::Instance().RegisterGauge("cursorlocker_activation_source_active", labels, "Whether an activation source plugin reports itself active.");
+
+    thread.setObjectName("ActivationSource:" + name);
+    loader.instance()->moveToThread(&thread);
+    thread.start();
+
+    QMetaObject::invokeMethod(loader.instance(), [this]() -> void {
+        threadHandle = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, GetCurrentThreadId());
+
+        if(!plugin->Start(this)) {
+            qWarning() << "Activation source" << name << "failed to start.";
+        }
+    }, Qt::QueuedConnection);
+
+    qInfo() << "Started activation source" << name << "from" << loader.fileName();
+}
+
+void ActivationSourceManager::Source::Stop() {
+    if(!thread.isRunning()) {
+        return;
+    }
+
+    QObject* const instance { loader.instance() };
+    QThread* const gui_thread { manager.thread() };
+
+    // The plugin object is handed back to the GUI thread before its own thread ends, so that unloading it can delete it safely.
+    QMetaObject::invokeMethod(instance, [this, instance, gui_thread]() -> void {
+        plugin->Stop();
+        instance->moveToThread(gui_thread);
+    }, Qt::BlockingQueuedConnection);
+
+    thread.quit();
+    thread.wait();
+
+    // The rule mustn't keep holding on to a source that's gone.
+    if(reportedState.load() == 1) {
+        SetActive(false);
+    }
+
+    AccountCpuTime();
+    qInfo() << "Stopped activation source" << name;
+}
+
+void ActivationSourceManager::Source::AccountCpuTime() {
+    const HANDLE thread_handle { threadHandle.load() };
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+
+    if(thread_handle == nullptr || !GetThreadTimes(thread_handle, &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return;
+    }
+
+    const ULARGE_INTEGER& kernel { { kernel_time.dwLowDateTime, kernel_time.dwHighDateTime } };
+    const ULARGE_INTEGER& user   { { user_time.dwLowDateTime,   user_time.dwHighDateTime   } };
+
+    const quint64& cpu_time_us { (kernel.QuadPart + user.QuadPart) / 10 };    // FILETIME counts 100 ns intervals.
+
+    if(cpu_time_us > accountedCpuTimeUs) {
+        cpuTimeMetric->Increment(cpu_time_us - accountedCpuTimeUs);
+        accountedCpuTimeUs = cpu_time_us;
+    }
+}
+
+const QString& ActivationSourceManager::Source::GetName() const {
+    return name;
+}
+
+ActivationSourceManager::Source::Source(ActivationSourceManager& source_manager, const QString& file_path)
+    :
+      manager               { source_manager },
+      loader                { file_path      },
+      thread                {                },
+      plugin                { nullptr        },
+      name                  {                },
+      threadHandle          { nullptr        },
+      reportedState         { -1             },
+      accountedCpuTimeUs    { 0              },
+      stateChangesMetric    { nullptr        },
+      cpuTimeMetric         { nullptr        },
+      activeMetric          { nullptr        }
+{
+
+}
+
+ActivationSourceManager::Source::~Source() {
+    Stop();
+
+    if(threadHandle.load() != nullptr) {
+        CloseHandle(threadHandle.load());
+    }
+
+    if(plugin != nullptr) {
+        loader.unload();
+    }
+}
+
+
+
+qsizetype ActivationSourceManager::LoadPlugins(const QString& directory) {
+    const QDir plugin_directory { directory };
+
+    if(!plugin_directory.exists()) {
+        return 0;
+    }
+
+    qsizetype started_count { 0 };
+
+    for(const QString& file_name : plugin_directory.entryList({ "*.dll" }, QDir::Files, QDir::Name)) {
+        Source* source { new Source { *this, plugin_directory.absoluteFilePath(file_name) } };
+        QString error;
+
+        if(!source->Load(error)) {
+            qWarning() << "Could not load activation source plugin" << file_name << ":" << error;
+            delete source;
+            continue;
+        }
+
+        if(GetSourceNames().contains(source->GetName())) {
+            qWarning() << "Skipping activation source plugin" << file_name << "as another plugin is already named" << source->GetName();
+            delete source;
+            continue;
+        }
+
+        sources.append(source);
+        source->Start();
+        ++started_count;
+    }
+
+    return started_count;
+}
+
+void ActivationSourceManager::UnloadPlugins() {
+    qDeleteAll(sources);
+    sources.clear();
+}
+
+QStringList ActivationSourceManager::GetSourceNames() const {
+    QStringList source_names;
+
+    for(const Source* source : sources) {
+        source_names.append(source->GetName());
+    }
+
+    return source_names;
+}
+
+void ActivationSourceManager::PublishMetrics() {
+    for(Source* source : sources) {
+        source->AccountCpuTime();
+    }
+}
+
+ActivationSourceManager::ActivationSourceManager(QObject* parent)
+    :
+      QObject    { parent }
+{
+
+}
+
+ActivationSourceManager::~ActivationSourceManager() {
+    UnloadPlugins();
+}
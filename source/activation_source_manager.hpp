@@ -0,0 +1,51 @@
+#ifndef ACTIVATION_SOURCE_MANAGER_HPP
+#define ACTIVATION_SOURCE_MANAGER_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "activation_source_interface.hpp"
+
+/* Loads the activation source plugins, runs each one on a thread of its own, and forwards their
+ * state changes to the GUI thread through SourceStateChanged. The cost of every plugin is
+ * accounted separately: the CPU time of its thread, and the number of state changes it reported,
+ * both labelled with the plugin's name, e.g. cursorlocker_activation_source_cpu_seconds_total.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ActivationSourceManager : public QObject {
+Q_OBJECT
+
+protected:
+    class Source;
+
+    QVector<Source*>    sources;
+
+public:
+    Q_SIGNAL void       SourceStateChanged(QString name, bool active);
+
+    qsizetype           LoadPlugins(const QString& directory);    // Loads and starts every plugin in directory; returns how many were started.
+    void                UnloadPlugins();                          // Stops every plugin, waiting for each one's Stop to return.
+
+    QStringList         GetSourceNames() const;
+    void                PublishMetrics();    // Brings the CPU time counters up to date; the state change counters always are.
+
+    explicit ActivationSourceManager(QObject* parent = nullptr);
+    virtual ~ActivationSourceManager() override;
+};
+
+#endif // ACTIVATION_SOURCE_MANAGER_HPP
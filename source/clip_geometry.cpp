@@ -0,0 +1,153 @@
+#include "clip_geometry.hpp"
+
+const QMap<QString, CLIP_REGION> ClipPolicy::RegionResolverSTOR = {
+    { "window" , CLIP_REGION::WINDOW_RECT  },
+    { "client" , CLIP_REGION::CLIENT_RECT  },
+    { "monitor", CLIP_REGION::MONITOR_RECT }
+};
+
+const QMap<CLIP_REGION, QString> ClipPolicy::RegionResolverRTOS = {
+    { CLIP_REGION::WINDOW_RECT , "window"  },
+    { CLIP_REGION::CLIENT_RECT , "client"  },
+    { CLIP_REGION::MONITOR_RECT, "monitor" }
+};
+
+bool ClipPolicy::operator==(const ClipPolicy& other) const {
+    return Region == other.Region
+            && Insets == other.Insets
+            && AspectWidth == other.AspectWidth
+            && AspectHeight == other.AspectHeight
+            && ScaleWithDpi == other.ScaleWithDpi;
+}
+
+bool ClipPolicy::operator!=(const ClipPolicy& other) const {
+    return !(*this == other);
+}
+
+ClipPolicy::ClipPolicy()
+    :
+      Region          { CLIP_REGION::WINDOW_RECT },
+      Insets          {                          },
+      AspectWidth     { 0                        },
+      AspectHeight    { 0                        },
+      ScaleWithDpi    { true                     }
+{
+
+}
+
+bool ClipGeometry::ComputeClipRect(HWND window_handle, const ClipPolicy& clip_policy, RECT& out_clip_rect) {
+    RECT clip_rect;
+
+    switch(clip_policy.Region) {
+    case CLIP_REGION::WINDOW_RECT : {
+        if(!GetWindowRect(window_handle, &clip_rect)) {
+            return false;
+        }
+
+        break;
+    }
+
+    case CLIP_REGION::CLIENT_RECT : {
+        // The client rect is relative to the window, so its corners have to be mapped to screen coordinates.
+        if(!GetClientRect(window_handle, &clip_rect)) {
+            return false;
+        }
+
+        MapWindowPoints(window_handle, nullptr, reinterpret_cast<POINT*>(&clip_rect), 2);
+        break;
+    }
+
+    case CLIP_REGION::MONITOR_RECT : {
+        MONITORINFO monitor_info;
+        monitor_info.cbSize = sizeof(MONITORINFO);
+
+        if(!GetMonitorInfo(MonitorFromWindow(window_handle, MONITOR_DEFAULTTONEAREST), &monitor_info)) {
+            return false;
+        }
+
+        clip_rect = monitor_info.rcMonitor;
+        break;
+    }
+    }
+
+    QMargins insets { clip_policy.Insets };
+
+    if(clip_policy.ScaleWithDpi && !insets.isNull()) {
+        const UINT& window_dpi { GetDpiForWindow(window_handle) };
+
+        if(window_dpi) {
+            insets = QMargins {
+                MulDiv(insets.left(),   static_cast<int>(window_dpi), USER_DEFAULT_SCREEN_DPI),
+                MulDiv(insets.top(),    static_cast<int>(window_dpi), USER_DEFAULT_SCREEN_DPI),
+                MulDiv(insets.right(),  static_cast<int>(window_dpi), USER_DEFAULT_SCREEN_DPI),
+                MulDiv(insets.bottom(), static_cast<int>(window_dpi), USER_DEFAULT_SCREEN_DPI)
+            };
+        }
+    }
+
+    clip_rect.left   += insets.left();
+    clip_rect.top    += insets.top();
+    clip_rect.right  -= insets.right();
+    clip_rect.bottom -= insets.bottom();
+
+    // Insets larger than the window would leave nothing to clip to, which ClipCursor would treat as a single point.
+    if(clip_rect.right <= clip_rect.left || clip_rect.bottom <= clip_rect.top) {
+        return false;
+    }
+
+    if(clip_policy.AspectWidth && clip_policy.AspectHeight) {
+        const LONG& width  { clip_rect.right - clip_rect.left };
+        const LONG& height { clip_rect.bottom - clip_rect.top };
+
+        // Compare width / height against AspectWidth / AspectHeight without dividing, then shrink whichever side is too long.
+        if(static_cast<qint64>(width) * clip_policy.AspectHeight > static_cast<qint64>(height) * clip_policy.AspectWidth) {
+            const LONG& aspect_width { static_cast<LONG>(static_cast<qint64>(height) * clip_policy.AspectWidth / clip_policy.AspectHeight) };
+
+            clip_rect.left += (width - aspect_width) / 2;
+            clip_rect.right = clip_rect.left + aspect_width;
+        } else {
+            const LONG& aspect_height { static_cast<LONG>(static_cast<qint64>(width) * clip_policy.AspectHeight / clip_policy.AspectWidth) };
+
+            clip_rect.top += (height - aspect_height) / 2;
+            clip_rect.bottom = clip_rect.top + aspect_height;
+        }
+    }
+
+    out_clip_rect = clip_rect;
+    return true;
+}
+
+bool ClipGeometry::GetClipRect(HWND window_handle, RECT& out_clip_rect) {
+    if(!cacheValid || cachedWindow != window_handle) {
+        cacheValid = ComputeClipRect(window_handle, clipPolicy, cachedClipRect);
+        cachedWindow = window_handle;
+    }
+
+    if(cacheValid) {
+        out_clip_rect = cachedClipRect;
+    }
+
+    return cacheValid;
+}
+
+void ClipGeometry::Invalidate() {
+    cacheValid = false;
+}
+
+void ClipGeometry::SetPolicy(const ClipPolicy& clip_policy) {
+    clipPolicy = clip_policy;
+    cacheValid = false;
+}
+
+const ClipPolicy& ClipGeometry::GetPolicy() const {
+    return clipPolicy;
+}
+
+ClipGeometry::ClipGeometry()
+    :
+      cachedWindow      { nullptr },
+      cachedClipRect    {         },
+      cacheValid        { false   }
+{
+
+}
@@ -0,0 +1,62 @@
+#ifndef CLIP_GEOMETRY_HPP
+#define CLIP_GEOMETRY_HPP
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QString>
+#include <QtCore/QMap>
+#include <QtCore/QMargins>
+
+// The part of the target window that the clip rectangle starts out from, before insets and the aspect ratio are applied.
+enum struct CLIP_REGION : quint8 {
+    WINDOW_RECT     =   0,    // GetWindowRect; includes the title bar and borders.
+    CLIENT_RECT     =   1,    // The client area only.
+    MONITOR_RECT    =   2     // The whole monitor that the window is (mostly) on.
+};
+
+struct ClipPolicy {
+    CLIP_REGION    Region;
+    QMargins       Insets;          // Shrinks the region on each side; in 96 DPI pixels if ScaleWithDpi is set.
+    quint32        AspectWidth;     // Together with AspectHeight, restricts the clip rectangle to the largest centered region
+    quint32        AspectHeight;    // of that aspect ratio. Ignored if either is 0.
+    bool           ScaleWithDpi;    // Scale Insets by the DPI of the window, so that they cover the same physical area on every monitor.
+
+    bool operator==(const ClipPolicy& other) const;
+    bool operator!=(const ClipPolicy& other) const;
+
+    static const QMap<QString, CLIP_REGION>    RegionResolverSTOR;
+    static const QMap<CLIP_REGION, QString>    RegionResolverRTOS;
+
+    ClipPolicy();
+};
+
+/* Computes the rectangle that the cursor is clipped to for a window according to a ClipPolicy. The
+ * result is cached per window, and only recomputed once the cache is invalidated, which is expected
+ * to happen whenever the window's geometry changes (moved, resized, maximized or moved to another
+ * monitor), rather than on every lock.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ClipGeometry {
+protected:
+    ClipPolicy    clipPolicy;
+
+    HWND          cachedWindow;
+    RECT          cachedClipRect;
+    bool          cacheValid;
+
+public:
+    static bool   ComputeClipRect(HWND window_handle, const ClipPolicy& clip_policy, RECT& out_clip_rect);
+
+    bool          GetClipRect(HWND window_handle, RECT& out_clip_rect);
+    void          Invalidate();
+
+    void                 SetPolicy(const ClipPolicy& clip_policy);
+    const ClipPolicy&    GetPolicy() const;
+
+    ClipGeometry();
+};
+
+#endif // CLIP_GEOMETRY_HPP
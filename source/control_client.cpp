@@ -0,0 +1,150 @@
+#include "control_client.hpp"
+
+#include <QtCore/QDeadlineTimer>
+#include <QtCore/QScopedValueRollback>
+
+bool ControlClient::readLine(QString& out_line, qint32 timeout_ms) {
+    const QDeadlineTimer deadline { timeout_ms };
+
+    while(!localSocket->canReadLine()) {
+        if(deadline.hasExpired() || !localSocket->waitForReadyRead(static_cast<int>(deadline.remainingTime()))) {
+            lastError = "timed out waiting for a response";
+            return false;
+        }
+    }
+
+    out_line = QString::fromUtf8(localSocket->readLine()).trimmed();
+    return true;
+}
+
+void ControlClient::onReadyRead() {
+    if(requestInProgress) {
+        return;
+    }
+
+    // Only events can arrive unprompted; responses are consumed by Request.
+    while(localSocket->canReadLine()) {
+        const QString& line { QString::fromUtf8(localSocket->readLine()).trimmed() };
+
+        if(line.startsWith("event ")) {
+            emit EventReceived(line.mid(6));
+        }
+    }
+}
+
+bool ControlClient::Connect(const QString& server_name, qint32 timeout_ms) {
+    localSocket->connectToServer(server_name);
+
+    if(!localSocket->waitForConnected(timeout_ms)) {
+        lastError = localSocket->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void ControlClient::Disconnect() {
+    localSocket->disconnectFromServer();
+}
+
+bool ControlClient::IsConnected() const {
+    return localSocket->state() == QLocalSocket::ConnectedState;
+}
+
+bool ControlClient::Request(const QString& command, const QString& argument, QString* out_payload, qint32 timeout_ms) {
+    if(!IsConnected()) {
+        lastError = "not connected";
+        return false;
+    }
+
+    localSocket->write((argument.isEmpty() ? command : command + ' ' + argument).toUtf8() + '\n');
+    localSocket->flush();
+
+    const QScopedValueRollback<bool> request_in_progress { requestInProgress, true };
+    QString line;
+
+    // Events may be interleaved with the response, so they're dispatched until the response line shows up.
+    while(readLine(line, timeout_ms)) {
+        if(line.startsWith("event ")) {
+            emit EventReceived(line.mid(6));
+            continue;
+        }
+
+        const qsizetype& separator_index { line.indexOf(' ') };
+        const QString& status  { separator_index < 0 ? line : line.left(separator_index) };
+        const QString& payload { separator_index < 0 ? QString {} : line.mid(separator_index + 1) };
+
+        if(status == "ok") {
+            if(out_payload != nullptr) {
+                *out_payload = payload;
+            }
+
+            return true;
+        }
+
+        lastError = payload;
+        return false;
+    }
+
+    return false;
+}
+
+bool ControlClient::Lock() {
+    return Request("lock", QString {});
+}
+
+bool ControlClient::Unlock() {
+    return Request("unlock", QString {});
+}
+
+bool ControlClient::SetTarget(const QString& method, const QString& parameter) {
+    return Request("target", method + ' ' + parameter);
+}
+
+bool ControlClient::QueryState(QString& out_state) {
+    return Request("state", QString {}, &out_state);
+}
+
+bool ControlClient::QueryMetrics(QByteArray& out_exposition, qint32 timeout_ms) {
+    const QScopedValueRollback<bool> request_in_progress { requestInProgress, true };
+    QString byte_count_string;
+
+    if(!Request("metrics", QString {}, &byte_count_string, timeout_ms)) {
+        return false;
+    }
+
+    const qint64& byte_count { byte_count_string.toLongLong() };
+    const QDeadlineTimer deadline { timeout_ms };
+
+    while(localSocket->bytesAvailable() < byte_count) {
+        if(deadline.hasExpired() || !localSocket->waitForReadyRead(static_cast<int>(deadline.remainingTime()))) {
+            lastError = "timed out waiting for the metrics exposition";
+            return false;
+        }
+    }
+
+    out_exposition = localSocket->read(byte_count);
+    return true;
+}
+
+bool ControlClient::Subscribe() {
+    return Request("subscribe", QString {});
+}
+
+const QString& ControlClient::GetLastError() const {
+    return lastError;
+}
+
+ControlClient::ControlClient(QObject* parent)
+    :
+      QObject              { parent                     },
+      localSocket          { new QLocalSocket { this }  },
+      requestInProgress    { false                      }
+{
+    connect(localSocket,    &QLocalSocket::readyRead,
+            this,           &ControlClient::onReadyRead);
+}
+
+ControlClient::~ControlClient() {
+    Disconnect();
+}
@@ -0,0 +1,54 @@
+#ifndef CONTROL_CLIENT_HPP
+#define CONTROL_CLIENT_HPP
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <QtNetwork/QLocalSocket>
+
+#include "control_server.hpp"
+
+/* Client side of the ControlServer protocol, for launchers and scripts that drive a running instance.
+ * Requests are blocking and return the payload of the response line; events received while a
+ * subscription is active are emitted through EventReceived, including those that arrive while a
+ * request is waiting for its response.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ControlClient : public QObject {
+Q_OBJECT
+
+protected:
+    QLocalSocket*    localSocket;
+    QString          lastError;
+    bool             requestInProgress;    // waitForReadyRead emits readyRead, which mustn't consume the response a request is waiting for.
+
+    bool             readLine(QString& out_line, qint32 timeout_ms);
+    Q_SLOT void      onReadyRead();
+
+public:
+    Q_SIGNAL void    EventReceived(QString event);
+
+    bool             Connect(const QString& server_name = ControlServer::DefaultServerName, qint32 timeout_ms = 1000);
+    void             Disconnect();
+    bool             IsConnected() const;
+
+    /* Sends a single request line and waits for its response. Returns true for an "ok" response, with
+     * its payload in out_payload; returns false for an "error" response or a timeout, in which case
+     * GetLastError describes what went wrong.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    bool             Request(const QString& command, const QString& argument, QString* out_payload = nullptr, qint32 timeout_ms = 1000);
+
+    bool             Lock();
+    bool             Unlock();
+    bool             SetTarget(const QString& method, const QString& parameter);    // method is "image" or "title".
+    bool             QueryState(QString& out_state);
+    bool             QueryMetrics(QByteArray& out_exposition, qint32 timeout_ms = 1000);    // The Prometheus text exposition of the running instance.
+    bool             Subscribe();
+
+    const QString&   GetLastError() const;
+
+    explicit ControlClient(QObject* parent = nullptr);
+    virtual ~ControlClient() override;
+};
+
+#endif // CONTROL_CLIENT_HPP
@@ -0,0 +1,132 @@
+#include "control_server.hpp"
+
+#include <QtCore/QtDebug>
+
+#include <utility>
+
+namespace {
+    QString sessionScopedName(const QString& name) {
+        DWORD session_id { 0 };
+        ProcessIdToSessionId(GetCurrentProcessId(), &session_id);
+
+        return name + "-" + QString::number(session_id);
+    }
+}
+
+const QString   ControlServer::DefaultServerName { sessionScopedName("cursor-locker-control") };
+const qsizetype ControlServer::MaxLineLength     { 4096                    };
+
+void ControlServer::writeLine(QLocalSocket* socket, const QString& line) {
+    socket->write(line.toUtf8() + '\n');
+    socket->flush();
+}
+
+void ControlServer::onNewConnection() {
+    while(localServer->hasPendingConnections()) {
+        QLocalSocket* socket { localServer->nextPendingConnection() };
+
+        connect(socket, &QLocalSocket::readyRead,
+                this,   [this, socket]() -> void { onReadyRead(socket); });
+
+        connect(socket, &QLocalSocket::disconnected,
+                this,   [this, socket]() -> void {
+                    subscribers.remove(socket);
+                    socket->deleteLater();
+                });
+    }
+}
+
+void ControlServer::onReadyRead(QLocalSocket* socket) {
+    while(socket->canReadLine()) {
+        // readLine reads at most maxSize - 1 bytes, so this leaves room for MaxLineLength characters and the terminator.
+        const QByteArray& line_bytes { socket->readLine(MaxLineLength + 2) };
+
+        // readLine stops at the length limit, so a line without its terminator was longer than any valid request.
+        if(!line_bytes.endsWith('\n')) {
+            dropOversizedConnection(socket);
+            return;
+        }
+
+        const QString& line { QString::fromUtf8(line_bytes).trimmed() };
+
+        if(line.isEmpty()) {
+            continue;
+        }
+
+        const qsizetype& separator_index { line.indexOf(' ') };
+        const QString& command  { separator_index < 0 ? line : line.left(separator_index) };
+        const QString& argument { separator_index < 0 ? QString {} : line.mid(separator_index + 1).trimmed() };
+
+        if(command == "subscribe") {
+            subscribers.insert(socket);
+            writeLine(socket, "ok");
+        } else if(command == "unsubscribe") {
+            subscribers.remove(socket);
+            writeLine(socket, "ok");
+        } else if(commandHandler) {
+            writeLine(socket, commandHandler(command, argument));
+        } else {
+            writeLine(socket, "error no command handler");
+        }
+    }
+
+    // A partial line that's already longer than any valid request will never become one.
+    if(socket->bytesAvailable() > MaxLineLength) {
+        dropOversizedConnection(socket);
+    }
+}
+
+void ControlServer::dropOversizedConnection(QLocalSocket* socket) {
+    qWarning() << "Dropping control connection that sent a line longer than" << MaxLineLength << "bytes.";
+
+    writeLine(socket, "error line too long");
+    socket->disconnectFromServer();
+}
+
+bool ControlServer::Listen(const QString& server_name) {
+    Close();
+
+    // Only the user running the program may connect; another user in another session has no business locking this user's cursor.
+    localServer->setSocketOptions(QLocalServer::UserAccessOption);
+
+    if(!localServer->listen(server_name)) {
+        qWarning() << "Failed to start the control server on" << server_name << ":" << localServer->errorString();
+        return false;
+    }
+
+    qInfo() << "Control server listening on" << localServer->fullServerName();
+    return true;
+}
+
+void ControlServer::Close() {
+    if(localServer->isListening()) {
+        localServer->close();
+    }
+}
+
+bool ControlServer::IsListening() const {
+    return localServer->isListening();
+}
+
+void ControlServer::SetCommandHandler(const CommandHandler& command_handler) {
+    commandHandler = command_handler;
+}
+
+void ControlServer::PublishEvent(const QString& event) {
+    for(QLocalSocket* subscriber : std::as_const(subscribers)) {
+        writeLine(subscriber, "event " + event);
+    }
+}
+
+ControlServer::ControlServer(QObject* parent)
+    :
+      QObject        { parent                      },
+      localServer    { new QLocalServer { this }   }
+{
+    connect(localServer,    &QLocalServer::newConnection,
+            this,           &ControlServer::onNewConnection);
+}
+
+ControlServer::~ControlServer() {
+    Close();
+}
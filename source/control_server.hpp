@@ -0,0 +1,66 @@
+#ifndef CONTROL_SERVER_HPP
+#define CONTROL_SERVER_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QSet>
+
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QLocalSocket>
+
+#include <functional>
+
+/* Local IPC endpoint (a named pipe on Windows) for external automation, e.g. a launcher that locks
+ * the cursor before starting a game and unlocks it after the game exits. The protocol is line based
+ * and UTF-8 encoded; every request is a single line of the form "<command>[ <argument>]", and gets
+ * exactly one response line, either "ok[ <payload>]" or "error <message>". After a "subscribe"
+ * request, the connection additionally receives "event <payload>" lines whenever PublishEvent is
+ * called. Commands other than "subscribe" are passed on to the command handler.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ControlServer : public QObject {
+Q_OBJECT
+
+public:
+    // Receives the command and the (possibly empty) argument, and returns the response line without its line terminator.
+    typedef std::function<QString(const QString& command, const QString& argument)> CommandHandler;
+
+    static const QString    DefaultServerName;    // Suffixed with the session ID, as named pipes are machine-wide, unlike the Local\ mutex of SingleInstanceGuard.
+    static const qsizetype  MaxLineLength;      // Connections that send longer lines are dropped, rather than buffered indefinitely.
+
+protected:
+    QLocalServer*          localServer;
+    QSet<QLocalSocket*>    subscribers;
+    CommandHandler         commandHandler;
+
+    void            writeLine(QLocalSocket* socket, const QString& line);
+    Q_SLOT void     onNewConnection();
+    void            onReadyRead(QLocalSocket* socket);
+    void            dropOversizedConnection(QLocalSocket* socket);
+
+public:
+    bool            Listen(const QString& server_name = DefaultServerName);
+    void            Close();
+    bool            IsListening() const;
+
+    void            SetCommandHandler(const CommandHandler& command_handler);
+    void            PublishEvent(const QString& event);    // Sends "event <event>" to every subscribed connection.
+
+    explicit ControlServer(QObject* parent = nullptr);
+    virtual ~ControlServer() override;
+};
+
+#endif // CONTROL_SERVER_HPP
@@ -0,0 +1,89 @@
+#include "cursor_escape_watchdog.hpp"
+#include "cursor_lock.hpp"
+#include "metrics_registry.hpp"
+
+#include <QtCore/QtDebug>
+
+namespace {
+    MetricsRegistry::Counter&   escapesMetric              { MetricsRegistry::Instance().RegisterCounter("cursorlocker_cursor_escapes_total", {}, "Number of times the cursor was found outside of the lock, and the clip was re-asserted.") };
+    MetricsRegistry::Histogram& reassertionLatencyMetric   { MetricsRegistry::Instance().RegisterHistogram("cursorlocker_clip_reassertion_latency_seconds", {}, "Time from the mouse movement that revealed an escape to the clip being re-asserted.", MetricsRegistry::LatencyBucketsUs(), 1e-6) };
+
+    // HID usage page and usage of a generic mouse.
+    constexpr USHORT HID_USAGE_PAGE_GENERIC { 0x01 };
+    constexpr USHORT HID_USAGE_GENERIC_MOUSE { 0x02 };
+}
+
+bool CursorEscapeWatchdog::Arm(HWND target_window) {
+    if(targetWindow == target_window) {
+        return true;
+    }
+
+    RAWINPUTDEVICE raw_input_device {
+        HID_USAGE_PAGE_GENERIC,
+        HID_USAGE_GENERIC_MOUSE,
+        RIDEV_INPUTSINK,
+        target_window
+    };
+
+    if(!RegisterRawInputDevices(&raw_input_device, 1, sizeof(RAWINPUTDEVICE))) {
+        qInfo() << "RegisterRawInputDevices failed for the cursor escape watchdog, GetLastError() =" << GetLastError();
+        return false;
+    }
+
+    targetWindow = target_window;
+    return true;
+}
+
+void CursorEscapeWatchdog::Disarm() {
+    if(targetWindow == nullptr) {
+        return;
+    }
+
+    RAWINPUTDEVICE raw_input_device {
+        HID_USAGE_PAGE_GENERIC,
+        HID_USAGE_GENERIC_MOUSE,
+        RIDEV_REMOVE,
+        nullptr
+    };
+
+    RegisterRawInputDevices(&raw_input_device, 1, sizeof(RAWINPUTDEVICE));
+    targetWindow = nullptr;
+}
+
+bool CursorEscapeWatchdog::IsArmed() const {
+    return targetWindow != nullptr;
+}
+
+bool CursorEscapeWatchdog::HandleRawInput(const MSG* msg) {
+    if(msg->message != WM_INPUT || targetWindow == nullptr || msg->hwnd != targetWindow) {
+        return false;
+    }
+
+    /* Only mouse input is registered, so the contents of the RAWINPUT structure are irrelevant; the
+     * message itself means that the cursor may have moved. The message still has to reach DefWindowProc
+     * so that the raw input buffer is released, which is why the caller shouldn't consume it.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    if(cursorLock.EnforceClip()) {
+        // msg->time shares the GetTickCount() time base, as with the WM_HOTKEY latency.
+        const quint32& latency_ms { GetTickCount() - msg->time };
+
+        escapesMetric.Increment();
+        reassertionLatencyMetric.Observe(latency_ms * 1000ull);
+
+        qDebug() << "Cursor escaped the lock; re-asserted the clip" << QString::number(latency_ms) << "ms after the movement.";
+    }
+
+    return true;
+}
+
+CursorEscapeWatchdog::CursorEscapeWatchdog(CursorLock& cursor_lock)
+    :
+      cursorLock      { cursor_lock },
+      targetWindow    { nullptr     }
+{
+
+}
+
+CursorEscapeWatchdog::~CursorEscapeWatchdog() {
+    Disarm();
+}
@@ -0,0 +1,37 @@
+#ifndef CURSOR_ESCAPE_WATCHDOG_HPP
+#define CURSOR_ESCAPE_WATCHDOG_HPP
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QtGlobal>
+
+class CursorLock;
+
+/* Detects the cursor escaping the lock, e.g. because the foreground application called
+ * ClipCursor(nullptr) itself, and re-asserts the clip. Rather than polling, the watchdog
+ * registers for raw mouse input while the lock is enabled; the cursor can only escape by
+ * moving, and every movement delivers a WM_INPUT message, which the owning window forwards
+ * to HandleRawInput. RIDEV_INPUTSINK keeps the messages coming while the window is in the
+ * background, which is the only case where they're of any use.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class CursorEscapeWatchdog {
+protected:
+    CursorLock&    cursorLock;
+    HWND           targetWindow;    // The window receiving WM_INPUT while armed, or nullptr while disarmed.
+
+public:
+    bool       Arm(HWND target_window);    // Registers for raw mouse input delivered to target_window.
+    void       Disarm();
+    bool       IsArmed() const;
+
+    bool       HandleRawInput(const MSG* msg);    // Returns true if the message was a WM_INPUT meant for the watchdog.
+
+    explicit CursorEscapeWatchdog(CursorLock& cursor_lock);
+    ~CursorEscapeWatchdog();
+};
+
+#endif // CURSOR_ESCAPE_WATCHDOG_HPP
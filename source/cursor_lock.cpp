@@ -0,0 +1,158 @@
+#include "cursor_lock.hpp"
+#include "metrics_registry.hpp"
+
+#include <chrono>
+
+namespace {
+    MetricsRegistry::Counter& lockActivationsMetric   { MetricsRegistry::Instance().RegisterCounter("cursorlocker_lock_activations_total", {}, "Number of times the cursor lock was enabled.") };
+    MetricsRegistry::Counter& redundantClipsMetric    { MetricsRegistry::Instance().RegisterCounter("cursorlocker_redundant_clip_calls_total", {}, "ClipCursor calls made while the lock was already enabled on the same window.") };
+    MetricsRegistry::Counter& lockedTimeMetric        { MetricsRegistry::Instance().RegisterCounter("cursorlocker_locked_seconds_total", {}, "Total time the cursor lock was enabled, up to the most recent unlock.", 1e-6) };
+    MetricsRegistry::Gauge&   lockedMetric            { MetricsRegistry::Instance().RegisterGauge("cursorlocker_locked", {}, "Whether the cursor lock is currently enabled.") };
+
+    qint64 steadyClockUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+bool CursorLock::setEnabledLocked(bool state) {
+    const bool previous_state { lockEnabled };
+
+    if(state) {
+        HWND foreground_window_hwnd { GetForegroundWindow() };
+        RECT clip_rect;
+
+        if(foreground_window_hwnd != nullptr && IsWindow(foreground_window_hwnd)) {
+            if(clipGeometry.GetClipRect(foreground_window_hwnd, clip_rect)) {
+                if(previous_state && clippedWindow == foreground_window_hwnd) {
+                    redundantClipsMetric.Increment();
+                }
+
+                applyClipRect(clip_rect);
+                clippedWindow = foreground_window_hwnd;
+                lockEnabled = state;
+            }
+        }
+    } else {
+        ClipCursor(nullptr);
+        clippedWindow = nullptr;
+        lockEnabled = state;
+    }
+
+    if(lockEnabled != previous_state) {
+        if(lockEnabled) {
+            lockActivationsMetric.Increment();
+            lockedSinceUs = steadyClockUs();
+        } else {
+            lockedTimeMetric.Increment(static_cast<quint64>(steadyClockUs() - lockedSinceUs));
+        }
+
+        lockedMetric.Set(lockEnabled);
+
+        if(stateChangedCallback) {
+            stateChangedCallback(lockEnabled);
+        }
+    }
+
+    return lockEnabled;
+}
+
+void CursorLock::applyClipRect(const RECT& clip_rect) {
+    ClipCursor(&clip_rect);
+
+    if(!GetClipCursor(&appliedClipRect)) {
+        appliedClipRect = clip_rect;
+    }
+}
+
+bool CursorLock::SetEnabled(bool state) {
+    QMutexLocker state_locker { &stateMutex };
+    return setEnabledLocked(state);
+}
+
+bool CursorLock::Toggle() {
+    QMutexLocker state_locker { &stateMutex };
+    return setEnabledLocked(lockEnabled ^ true);
+}
+
+bool CursorLock::EnforceClip() {
+    if(!lockEnabled) {
+        return false;
+    }
+
+    QMutexLocker state_locker { &stateMutex };
+
+    if(!lockEnabled) {
+        return false;
+    }
+
+    RECT current_clip_rect;
+    POINT cursor_position;
+
+    const bool clip_intact {
+        GetClipCursor(&current_clip_rect) && EqualRect(&current_clip_rect, &appliedClipRect)
+    };
+
+    const bool cursor_inside {
+        !GetCursorPos(&cursor_position) || PtInRect(&appliedClipRect, cursor_position)
+    };
+
+    if(clip_intact && cursor_inside) {
+        return false;
+    }
+
+    ClipCursor(&appliedClipRect);
+    return true;
+}
+
+bool CursorLock::IsEnabled() const {
+    return lockEnabled;
+}
+
+void CursorLock::SetClipPolicy(const ClipPolicy& clip_policy) {
+    QMutexLocker state_locker { &stateMutex };
+
+    if(clip_policy == clipGeometry.GetPolicy()) {
+        return;
+    }
+
+    clipGeometry.SetPolicy(clip_policy);
+
+    if(lockEnabled) {
+        setEnabledLocked(true);
+    }
+}
+
+void CursorLock::OnWindowGeometryChanged(HWND window_handle) {
+    QMutexLocker state_locker { &stateMutex };
+
+    clipGeometry.Invalidate();
+
+    if(lockEnabled && (window_handle == nullptr || window_handle == clippedWindow)) {
+        RECT clip_rect;
+
+        if(clipGeometry.GetClipRect(clippedWindow, clip_rect)) {
+            applyClipRect(clip_rect);
+        }
+    }
+}
+
+void CursorLock::SetStateChangedCallback(const StateChangedCallback& state_changed_callback) {
+    QMutexLocker state_locker { &stateMutex };
+    stateChangedCallback = state_changed_callback;
+}
+
+CursorLock::CursorLock()
+    :
+      lockEnabled      { false   },
+      clippedWindow    { nullptr },
+      appliedClipRect  {         },
+      lockedSinceUs    { 0       }
+{
+
+}
+
+CursorLock::~CursorLock() {
+    if(lockEnabled) {
+        ClipCursor(nullptr);
+    }
+}
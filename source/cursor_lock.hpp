@@ -0,0 +1,63 @@
+#ifndef CURSOR_LOCK_HPP
+#define CURSOR_LOCK_HPP
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QMutex>
+
+#include <atomic>
+#include <functional>
+
+#include "clip_geometry.hpp"
+
+/* Owns the ClipCursor state of the process. ClipCursor affects the whole desktop rather than
+ * the calling thread, so this may be used from the GUI thread and the low-level keyboard hook
+ * thread alike; state changes are serialized, and IsEnabled is a plain atomic load.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class CursorLock {
+public:
+    typedef std::function<void(bool state)> StateChangedCallback;
+
+protected:
+    mutable QMutex       stateMutex;
+    std::atomic<bool>    lockEnabled;
+
+    ClipGeometry         clipGeometry;      // Guarded by stateMutex.
+    HWND                 clippedWindow;     // Guarded by stateMutex; the window the cursor is currently clipped to.
+    RECT                 appliedClipRect;   // Guarded by stateMutex; the clip rectangle as read back from the system, after it clamped it to the virtual screen.
+
+    StateChangedCallback stateChangedCallback;    // Guarded by stateMutex.
+    qint64               lockedSinceUs;           // Guarded by stateMutex; steady_clock time of the most recent activation, for the locked time metric.
+
+    bool setEnabledLocked(bool state);
+    void applyClipRect(const RECT& clip_rect);
+
+public:
+    bool SetEnabled(bool state);    // Clips the cursor to the foreground window according to the clip policy, or releases it. Returns the resulting state.
+    bool Toggle();                  // Inverts the current state. Returns the resulting state.
+    bool IsEnabled() const;
+
+    /* Re-asserts the clip if something else released or replaced it, e.g. a game calling ClipCursor(nullptr),
+     * or if the cursor is outside of the clip rectangle. Returns true if the clip had to be re-asserted. This
+     * is meant to be called on cursor movement, so it's a single atomic load while the lock is disabled.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    bool EnforceClip();
+
+    void SetClipPolicy(const ClipPolicy& clip_policy);    // Takes effect immediately if the lock is enabled.
+    void OnWindowGeometryChanged(HWND window_handle);     // Drops the cached clip rectangle, and re-clips if window_handle is the clipped window, or nullptr for a display change.
+
+    /* Called whenever the lock is actually enabled or disabled, but not for redundant calls. It's called
+     * on whichever thread changed the state, with the state mutex held, so it mustn't call back into
+     * this CursorLock and should hand off anything non-trivial to another thread.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    void SetStateChangedCallback(const StateChangedCallback& state_changed_callback);
+
+    CursorLock();
+    ~CursorLock();
+};
+
+#endif // CURSOR_LOCK_HPP
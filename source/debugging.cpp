@@ -24,6 +24,15 @@ errno_t Debugging::SpawnDebugConsole() {
     return NULL;
 }
 
+errno_t Debugging::AttachParentConsole() {
+    if(!AttachConsole(ATTACH_PARENT_PROCESS)) {
+        return EBADF;
+    }
+
+    FILE* console_stdout { nullptr };
+    return freopen_s(&console_stdout, "CONOUT$", "w", stdout);
+}
+
 void Debugging::DebugMessageHandler(QtMsgType message_type, const QMessageLogContext& message_context, const QString& message) {
     const QMap<QtMsgType, QString>& message_type_resolver {
         { QtMsgType::QtDebugMsg,       "DEBUG"    },
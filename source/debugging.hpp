@@ -23,6 +23,7 @@ namespace Debugging {
     extern bool LOG_FILE_HAS_BEEN_DELETED;
 
     errno_t SpawnDebugConsole();
+    errno_t AttachParentConsole();    // Redirects stdout to the console of the launching shell, if any, for command line output.
     void DebugMessageHandler(QtMsgType message_type, const QMessageLogContext& message_context, const QString& message);
 }
 
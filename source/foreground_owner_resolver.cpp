@@ -0,0 +1,105 @@
+#include "foreground_owner_resolver.hpp"
+#include "metrics_registry.hpp"
+
+#include <QtCore/QFileInfo>
+
+namespace {
+    MetricsRegistry::Counter& ownerCacheHitsMetric    { MetricsRegistry::Instance().RegisterCounter("cursorlocker_foreground_owner_lookups_total", "result=\"hit\"", "Number of window owner image lookups, by whether the image name was cached.") };
+    MetricsRegistry::Counter& ownerCacheMissesMetric  { MetricsRegistry::Instance().RegisterCounter("cursorlocker_foreground_owner_lookups_total", "result=\"miss\"", "Number of window owner image lookups, by whether the image name was cached.") };
+}
+
+void ForegroundOwnerResolver::evictExitedProcesses() {
+    for(auto entry { cache.begin() }; entry != cache.end();) {
+        if(WaitForSingleObject(entry.value().ProcessHandle, 0) == WAIT_OBJECT_0) {
+            CloseHandle(entry.value().ProcessHandle);
+            entry = cache.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+
+    // Only reachable with MAX_ENTRIES live processes gaining focus, which costs nothing more than a refill.
+    if(cache.size() >= MAX_ENTRIES) {
+        Clear();
+    }
+}
+
+QString ForegroundOwnerResolver::Resolve(HWND window_handle, DWORD* out_pid) {
+    DWORD pid { 0 };
+
+    if(window_handle != nullptr) {
+        GetWindowThreadProcessId(window_handle, &pid);
+    }
+
+    if(out_pid != nullptr) {
+        *out_pid = pid;
+    }
+
+    return pid ? ResolvePid(pid) : QString {};
+}
+
+QString ForegroundOwnerResolver::ResolvePid(DWORD pid) {
+    const auto& entry { cache.constFind(pid) };
+
+    if(entry != cache.constEnd()) {
+        ownerCacheHitsMetric.Increment();
+        return entry.value().ImageName;
+    }
+
+    ownerCacheMissesMetric.Increment();
+
+    // SYNCHRONIZE lets evictExitedProcesses tell whether the process is still alive.
+    HANDLE process_handle { OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, pid) };
+
+    if(process_handle == nullptr) {
+        return QString {};
+    }
+
+    wchar_t image_path[MAX_PATH];
+    DWORD image_path_size { MAX_PATH };
+
+    if(!QueryFullProcessImageNameW(process_handle, 0, image_path, &image_path_size)) {
+        CloseHandle(process_handle);
+        return QString {};
+    }
+
+    if(cache.size() >= MAX_ENTRIES) {
+        evictExitedProcesses();
+    }
+
+    const QString& image_name { QFileInfo { QString::fromWCharArray(image_path, image_path_size) }.fileName() };
+    cache.insert(pid, { process_handle, image_name });
+
+    return image_name;
+}
+
+void ForegroundOwnerResolver::Invalidate(DWORD pid) {
+    const auto& entry { cache.find(pid) };
+
+    if(entry != cache.end()) {
+        CloseHandle(entry.value().ProcessHandle);
+        cache.erase(entry);
+    }
+}
+
+void ForegroundOwnerResolver::Invalidate(const QVector<DWORD>& pids) {
+    for(const DWORD& pid : pids) {
+        Invalidate(pid);
+    }
+}
+
+void ForegroundOwnerResolver::Clear() {
+    for(const Entry& entry : cache) {
+        CloseHandle(entry.ProcessHandle);
+    }
+
+    cache.clear();
+}
+
+ForegroundOwnerResolver::ForegroundOwnerResolver() {
+
+}
+
+ForegroundOwnerResolver::~ForegroundOwnerResolver() {
+    Clear();
+}
@@ -0,0 +1,58 @@
+#ifndef FOREGROUND_OWNER_RESOLVER_HPP
+#define FOREGROUND_OWNER_RESOLVER_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+/* Maps a window to the image name of the process that owns it. GetWindowThreadProcessId is cheap,
+ * but opening the process and querying its image path isn't, and focus changes keep landing on the
+ * same handful of processes, so image names are cached by PID. Every entry keeps a handle to its
+ * process open, and Windows never reuses the PID of a process that still has open handles, so a
+ * cached entry can't end up describing a different process. Entries are dropped when the process
+ * exit is reported through Invalidate, or when the cache fills up and the process has exited.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ForegroundOwnerResolver {
+public:
+    static constexpr qsizetype MAX_ENTRIES { 64 };
+
+protected:
+    struct Entry {
+        HANDLE     ProcessHandle;
+        QString    ImageName;
+    };
+
+    QHash<DWORD, Entry>    cache;
+
+    void                   evictExitedProcesses();
+
+public:
+    QString                Resolve(HWND window_handle, DWORD* out_pid = nullptr);    // Empty if the window or its process couldn't be queried.
+    QString                ResolvePid(DWORD pid);
+
+    void                   Invalidate(DWORD pid);
+    void                   Invalidate(const QVector<DWORD>& pids);
+    void                   Clear();
+
+    ForegroundOwnerResolver();
+    ~ForegroundOwnerResolver();
+
+    ForegroundOwnerResolver(const ForegroundOwnerResolver&) = delete;
+    ForegroundOwnerResolver& operator=(const ForegroundOwnerResolver&) = delete;
+};
+
+#endif // FOREGROUND_OWNER_RESOLVER_HPP
@@ -0,0 +1,225 @@
+#include "foreground_window_watcher.hpp"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QtDebug>
+
+ForegroundWindowWatcher* ForegroundWindowWatcher::activeInstance { nullptr };
+
+bool WindowIdentity::IsValid() const {
+    return Handle != nullptr;
+}
+
+QString WindowIdentity::GetWindowTitle(HWND window_handle) {
+    const qint32& title_length { GetWindowTextLengthW(window_handle) };
+
+    if(title_length <= 0) {
+        return QString {};
+    }
+
+    // The length is only an upper bound for some windows, so trust what GetWindowText actually wrote.
+    QString title(title_length, Qt::Uninitialized);
+    const qint32& characters_written { GetWindowTextW(window_handle, reinterpret_cast<wchar_t*>(title.data()), title_length + 1) };
+    title.truncate(characters_written);
+
+    return title;
+}
+
+QStringView WindowIdentity::ReadWindowTitle(HWND window_handle, QVector<wchar_t>& buffer) {
+    const qint32& title_length { GetWindowTextLengthW(window_handle) };
+
+    if(title_length <= 0) {
+        return QStringView {};
+    }
+
+    buffer.resize(title_length + 1);
+    const qint32& characters_written { GetWindowTextW(window_handle, buffer.data(), title_length + 1) };
+
+    return QStringView { buffer.constData(), characters_written };
+}
+
+WindowIdentity WindowIdentity::FromHandle(HWND window_handle, ForegroundOwnerResolver* owner_resolver) {
+    WindowIdentity identity;
+
+    if(window_handle == nullptr || !IsWindow(window_handle)) {
+        return identity;
+    }
+
+    identity.Handle = window_handle;
+    identity.Title = GetWindowTitle(window_handle);
+
+    // Window class names are limited to 256 characters.
+    wchar_t class_name[257];
+    const qint32& class_name_length { GetClassNameW(window_handle, class_name, 257) };
+    identity.ClassName = QString::fromWCharArray(class_name, class_name_length);
+
+    if(owner_resolver != nullptr) {
+        identity.ImageName = owner_resolver->Resolve(window_handle, &identity.Pid);
+        return identity;
+    }
+
+    GetWindowThreadProcessId(window_handle, &identity.Pid);
+
+    HANDLE process_handle { OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, identity.Pid) };
+
+    if(process_handle != nullptr) {
+        wchar_t image_path[MAX_PATH];
+        DWORD image_path_size { MAX_PATH };
+
+        if(QueryFullProcessImageNameW(process_handle, 0, image_path, &image_path_size)) {
+            identity.ImageName = QFileInfo { QString::fromWCharArray(image_path, image_path_size) }.fileName();
+        }
+
+        CloseHandle(process_handle);
+    }
+
+    return identity;
+}
+
+WindowIdentity::WindowIdentity()
+    :
+      Handle    { nullptr },
+      Pid       { 0       }
+{
+
+}
+
+void CALLBACK ForegroundWindowWatcher::winEventProcedure(HWINEVENTHOOK hook_handle, DWORD event, HWND window_handle, LONG object_id, LONG child_id, DWORD thread_id, DWORD event_time) {
+    Q_UNUSED(hook_handle)
+    Q_UNUSED(thread_id)
+
+    ForegroundWindowWatcher* instance { activeInstance };
+
+    if(instance == nullptr || object_id != OBJID_WINDOW || child_id != CHILDID_SELF || window_handle == nullptr) {
+        return;
+    }
+
+    if(event == EVENT_SYSTEM_FOREGROUND) {
+        instance->lastEventTime = event_time;
+
+        const WindowIdentity& identity { WindowIdentity::FromHandle(window_handle, &instance->ownerResolver) };
+
+        instance->foregroundWindow = window_handle;
+        instance->hookLocationChanges(identity.Pid);
+
+        emit instance->ForegroundWindowChanged(identity);
+    } else if(window_handle != instance->foregroundWindow) {
+        // Name changes are reported for every window on the desktop, so anything but the foreground window is dropped right away.
+        return;
+    } else if(event == EVENT_OBJECT_NAMECHANGE) {
+        instance->lastEventTime = event_time;
+        emit instance->ForegroundWindowRenamed(WindowIdentity::FromHandle(window_handle, &instance->ownerResolver));
+    } else if(event == EVENT_OBJECT_LOCATIONCHANGE) {
+        instance->lastEventTime = event_time;
+        emit instance->ForegroundWindowGeometryChanged(window_handle);
+    }
+}
+
+void ForegroundWindowWatcher::hookLocationChanges(DWORD pid) {
+    if(locationChangeHook != nullptr && pid == locationChangePid) {
+        return;
+    }
+
+    if(locationChangeHook != nullptr) {
+        UnhookWinEvent(locationChangeHook);
+        locationChangeHook = nullptr;
+    }
+
+    /* Location changes are reported for every object that moves, including the caret and the cursor
+     * itself, so the hook is limited to the foreground process to keep the event rate down.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    if(pid) {
+        locationChangeHook = SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, nullptr, &ForegroundWindowWatcher::winEventProcedure, pid, 0, WINEVENT_OUTOFCONTEXT);
+        locationChangePid = pid;
+    }
+}
+
+bool ForegroundWindowWatcher::installHooks() {
+    if(activeInstance != nullptr && activeInstance != this) {
+        qCritical() << "A foreground window watcher is already active, refusing to install a second set of hooks.";
+        return false;
+    }
+
+    foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, &ForegroundWindowWatcher::winEventProcedure, 0, 0, WINEVENT_OUTOFCONTEXT);
+    nameChangeHook = SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, nullptr, &ForegroundWindowWatcher::winEventProcedure, 0, 0, WINEVENT_OUTOFCONTEXT);
+
+    if(foregroundHook == nullptr) {
+        qCritical() << "SetWinEventHook(EVENT_SYSTEM_FOREGROUND) failed.";
+        removeHooks();
+        return false;
+    }
+
+    activeInstance = this;
+    foregroundWindow = ::GetForegroundWindow();
+
+    DWORD foreground_pid { 0 };
+    GetWindowThreadProcessId(foregroundWindow, &foreground_pid);
+    hookLocationChanges(foreground_pid);
+
+    qInfo() << "Installed foreground window event hooks.";
+    return true;
+}
+
+void ForegroundWindowWatcher::removeHooks() {
+    if(foregroundHook != nullptr) {
+        UnhookWinEvent(foregroundHook);
+        foregroundHook = nullptr;
+    }
+
+    if(nameChangeHook != nullptr) {
+        UnhookWinEvent(nameChangeHook);
+        nameChangeHook = nullptr;
+    }
+
+    if(locationChangeHook != nullptr) {
+        UnhookWinEvent(locationChangeHook);
+        locationChangeHook = nullptr;
+    }
+
+    if(activeInstance == this) {
+        activeInstance = nullptr;
+        qInfo() << "Removed foreground window event hooks.";
+    }
+}
+
+void ForegroundWindowWatcher::AddSubscriber() {
+    if(subscriberCount++ == 0) {
+        installHooks();
+    }
+}
+
+void ForegroundWindowWatcher::RemoveSubscriber() {
+    if(subscriberCount && --subscriberCount == 0) {
+        removeHooks();
+    }
+}
+
+HWND ForegroundWindowWatcher::GetForegroundWindow() const {
+    return activeInstance == this ? foregroundWindow : ::GetForegroundWindow();
+}
+
+DWORD ForegroundWindowWatcher::GetLastEventTime() const {
+    return lastEventTime;
+}
+
+ForegroundOwnerResolver& ForegroundWindowWatcher::GetOwnerResolver() {
+    return ownerResolver;
+}
+
+ForegroundWindowWatcher::ForegroundWindowWatcher(QObject* parent)
+    :
+      QObject               { parent  },
+      foregroundHook        { nullptr },
+      nameChangeHook        { nullptr },
+      locationChangeHook    { nullptr },
+      locationChangePid     { 0       },
+      foregroundWindow      { nullptr },
+      lastEventTime         { 0       },
+      subscriberCount       { 0       },
+      ownerResolver         {         }
+{
+    qRegisterMetaType<WindowIdentity>();
+}
+
+ForegroundWindowWatcher::~ForegroundWindowWatcher() {
+    removeHooks();
+}
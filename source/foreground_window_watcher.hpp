@@ -0,0 +1,90 @@
+#ifndef FOREGROUND_WINDOW_WATCHER_HPP
+#define FOREGROUND_WINDOW_WATCHER_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringView>
+#include <QtCore/QVector>
+#include <QtCore/QMetaType>
+
+#include "foreground_owner_resolver.hpp"
+
+// Everything that identifies a top-level window, captured at a single point in time.
+struct WindowIdentity {
+    HWND       Handle;
+    QString    Title;
+    QString    ClassName;
+    DWORD      Pid;
+    QString    ImageName;    // File name of the owning process' executable, or empty if the process couldn't be queried.
+
+    bool                     IsValid() const;
+
+    static QString           GetWindowTitle(HWND window_handle);    // The complete title, regardless of its length.
+    static QStringView       ReadWindowTitle(HWND window_handle, QVector<wchar_t>& buffer);    // Same, but into buffer, which keeps its capacity between calls.
+    static WindowIdentity    FromHandle(HWND window_handle, ForegroundOwnerResolver* owner_resolver = nullptr);    // The image name is looked up through owner_resolver, if given.
+
+    WindowIdentity();
+};
+
+Q_DECLARE_METATYPE(WindowIdentity)
+
+/* Publishes foreground window changes as they happen, through SetWinEventHook, instead of consumers
+ * polling GetForegroundWindow. The hooks are out-of-context, so the callbacks arrive through the
+ * message loop of the thread that installed them, which is the GUI thread. Like the snapshot service,
+ * the hooks are only installed while at least one subscriber exists. Geometry changes of the
+ * foreground window are reported as well, so that the clip rectangle can follow the window.
+ * The image names of the published identities come from a ForegroundOwnerResolver, so that a
+ * focus change doesn't have to open the owning process every time.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ForegroundWindowWatcher : public QObject {
+Q_OBJECT
+
+protected:
+    static ForegroundWindowWatcher*    activeInstance;    // WINEVENTPROC takes no context pointer; only one watcher may have hooks installed.
+    static void CALLBACK               winEventProcedure(HWINEVENTHOOK hook_handle, DWORD event, HWND window_handle, LONG object_id, LONG child_id, DWORD thread_id, DWORD event_time);
+
+    HWINEVENTHOOK     foregroundHook;
+    HWINEVENTHOOK     nameChangeHook;
+    HWINEVENTHOOK     locationChangeHook;    // Scoped to the process owning the foreground window; re-installed whenever it changes.
+    DWORD             locationChangePid;
+    HWND              foregroundWindow;
+    DWORD             lastEventTime;         // The GetTickCount() timestamp of the most recently reported event, 0 before the first one.
+    quint32           subscriberCount;
+
+    ForegroundOwnerResolver    ownerResolver;
+
+    bool              installHooks();
+    void              removeHooks();
+    void              hookLocationChanges(DWORD pid);
+
+public:
+    Q_SIGNAL void     ForegroundWindowChanged(WindowIdentity identity);
+    Q_SIGNAL void     ForegroundWindowRenamed(WindowIdentity identity);    // The title of the current foreground window changed.
+    Q_SIGNAL void     ForegroundWindowGeometryChanged(HWND window_handle);  // The current foreground window was moved, resized, minimized or maximized.
+
+    void              AddSubscriber();
+    void              RemoveSubscriber();
+
+    HWND              GetForegroundWindow() const;
+    DWORD             GetLastEventTime() const;    // For measuring the latency of whatever the signals set off, against GetTickCount().
+    ForegroundOwnerResolver&   GetOwnerResolver();    // Exited processes should be reported to it through Invalidate.
+
+    explicit ForegroundWindowWatcher(QObject* parent = nullptr);
+    virtual ~ForegroundWindowWatcher() override;
+};
+
+#endif // FOREGROUND_WINDOW_WATCHER_HPP
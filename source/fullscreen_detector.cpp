@@ -0,0 +1,93 @@
+#include "fullscreen_detector.hpp"
+
+#include <QtCore/QStringView>
+
+bool FullscreenDetector::getMonitorRect(HMONITOR monitor_handle, RECT& out_rect) {
+    const auto& cached_rect { monitorRects.constFind(monitor_handle) };
+
+    if(cached_rect != monitorRects.constEnd()) {
+        out_rect = cached_rect.value();
+        return true;
+    }
+
+    MONITORINFO monitor_info {};
+    monitor_info.cbSize = sizeof(monitor_info);
+
+    if(!GetMonitorInfoW(monitor_handle, &monitor_info)) {
+        return false;
+    }
+
+    // rcMonitor rather than rcWork, as a fullscreen window covers the taskbar too.
+    monitorRects.insert(monitor_handle, monitor_info.rcMonitor);
+    out_rect = monitor_info.rcMonitor;
+
+    return true;
+}
+
+bool FullscreenDetector::Covers(const RECT& window_rect, const RECT& monitor_rect) {
+    return window_rect.left   <= monitor_rect.left
+        && window_rect.top    <= monitor_rect.top
+        && window_rect.right  >= monitor_rect.right
+        && window_rect.bottom >= monitor_rect.bottom;
+}
+
+bool FullscreenDetector::IsShellWindow(HWND window_handle) {
+    if(window_handle == GetShellWindow() || window_handle == GetDesktopWindow()) {
+        return true;
+    }
+
+    // WorkerW hosts the wallpaper once the desktop has been shown through Win+D.
+    wchar_t class_name[257];
+    const qint32& class_name_length { GetClassNameW(window_handle, class_name, 257) };
+    const QStringView& class_name_view { class_name, class_name_length };
+
+    return class_name_view == u"Progman" || class_name_view == u"WorkerW" || class_name_view == u"Shell_TrayWnd" || class_name_view == u"Shell_SecondaryTrayWnd";
+}
+
+bool FullscreenDetector::Update(HWND window_handle) {
+    if(window_handle != window) {
+        window = window_handle;
+        shellWindow = window_handle != nullptr && IsShellWindow(window_handle);
+    }
+
+    bool now_fullscreen { false };
+
+    if(window_handle != nullptr && !shellWindow && IsWindowVisible(window_handle) && !IsIconic(window_handle)) {
+        const LONG_PTR& style { GetWindowLongPtrW(window_handle, GWL_STYLE) };
+        RECT window_rect, monitor_rect;
+
+        now_fullscreen = (style & WS_CAPTION) != WS_CAPTION
+                && GetWindowRect(window_handle, &window_rect)
+                && getMonitorRect(MonitorFromWindow(window_handle, MONITOR_DEFAULTTONEAREST), monitor_rect)
+                && Covers(window_rect, monitor_rect);
+    }
+
+    if(now_fullscreen == fullscreen) {
+        return false;
+    }
+
+    fullscreen = now_fullscreen;
+    return true;
+}
+
+bool FullscreenDetector::IsFullscreen() const {
+    return fullscreen;
+}
+
+HWND FullscreenDetector::GetWindow() const {
+    return window;
+}
+
+void FullscreenDetector::InvalidateMonitors() {
+    monitorRects.clear();
+}
+
+FullscreenDetector::FullscreenDetector()
+    :
+      monitorRects    {         },
+      window          { nullptr },
+      shellWindow     { false   },
+      fullscreen      { false   }
+{
+
+}
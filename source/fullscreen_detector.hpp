@@ -0,0 +1,48 @@
+#ifndef FULLSCREEN_DETECTOR_HPP
+#define FULLSCREEN_DETECTOR_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QHash>
+
+/* Tells whether the foreground window covers a whole monitor, as exclusive fullscreen and borderless
+ * windowed games do. It's driven by the foreground and geometry events of ForegroundWindowWatcher
+ * rather than by polling: an update costs one GetWindowRect and GetWindowLong, as the monitor
+ * rectangles are cached until the display layout changes, and whether the window belongs to the
+ * shell is only looked up when the foreground window changes. Maximized windows cover their monitor
+ * as well, but keep their caption, which is what tells them apart from borderless ones.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class FullscreenDetector {
+protected:
+    QHash<HMONITOR, RECT>    monitorRects;    // Cleared by InvalidateMonitors, as monitor handles are reused across layout changes.
+    HWND                     window;
+    bool                     shellWindow;     // The desktop and the taskbar cover their monitor too, but are never a game.
+    bool                     fullscreen;
+
+    bool                     getMonitorRect(HMONITOR monitor_handle, RECT& out_rect);
+
+public:
+    static bool              Covers(const RECT& window_rect, const RECT& monitor_rect);
+    static bool              IsShellWindow(HWND window_handle);
+
+    bool                     Update(HWND window_handle);    // Re-checks the given foreground window; returns whether IsFullscreen changed.
+    bool                     IsFullscreen() const;
+    HWND                     GetWindow() const;
+    void                     InvalidateMonitors();          // Call on WM_DISPLAYCHANGE, then Update the foreground window again.
+
+    FullscreenDetector();
+};
+
+#endif // FULLSCREEN_DETECTOR_HPP
@@ -0,0 +1,167 @@
+#include "hotkey_registry.hpp"
+#include "low_level_keyboard_hook.hpp"
+
+#include <QtCore/QtDebug>
+
+const QMap<QString, HOTKEY_ACTION> HotkeyRegistry::ActionResolverSTOA = {
+    { "toggle"      , HOTKEY_ACTION::TOGGLE_LOCK  },
+    { "force_lock"  , HOTKEY_ACTION::FORCE_LOCK   },
+    { "force_unlock", HOTKEY_ACTION::FORCE_UNLOCK },
+    { "mute"        , HOTKEY_ACTION::TOGGLE_MUTE  },
+    { "reclip"      , HOTKEY_ACTION::RECLIP       }
+};
+
+const QMap<HOTKEY_ACTION, QString> HotkeyRegistry::ActionResolverATOS = {
+    { HOTKEY_ACTION::TOGGLE_LOCK , "toggle"       },
+    { HOTKEY_ACTION::FORCE_LOCK  , "force_lock"   },
+    { HOTKEY_ACTION::FORCE_UNLOCK, "force_unlock" },
+    { HOTKEY_ACTION::TOGGLE_MUTE , "mute"         },
+    { HOTKEY_ACTION::RECLIP      , "reclip"       }
+};
+
+void HotkeyRegistry::SetWindowHandle(HWND window_handle) {
+    UnregisterAll();
+    windowHandle = window_handle;
+}
+
+void HotkeyRegistry::SetLowLevelHook(LowLevelKeyboardHook* low_level_hook) {
+    const auto bindings { bindingTable };
+
+    UnregisterAll();
+    lowLevelHook = low_level_hook;
+
+    // Every configured binding moves, not only the registered ones: a key another application holds is exactly what the hook can still catch.
+    for(quint8 i { 0 }; i < static_cast<quint8>(HOTKEY_ACTION::COUNT); ++i) {
+        if(bindings[i].Vkid) {
+            Register(static_cast<HOTKEY_ACTION>(i), bindings[i].Modifiers, bindings[i].Vkid);
+        }
+    }
+}
+
+bool HotkeyRegistry::Register(HOTKEY_ACTION action, quint32 modifiers, quint32 vkid) {
+    if(action >= HOTKEY_ACTION::COUNT) {
+        return false;
+    }
+
+    Unregister(action);
+
+    Binding& binding { bindingTable[static_cast<size_t>(action)] };
+    binding.Modifiers = modifiers;
+    binding.Vkid = vkid;
+
+    if(!vkid) {
+        return false;
+    }
+
+    if(lowLevelHook != nullptr) {
+        lowLevelHook->SetBinding(vkid, modifiers, action);
+        binding.Registered = true;
+
+        qInfo() << "Bound action"
+                << ActionResolverATOS.value(action)
+                << "to VKID 0x" << QString::number(vkid, 16)
+                << "with modifiers" << QString::number(modifiers)
+                << "in the low-level keyboard hook.";
+
+        return true;
+    }
+
+    if(windowHandle == nullptr) {
+        return false;
+    }
+
+    binding.Registered = RegisterHotKey(windowHandle, GetHotkeyId(action), MOD_NOREPEAT | modifiers, vkid);
+
+    qInfo() << "RegisterHotKey(HWND(winId), 0x"
+            << QString::number(GetHotkeyId(action), 16)
+            << ", MOD_NOREPEAT | "
+            << QString::number(modifiers)
+            << ", 0x"
+            << QString::number(vkid, 16)
+            << ") for action"
+            << ActionResolverATOS.value(action)
+            << "returned"
+            << (binding.Registered ? "true" : "false");
+
+    return binding.Registered;
+}
+
+bool HotkeyRegistry::Unregister(HOTKEY_ACTION action) {
+    if(action >= HOTKEY_ACTION::COUNT) {
+        return false;
+    }
+
+    Binding& binding { bindingTable[static_cast<size_t>(action)] };
+    const quint32 vkid { binding.Vkid };
+
+    // Forgotten even if it never registered, so that SetLowLevelHook doesn't bring back a binding that was meant to be gone.
+    binding.Vkid = 0x00;
+
+    if(!binding.Registered) {
+        return false;
+    }
+
+    binding.Registered = false;
+
+    if(lowLevelHook != nullptr) {
+        lowLevelHook->ClearBinding(vkid, action);
+        return true;
+    }
+
+    const BOOL& result { UnregisterHotKey(windowHandle, GetHotkeyId(action)) };
+
+    if(result) {
+        qInfo() << "UnregisterHotKey(HWND(winId), 0x"
+                << QString::number(GetHotkeyId(action), 16)
+                << ") returned true";
+    }
+
+    return result;
+}
+
+void HotkeyRegistry::UnregisterAll() {
+    for(quint8 i { 0 }; i < static_cast<quint8>(HOTKEY_ACTION::COUNT); ++i) {
+        Unregister(static_cast<HOTKEY_ACTION>(i));
+    }
+}
+
+const HotkeyRegistry::Binding& HotkeyRegistry::GetBinding(HOTKEY_ACTION action) const {
+    return bindingTable[static_cast<size_t>(action)];
+}
+
+qint32 HotkeyRegistry::GetHotkeyId(HOTKEY_ACTION action) const {
+    return baseHotkeyId + static_cast<qint32>(action);
+}
+
+HOTKEY_ACTION HotkeyRegistry::Resolve(WPARAM w_param, LPARAM l_param) const {
+    /* Unsigned subtraction folds both bounds checks into one; any ID below baseHotkeyId wraps
+     * around to a value larger than the table. The VKID is located in the high word of lParam.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    const size_t& table_index { static_cast<size_t>(w_param) - static_cast<size_t>(baseHotkeyId) };
+
+    if(table_index >= bindingTable.size()) {
+        return HOTKEY_ACTION::NOTHING;
+    }
+
+    const Binding& binding { bindingTable[table_index] };
+
+    if(!binding.Registered || ((l_param >> 16) & 0xFF) != binding.Vkid) {
+        return HOTKEY_ACTION::NOTHING;
+    }
+
+    return static_cast<HOTKEY_ACTION>(table_index);
+}
+
+HotkeyRegistry::HotkeyRegistry(qint32 base_hotkey_id)
+    :
+      windowHandle    { nullptr        },
+      lowLevelHook    { nullptr        },
+      baseHotkeyId    { base_hotkey_id },
+      bindingTable    {                }
+{
+
+}
+
+HotkeyRegistry::~HotkeyRegistry() {
+    UnregisterAll();
+}
@@ -0,0 +1,73 @@
+#ifndef HOTKEY_REGISTRY_HPP
+#define HOTKEY_REGISTRY_HPP
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QString>
+#include <QtCore/QMap>
+#include <QtCore/QMetaType>
+
+#include <array>
+
+/* Every action that a global hotkey can be bound to. The underlying value doubles as the
+ * offset from the registry's base hotkey ID, and as the index into its binding table.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+enum struct HOTKEY_ACTION : quint8 {
+    TOGGLE_LOCK     =   0,
+    FORCE_LOCK      =   1,
+    FORCE_UNLOCK    =   2,
+    TOGGLE_MUTE     =   3,
+    RECLIP          =   4,
+
+    COUNT,
+    NOTHING         =   0xFF
+};
+
+Q_DECLARE_METATYPE(HOTKEY_ACTION)
+
+class LowLevelKeyboardHook;
+
+class HotkeyRegistry {
+public:
+    struct Binding {
+        quint32    Modifiers;     // WinApi modifier bitmask (MOD_ALT, MOD_CONTROL, ...) excluding MOD_NOREPEAT.
+        quint32    Vkid;          // Virtual key ID of the bound key, or 0x00 if the binding is unused.
+        bool       Registered;    // Whether RegisterHotKey succeeded for this binding, or it was handed to the low-level hook.
+    };
+
+    static const QMap<QString, HOTKEY_ACTION>    ActionResolverSTOA;
+    static const QMap<HOTKEY_ACTION, QString>    ActionResolverATOS;
+
+protected:
+    HWND                     windowHandle;         // The window that receives the WM_HOTKEY messages.
+    LowLevelKeyboardHook*    lowLevelHook;         // When set, bindings are handed to the hook instead of RegisterHotKey.
+    const qint32             baseHotkeyId;         // The hotkey ID of HOTKEY_ACTION::TOGGLE_LOCK; every other action is registered at baseHotkeyId + action.
+
+    std::array<Binding, static_cast<size_t>(HOTKEY_ACTION::COUNT)> bindingTable;
+
+public:
+    void             SetWindowHandle(HWND window_handle);
+    void             SetLowLevelHook(LowLevelKeyboardHook* low_level_hook);    // Moves every binding over to the given hook, or back to RegisterHotKey if nullptr.
+
+    bool             Register(HOTKEY_ACTION action, quint32 modifiers, quint32 vkid);    // Replaces any existing binding for the action.
+    bool             Unregister(HOTKEY_ACTION action);    // Also forgets the binding, so that SetLowLevelHook won't carry it over.
+    void             UnregisterAll();
+
+    const Binding&   GetBinding(HOTKEY_ACTION action) const;
+    qint32           GetHotkeyId(HOTKEY_ACTION action) const;
+
+    /* Maps the wParam/lParam pair of a WM_HOTKEY message back to the action it was registered for,
+     * with a single bounds check and table lookup. Returns HOTKEY_ACTION::NOTHING if the ID isn't
+     * owned by this registry, or if the VKID in lParam doesn't match the binding.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    HOTKEY_ACTION    Resolve(WPARAM w_param, LPARAM l_param) const;
+
+    explicit HotkeyRegistry(qint32 base_hotkey_id);
+    ~HotkeyRegistry();
+};
+
+#endif // HOTKEY_REGISTRY_HPP
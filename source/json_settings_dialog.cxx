@@ -1,18 +1,24 @@
 #include "json_settings_dialog.hxx"
 #include "ui_json_settings_dialog.h"
 
+#include <QtCore/QJsonArray>
+
 const QMap<qint32, QString> JsonSettingsDialog::ActivationMethodResolverITOS = {
-    { 0, ""       },
-    { 1, "hotkey" },
-    { 2, "image"  },
-    { 3, "title"  }
+    { 0, ""           },
+    { 1, "hotkey"     },
+    { 2, "image"      },
+    { 3, "title"      },
+    { 4, "rule"       },
+    { 5, "fullscreen" }
 };
 
 const QMap<QString, qint32> JsonSettingsDialog::ActivationMethodResolverSTOI = {
-    { ""      , 0 },
-    { "hotkey", 1 },
-    { "image" , 2 },
-    { "title" , 3 }
+    { ""          , 0 },
+    { "hotkey"    , 1 },
+    { "image"     , 2 },
+    { "title"     , 3 },
+    { "rule"      , 4 },
+    { "fullscreen", 5 }
 };
 
 qsizetype JsonSettingsDialog::JsonSettings::LoadFromFile(const QString& path, QWidget* calling_widget) {
@@ -23,9 +29,32 @@ qsizetype JsonSettingsDialog::JsonSettings::LoadFromFile(const QString& path, QW
         return -1;
     }
 
-    const QByteArray&       json_file_bytes    { json_file.readAll()                      };
-    const QJsonDocument&    json_document      { QJsonDocument::fromJson(json_file_bytes) };
-    const QJsonObject&      json_object        { json_document.object()                   };
+    if(json_file.size() > MaxFileSize) {
+        if(calling_widget != nullptr) QMessageBox::critical(calling_widget, "JSON File Too Large!", QString { "The JSON file is %1 bytes large, while settings files are limited to %2 bytes. File path: \"%3\"" }.arg(json_file.size()).arg(MaxFileSize).arg(path));
+        return -2;
+    }
+
+    QJsonParseError json_parse_error;
+
+    const QByteArray&       json_file_bytes    { json_file.readAll()                                         };
+    const QJsonDocument&    json_document      { QJsonDocument::fromJson(json_file_bytes, &json_parse_error) };
+    const QJsonObject&      json_object        { json_document.object()                                      };
+
+    if(json_parse_error.error != QJsonParseError::NoError || !json_document.isObject()) {
+        const QString& parse_error_string { json_parse_error.error != QJsonParseError::NoError ? json_parse_error.errorString() + " at offset " + QString::number(json_parse_error.offset) : "the top-level value isn't an object" };
+        if(calling_widget != nullptr) QMessageBox::critical(calling_widget, "JSON Syntax Error!", "Failed to parse the JSON file, " + parse_error_string + ". File path: \"" + path + "\"");
+        return -3;
+    }
+
+    // Collected rather than shown right away, so that a file with thousands of bad keys can't produce thousands of dialogs.
+    QList<QPair<QString, QString>> problems;
+
+    const auto& report_problem {
+        [&problems](const QString& title, const QString& message) -> void {
+            static constexpr qsizetype max_message_length { 512 };    // Messages quote the offending key or value, which may be arbitrarily long.
+            problems.append({ title, message.size() > max_message_length ? message.left(max_message_length) + "..." : message });
+        }
+    };
 
     const static QString& json_typeerror_title       { "JSON Value Type Error!" };
     const static QString& json_typeerror_message     { "The type of the JSON value \"%1\" isn't a %2! Re-saving with new values should correct this issue."};
@@ -41,6 +70,9 @@ qsizetype JsonSettingsDialog::JsonSettings::LoadFromFile(const QString& path, QW
 
     typedef std::tuple<QString, QString, bool(QJsonValue::*)() const, std::function<void(const QJsonValue&)>> JsonKeyHandlerTuple_t;
 
+    // Keys that were added after the initial release, which keep their default value when absent instead of producing a warning.
+    const static QStringList& optional_json_keys { "action_hotkeys", "key_sequences", "low_level_hook", "clip", "fullscreen_exclusions" };
+
     const auto& apply_handlers_to_object {
         [&] (const QList<JsonKeyHandlerTuple_t>& json_key_handlers, const QJsonObject& json_object) -> void {
             QList<const JsonKeyHandlerTuple_t*> used_key_handlers;
@@ -75,26 +107,63 @@ qsizetype JsonSettingsDialog::JsonSettings::LoadFromFile(const QString& path, QW
 
                     // The call to mfptr_type_checker returned false, so object_value is of a type incompatible with lambda_value_handler.
                     else {
-                        if(calling_widget != nullptr) QMessageBox::warning(calling_widget, json_typeerror_title, json_typeerror_message.arg(object_key, expected_type_name));
+                        report_problem(json_typeerror_title, json_typeerror_message.arg(object_key, expected_type_name));
                     }
                 }
 
                 // No matching handler was found, the object_key is unknown.
                 else {
-                    if(calling_widget != nullptr) QMessageBox::warning(calling_widget, json_unknownkey_title, json_unknownkey_message.arg(object_key));
+                    report_problem(json_unknownkey_title, json_unknownkey_message.arg(object_key));
                 }
             }
 
             // Iterate through json_key_handlers to ensure that all handlers were utilized, meaning all expected JSON keys were accounted for.
             for(const JsonKeyHandlerTuple_t& key_handler : json_key_handlers) {
-                // Show a warning if a key wasn't handled and is therefore missing from the JSON file.
-                if(!used_key_handlers.contains(&key_handler)) {
-                    if(calling_widget != nullptr) QMessageBox::warning(calling_widget, json_keyerror_title, json_keyerror_message.arg(std::get<0>(key_handler)));
+                // Show a warning if a key wasn't handled and is therefore missing from the JSON file, unless the key is optional.
+                if(!used_key_handlers.contains(&key_handler) && !optional_json_keys.contains(std::get<0>(key_handler))) {
+                    report_problem(json_keyerror_title, json_keyerror_message.arg(std::get<0>(key_handler)));
                 }
             }
         }
     };
 
+    // Builds the key handlers of a shortcut object, which is shared by "shortcut" and every entry in "action_hotkeys".
+    const auto& make_shortcut_key_handlers {
+        [&] (const QString& key_path, QString& out_vkid, quint32& out_modifier_bitmask) -> QList<JsonKeyHandlerTuple_t> {
+            return {
+                {"vkid", "string", &QJsonValue::isString, [&, key_path](const QJsonValue& value) -> void {
+                        const QString& vkid_string { value.toString() };
+
+                        if(vkid_string.size()) {
+                            quint32 vkid { 0 };
+
+                            if(VkidTable::ParseVkid(vkid_string, vkid)) {
+                                out_vkid = QString::fromLatin1(VkidTable::ToHexString(vkid));
+                            } else {
+                                report_problem(json_valueerror_title, json_valueerror_message.arg(key_path + "/vkid", vkid_string, "cannot interpret value as a VKID, are you sure it's valid hexadecimal or a VK_ name?"));
+                            }
+                        }
+                    }},
+
+                {"modifier_alt", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
+                        out_modifier_bitmask |= (WINMOD_ALT * value.toBool());
+                    }},
+
+                {"modifier_control", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
+                        out_modifier_bitmask |= (WINMOD_CONTROL * value.toBool());
+                    }},
+
+                {"modifier_shift", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
+                        out_modifier_bitmask |= (WINMOD_SHIFT * value.toBool());
+                    }},
+
+                {"modifier_win", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
+                        out_modifier_bitmask |= (WINMOD_WIN * value.toBool());
+                    }},
+            };
+        }
+    };
+
     const QList<JsonKeyHandlerTuple_t>& json_key_handler_tuples {
         {"image", "string", &QJsonValue::isString, [&](const QJsonValue& value) -> void {
                 ProcessImageName = value.toString();
@@ -104,14 +173,22 @@ qsizetype JsonSettingsDialog::JsonSettings::LoadFromFile(const QString& path, QW
                 ForegroundWindowTitle = value.toString();
             }},
 
+        {"rule", "string", &QJsonValue::isString, [&](const QJsonValue& value) -> void {
+                RuleExpression = value.toString();
+            }},
+
+        {"fullscreen_exclusions", "string", &QJsonValue::isString, [&](const QJsonValue& value) -> void {
+                FullscreenExclusions = value.toString();
+            }},
+
         {"method", "string", &QJsonValue::isString, [&](const QJsonValue& value) -> void {
-                static const QStringList valid_values { "", "title", "image", "hotkey" };
+                static const QStringList valid_values { "", "title", "image", "hotkey", "rule", "fullscreen" };
                 const QString& value_string { value.toString() };
 
                 if(valid_values.contains(value_string)) {
                     ActivationMethod = value_string;
                 } else {
-                    if(calling_widget != nullptr) QMessageBox::warning(calling_widget, json_valueerror_title, json_valueerror_message.arg("method", value_string, "value must be one of: \"title\", \"image\", \"hotkey\". "));
+                    report_problem(json_valueerror_title, json_valueerror_message.arg("method", value_string, "value must be one of: \"title\", \"image\", \"hotkey\", \"rule\", \"fullscreen\". "));
                 }
             }},
 
@@ -123,46 +200,130 @@ qsizetype JsonSettingsDialog::JsonSettings::LoadFromFile(const QString& path, QW
                 InitialMuteState = value.toBool();
             }},
 
+        {"low_level_hook", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
+                LowLevelHook = value.toBool();
+            }},
+
         {"shortcut", "object", &QJsonValue::isObject, [&](const QJsonValue& value) -> void {
-                const QList<JsonKeyHandlerTuple_t>& shortcut_key_handler_tuples {
-                    {"vkid", "string", &QJsonValue::isString, [&](const QJsonValue& value) -> void {
-                            const QString& vkid_string { value.toString() };
-
-                            if(vkid_string.size()) {
-                                bool success { false };
-                                const quint32& vkid { vkid_string.toUInt(&success, 16) };
-
-                                if(success) {
-                                    HotkeyVkid = QString { "0x%1" }.arg(vkid, 2, 16, QChar { '0' });
-                                } else {
-                                    if(calling_widget != nullptr) QMessageBox::warning(calling_widget, json_valueerror_title, json_valueerror_message.arg("shortcut/vkid", vkid_string, "cannot interpret value as a hexadecimal string, are you sure it's valid hexadecimal?"));
-                                }
+                apply_handlers_to_object(make_shortcut_key_handlers("shortcut", HotkeyVkid, HotkeyModifierBitmask), value.toObject());
+            }},
+
+        {"action_hotkeys", "object", &QJsonValue::isObject, [&](const QJsonValue& value) -> void {
+                const QJsonObject& action_hotkeys_object { value.toObject() };
+
+                // Every action binding is optional, so the keys are validated here rather than through apply_handlers_to_object.
+                for(const QString& action_name : action_hotkeys_object.keys()) {
+                    const QJsonValue& binding_value { action_hotkeys_object[action_name] };
+
+                    if(!HotkeyRegistry::ActionResolverSTOA.contains(action_name)) {
+                        report_problem(json_unknownkey_title, json_unknownkey_message.arg("action_hotkeys/" + action_name));
+                        continue;
+                    }
+
+                    if(!binding_value.isObject()) {
+                        report_problem(json_typeerror_title, json_typeerror_message.arg("action_hotkeys/" + action_name, "object"));
+                        continue;
+                    }
+
+                    HotkeyBinding& binding { ActionHotkeys[action_name] };
+                    binding.ModifierBitmask = NULL;
+
+                    apply_handlers_to_object(make_shortcut_key_handlers("action_hotkeys/" + action_name, binding.Vkid, binding.ModifierBitmask), binding_value.toObject());
+                }
+            }},
+
+        {"clip", "object", &QJsonValue::isObject, [&](const QJsonValue& value) -> void {
+                const QList<JsonKeyHandlerTuple_t>& clip_key_handlers {
+                    {"region", "string", &QJsonValue::isString, [&](const QJsonValue& value) -> void {
+                            const QString& region_string { value.toString() };
+
+                            if(ClipPolicy::RegionResolverSTOR.contains(region_string)) {
+                                Clip.Region = ClipPolicy::RegionResolverSTOR.value(region_string);
+                            } else {
+                                report_problem(json_valueerror_title, json_valueerror_message.arg("clip/region", region_string, "value must be one of: \"window\", \"client\", \"monitor\". "));
                             }
                         }},
 
-                    {"modifier_alt", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
-                            HotkeyModifierBitmask |= (WINMOD_ALT * value.toBool());
-                        }},
+                    {"insets", "array", &QJsonValue::isArray, [&](const QJsonValue& value) -> void {
+                            const QJsonArray& insets_array { value.toArray() };
 
-                    {"modifier_control", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
-                            HotkeyModifierBitmask |= (WINMOD_CONTROL * value.toBool());
+                            if(insets_array.size() == 4 && std::all_of(insets_array.begin(), insets_array.end(), [](const QJsonValue& inset) { return inset.isDouble() && inset.toInt(-1) >= 0; })) {
+                                Clip.Insets = QMargins { insets_array[0].toInt(), insets_array[1].toInt(), insets_array[2].toInt(), insets_array[3].toInt() };
+                            } else {
+                                report_problem(json_valueerror_title, json_valueerror_message.arg("clip/insets", QJsonDocument { insets_array }.toJson(QJsonDocument::Compact), "value must be four non-negative integers: [left, top, right, bottom]."));
+                            }
                         }},
 
-                    {"modifier_shift", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
-                            HotkeyModifierBitmask |= (WINMOD_SHIFT * value.toBool());
+                    {"aspect_ratio", "string", &QJsonValue::isString, [&](const QJsonValue& value) -> void {
+                            const QString& aspect_string { value.toString() };
+                            const QStringList& aspect_parts { aspect_string.split(':') };
+
+                            bool width_ok { false }, height_ok { false };
+                            const quint32& aspect_width  { aspect_parts.size() == 2 ? aspect_parts[0].toUInt(&width_ok)  : 0 };
+                            const quint32& aspect_height { aspect_parts.size() == 2 ? aspect_parts[1].toUInt(&height_ok) : 0 };
+
+                            if(aspect_string.isEmpty() || (width_ok && height_ok)) {
+                                Clip.AspectWidth = aspect_width;
+                                Clip.AspectHeight = aspect_height;
+                            } else {
+                                report_problem(json_valueerror_title, json_valueerror_message.arg("clip/aspect_ratio", aspect_string, "value must either be empty, or be of the form \"16:9\"."));
+                            }
                         }},
 
-                    {"modifier_win", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
-                            HotkeyModifierBitmask |= (WINMOD_WIN * value.toBool());
+                    {"dpi_scaling", "boolean", &QJsonValue::isBool, [&](const QJsonValue& value) -> void {
+                            Clip.ScaleWithDpi = value.toBool();
                         }},
                 };
 
-                apply_handlers_to_object(shortcut_key_handler_tuples, value.toObject());
+                apply_handlers_to_object(clip_key_handlers, value.toObject());
+            }},
+
+        {"key_sequences", "object", &QJsonValue::isObject, [&](const QJsonValue& value) -> void {
+                const QJsonObject& key_sequences_object { value.toObject() };
+
+                for(const QString& action_name : key_sequences_object.keys()) {
+                    const QJsonValue& sequence_value { key_sequences_object[action_name] };
+
+                    if(!HotkeyRegistry::ActionResolverSTOA.contains(action_name)) {
+                        report_problem(json_unknownkey_title, json_unknownkey_message.arg("key_sequences/" + action_name));
+                        continue;
+                    }
+
+                    if(!sequence_value.isString()) {
+                        report_problem(json_typeerror_title, json_typeerror_message.arg("key_sequences/" + action_name, "string"));
+                        continue;
+                    }
+
+                    KeySequenceTrie::Sequence sequence;
+                    QString parse_error;
+
+                    if(sequence_value.toString().isEmpty() || KeySequenceTrie::ParseSequence(sequence_value.toString(), sequence, &parse_error)) {
+                        KeySequences[action_name] = sequence_value.toString();
+                    } else {
+                        report_problem(json_valueerror_title, json_valueerror_message.arg("key_sequences/" + action_name, sequence_value.toString(), parse_error));
+                    }
+                }
             }},
     };
 
     apply_handlers_to_object(json_key_handler_tuples, json_object);
 
+    if(calling_widget != nullptr && problems.size() == 1) {
+        QMessageBox::warning(calling_widget, problems.first().first, problems.first().second);
+    } else if(calling_widget != nullptr && problems.size() > 1) {
+        QStringList problem_lines;
+
+        for(qsizetype i { 0 }; i < qMin(problems.size(), MaxReportedProblems); ++i) {
+            problem_lines.append("- " + problems.at(i).first + " " + problems.at(i).second);
+        }
+
+        if(problems.size() > MaxReportedProblems) {
+            problem_lines.append(QString { "... and %1 more." }.arg(problems.size() - MaxReportedProblems));
+        }
+
+        QMessageBox::warning(calling_widget, "JSON Settings Problems!", problem_lines.join("\n\n"));
+    }
+
     return json_file_bytes.size();
 }
 
@@ -178,20 +339,55 @@ qsizetype JsonSettingsDialog::JsonSettings::SaveToFile(const QString& path, QWid
 
     json_object["image"]  = ProcessImageName;
     json_object["title"]  = ForegroundWindowTitle;
+    json_object["rule"]   = RuleExpression;
+    json_object["fullscreen_exclusions"] = FullscreenExclusions;
     json_object["mute"]   = InitialMuteState;
+
+    json_object["low_level_hook"] = LowLevelHook;
     json_object["method"] = ActivationMethod;
 
     json_object["stylesheet_path"] = StylesheetPath;
 
-    QJsonObject shortcut_object;
+    const auto& make_shortcut_object {
+        [](const QString& vkid, const quint32& modifier_bitmask) -> QJsonObject {
+            QJsonObject shortcut_object;
+
+            shortcut_object["vkid"]               = vkid;
+            shortcut_object["modifier_alt"]       = static_cast<bool>(modifier_bitmask & WINMOD_ALT);
+            shortcut_object["modifier_control"]   = static_cast<bool>(modifier_bitmask & WINMOD_CONTROL);
+            shortcut_object["modifier_shift"]     = static_cast<bool>(modifier_bitmask & WINMOD_SHIFT);
+            shortcut_object["modifier_win"]       = static_cast<bool>(modifier_bitmask & WINMOD_WIN);
+
+            return shortcut_object;
+        }
+    };
+
+    json_object["shortcut"] = make_shortcut_object(HotkeyVkid, HotkeyModifierBitmask);
+
+    QJsonObject action_hotkeys_object;
+
+    for(auto iterator { ActionHotkeys.cbegin() }; iterator != ActionHotkeys.cend(); ++iterator) {
+        action_hotkeys_object[iterator.key()] = make_shortcut_object(iterator.value().Vkid, iterator.value().ModifierBitmask);
+    }
+
+    json_object["action_hotkeys"] = action_hotkeys_object;
+
+    QJsonObject key_sequences_object;
+
+    for(auto iterator { KeySequences.cbegin() }; iterator != KeySequences.cend(); ++iterator) {
+        key_sequences_object[iterator.key()] = iterator.value();
+    }
 
-    shortcut_object["vkid"]               = HotkeyVkid;
-    shortcut_object["modifier_alt"]       = static_cast<bool>(HotkeyModifierBitmask & WINMOD_ALT);
-    shortcut_object["modifier_control"]   = static_cast<bool>(HotkeyModifierBitmask & WINMOD_CONTROL);
-    shortcut_object["modifier_shift"]     = static_cast<bool>(HotkeyModifierBitmask & WINMOD_SHIFT);
-    shortcut_object["modifier_win"]       = static_cast<bool>(HotkeyModifierBitmask & WINMOD_WIN);
+    json_object["key_sequences"] = key_sequences_object;
 
-    json_object["shortcut"] = shortcut_object;
+    QJsonObject clip_object;
+
+    clip_object["region"]          = ClipPolicy::RegionResolverRTOS.value(Clip.Region);
+    clip_object["insets"]          = QJsonArray { Clip.Insets.left(), Clip.Insets.top(), Clip.Insets.right(), Clip.Insets.bottom() };
+    clip_object["aspect_ratio"]    = Clip.AspectWidth && Clip.AspectHeight ? QString::number(Clip.AspectWidth) + ":" + QString::number(Clip.AspectHeight) : QString {};
+    clip_object["dpi_scaling"]     = Clip.ScaleWithDpi;
+
+    json_object["clip"] = clip_object;
 
     QJsonDocument    json_document    { json_object                                               };
     QByteArray       json_bytes       { json_document.toJson(QJsonDocument::JsonFormat::Indented) };
@@ -210,7 +406,8 @@ qsizetype JsonSettingsDialog::JsonSettings::SaveToFile(const QString& path, QWid
 JsonSettingsDialog::JsonSettings::JsonSettings()
     :
       HotkeyModifierBitmask    { NULL  },
-      InitialMuteState         { false }
+      InitialMuteState         { false },
+      LowLevelHook             { false }
 {
 
 }
@@ -225,6 +422,7 @@ void JsonSettingsDialog::loadUiSettingsFromJsonFile() {
         ui->leditProcessImageName->setText(json_settings.ProcessImageName);
         ui->leditKeyboardShortcut->setText(json_settings.HotkeyVkid);
         ui->cbMuted->setChecked(json_settings.InitialMuteState);
+        ui->cbLowLevelHook->setChecked(json_settings.LowLevelHook);
         ui->leditStylesheetPath->setText(json_settings.StylesheetPath);
 
         hotkeyModifierList->SetModifierCheckStateFromBitmask(json_settings.HotkeyModifierBitmask);
@@ -237,9 +435,16 @@ void JsonSettingsDialog::loadUiSettingsFromJsonFile() {
 
 void JsonSettingsDialog::saveUiSettingsToJsonFile() {
     JsonSettings json_settings;
+
+    // Silently load the existing file first, so that settings without a widget in this dialog (e.g. action_hotkeys) survive the save.
+    if(QFileInfo::exists(jsonConfigFilePath)) {
+        json_settings.LoadFromFile(jsonConfigFilePath);
+    }
+
     json_settings.ProcessImageName = ui->leditProcessImageName->text();
     json_settings.ForegroundWindowTitle = ui->leditForegroundWindowTitle->text();
     json_settings.InitialMuteState = ui->cbMuted->isChecked();
+    json_settings.LowLevelHook = ui->cbLowLevelHook->isChecked();
 
     const qint32& activation_method_index { ui->cbxActivationMethod->currentIndex() };
 
@@ -255,15 +460,15 @@ void JsonSettingsDialog::saveUiSettingsToJsonFile() {
     QJsonObject shortcut_object;
 
     const QString& vkid_string { ui->leditKeyboardShortcut->text() };
+    json_settings.HotkeyVkid.clear();
 
     if(vkid_string.size()) {
-        bool conversion_success { false };
-        vkid_string.toUInt(&conversion_success, 16);
+        quint32 vkid { 0 };
 
-        if(conversion_success) {
-            json_settings.HotkeyVkid = vkid_string;
+        if(VkidTable::ParseVkid(vkid_string, vkid)) {
+            json_settings.HotkeyVkid = QString::fromLatin1(VkidTable::ToHexString(vkid));
         } else {
-            QMessageBox::critical(this, "JSON Value Error!", "Cannot convert the VKID field from a hexadecimal string to an integer. Cannot continue saving. Are you sure it's valid hexadecimal?");
+            QMessageBox::critical(this, "JSON Value Error!", "Cannot convert the VKID field to a virtual key ID. Cannot continue saving. Are you sure it's valid hexadecimal or a VK_ name?");
             return;
         }
     }
@@ -315,10 +520,10 @@ JsonSettingsDialog::JsonSettingsDialog(const QString& json_config_file_path, QWi
 
     // QSS Stylesheet
     // ----------------------------------------------------------------------------------------------------
-    connect(ui->leditForegroundWindowTitle,    &QLineEdit::textChanged, [&]() -> void { style()->polish(ui->leditForegroundWindowTitle); });
-    connect(ui->leditKeyboardShortcut,         &QLineEdit::textChanged, [&]() -> void { style()->polish(ui->leditKeyboardShortcut);      });
-    connect(ui->leditProcessImageName,         &QLineEdit::textChanged, [&]() -> void { style()->polish(ui->leditProcessImageName);      });
-    connect(ui->leditStylesheetPath,           &QLineEdit::textChanged, [&]() -> void { style()->polish(ui->leditStylesheetPath);        });
+    StylesheetCache::RepolishOnEmptinessChange(ui->leditForegroundWindowTitle);
+    StylesheetCache::RepolishOnEmptinessChange(ui->leditKeyboardShortcut);
+    StylesheetCache::RepolishOnEmptinessChange(ui->leditProcessImageName);
+    StylesheetCache::RepolishOnEmptinessChange(ui->leditStylesheetPath);
 
     QFileInfo file_info { json_config_file_path };
     jsonConfigFilePath = file_info.absoluteFilePath();
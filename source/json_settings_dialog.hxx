@@ -18,6 +18,11 @@
 #include <tuple>
 
 #include "keyboard_modifier_list_widget.hpp"
+#include "hotkey_registry.hpp"
+#include "key_sequence_matcher.hpp"
+#include "vkid_table.hpp"
+#include "clip_geometry.hpp"
+#include "stylesheet_cache.hpp"
 
 namespace Ui {
     class JsonSettingsDialog;
@@ -27,15 +32,34 @@ class JsonSettingsDialog : public QDialog {
 Q_OBJECT
 
 public:
+    struct HotkeyBinding {
+        QString Vkid;
+        quint32 ModifierBitmask;
+    };
+
     struct JsonSettings {
         QString ForegroundWindowTitle;
         QString ProcessImageName;
+        QString RuleExpression;    // A rule expression for the rule method; see ActivationRule for the syntax.
+        QString FullscreenExclusions;    // Comma separated image names whose fullscreen windows the fullscreen method ignores.
         QString HotkeyVkid;
         QString ActivationMethod;
         QString StylesheetPath;
         quint32 HotkeyModifierBitmask;
         bool    InitialMuteState;
+        bool    LowLevelHook;
+
+        QMap<QString, HotkeyBinding> ActionHotkeys;    // Additional global hotkeys, keyed by HotkeyRegistry::ActionResolverSTOA action names.
+        QMap<QString, QString>       KeySequences;     // Key sequences such as "Ctrl+K, L", keyed by action name; require the low-level hook.
+        ClipPolicy                   Clip;             // Which part of the target window the cursor is clipped to.
+
+        static constexpr qint64      MaxFileSize          { 1024 * 1024 };    // Far beyond any real settings file; anything larger is rejected before it's read.
+        static constexpr qsizetype   MaxReportedProblems  { 8 };              // Problems beyond this are summarized, rather than each getting its own line.
 
+        /* Returns the number of bytes read, -1 on I/O errors, -2 if the file exceeds MaxFileSize, or -3 if it isn't a well-formed
+         * JSON object (which includes nesting deeper than QJsonDocument allows). Problems with individual keys don't fail the load;
+         * they're collected and shown to calling_widget in a single dialog, however many there are.
+         * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
         qsizetype LoadFromFile(const QString& path, QWidget* calling_widget = nullptr);
         qsizetype SaveToFile(const QString& path, QWidget* calling_widget = nullptr) const;
 
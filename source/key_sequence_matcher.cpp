@@ -0,0 +1,245 @@
+#include "key_sequence_matcher.hpp"
+
+#include <QtCore/QStringList>
+
+#include "vkid_table.hpp"
+
+#include <map>
+
+bool KeySequenceTrie::ParseSequence(const QString& sequence_string, Sequence& out_sequence, QString* out_error) {
+    const auto& fail {
+        [&](const QString& error) -> bool {
+            if(out_error != nullptr) *out_error = error;
+            return false;
+        }
+    };
+
+    static const QMap<QString, quint32> modifier_resolver {
+        { "ctrl"   , MOD_CONTROL },
+        { "control", MOD_CONTROL },
+        { "alt"    , MOD_ALT     },
+        { "shift"  , MOD_SHIFT   },
+        { "win"    , MOD_WIN     },
+    };
+
+    out_sequence.clear();
+
+    const QStringList& chord_strings { sequence_string.split(',', Qt::SkipEmptyParts) };
+
+    if(chord_strings.size() > MAX_SEQUENCE_LENGTH) {
+        return fail(QString { "The key sequence has %1 chords, but may have at most %2." }.arg(chord_strings.size()).arg(MAX_SEQUENCE_LENGTH));
+    }
+
+    for(const QString& chord_string : chord_strings) {
+        const QStringList& chord_parts { chord_string.split('+') };
+        Chord chord { 0, 0 };
+
+        for(qsizetype i { 0 }; i < chord_parts.size(); ++i) {
+            const QString& part { chord_parts[i].trimmed() };
+
+            if(i < chord_parts.size() - 1) {
+                if(!modifier_resolver.contains(part.toLower())) {
+                    return fail(QString { "Unknown modifier \"%1\" in chord \"%2\"." }.arg(part, chord_string.trimmed()));
+                }
+
+                chord.Modifiers |= modifier_resolver[part.toLower()];
+                continue;
+            }
+
+            if(!VkidTable::ParseVkid(part, chord.Vkid)) {
+                return fail(QString { "Cannot interpret key \"%1\" in chord \"%2\"." }.arg(part, chord_string.trimmed()));
+            }
+        }
+
+        out_sequence.append(chord);
+    }
+
+    if(out_sequence.isEmpty()) {
+        return fail("The key sequence is empty.");
+    }
+
+    return true;
+}
+
+bool KeySequenceTrie::Compile(const BindingList& bindings, QString* out_error) {
+    const auto& fail {
+        [&](const QString& error) -> bool {
+            symbolTable.fill(0);
+            symbolCount = 0;
+            transitionTable.clear();
+            acceptTable.clear();
+
+            if(out_error != nullptr) *out_error = error;
+            return false;
+        }
+    };
+
+    symbolTable.fill(0);
+    symbolCount = 0;
+
+    // Pass 1: Assign a symbol to every distinct chord, and build the trie with sparse per-node transitions.
+    std::vector<std::map<quint32, quint16>> sparse_transitions(1);
+    std::vector<HOTKEY_ACTION> accept_table { HOTKEY_ACTION::NOTHING };
+
+    for(const QPair<Sequence, HOTKEY_ACTION>& binding : bindings) {
+        if(binding.first.isEmpty()) {
+            return fail("Cannot compile an empty key sequence.");
+        }
+
+        quint16 node { ROOT_NODE };
+
+        for(const Chord& chord : binding.first) {
+            if(chord.Modifiers > 0xF || chord.Vkid == 0 || chord.Vkid > 0xFF) {
+                return fail(QString { "Invalid chord, modifiers 0x%1 VKID 0x%2." }.arg(chord.Modifiers, 0, 16).arg(chord.Vkid, 0, 16));
+            }
+
+            if(accept_table[node] != HOTKEY_ACTION::NOTHING) {
+                return fail("A key sequence starts with another complete key sequence, and can never be reached.");
+            }
+
+            quint8& symbol_entry { symbolTable[chord.Modifiers << 8 | chord.Vkid] };
+
+            if(!symbol_entry) {
+                if(symbolCount == 0xFF) {
+                    return fail("Too many distinct chords across all key sequences.");
+                }
+
+                symbol_entry = static_cast<quint8>(++symbolCount);
+            }
+
+            const quint32& symbol { symbol_entry - 1u };
+            const auto& transition { sparse_transitions[node].find(symbol) };
+
+            if(transition != sparse_transitions[node].end()) {
+                node = transition->second;
+                continue;
+            }
+
+            if(sparse_transitions.size() >= NO_NODE) {
+                return fail("Too many key sequence trie nodes.");
+            }
+
+            const quint16& new_node { static_cast<quint16>(sparse_transitions.size()) };
+
+            sparse_transitions[node][symbol] = new_node;
+            sparse_transitions.emplace_back();
+            accept_table.push_back(HOTKEY_ACTION::NOTHING);
+
+            node = new_node;
+        }
+
+        if(node == ROOT_NODE || accept_table[node] != HOTKEY_ACTION::NOTHING || !sparse_transitions[node].empty()) {
+            return fail("A key sequence is identical to, or a prefix of, another key sequence.");
+        }
+
+        accept_table[node] = binding.second;
+    }
+
+    // Pass 2: Flatten the sparse transitions into a dense table now that the final symbol count is known.
+    transitionTable.assign(sparse_transitions.size() * symbolCount, NO_NODE);
+
+    for(size_t node { 0 }; node < sparse_transitions.size(); ++node) {
+        for(const auto& [symbol, next_node] : sparse_transitions[node]) {
+            transitionTable[node * symbolCount + symbol] = next_node;
+        }
+    }
+
+    acceptTable = std::move(accept_table);
+
+    return true;
+}
+
+quint16 KeySequenceTrie::Step(quint16 node, quint32 modifiers, quint32 vkid) const {
+    if(modifiers > 0xF || vkid > 0xFF || node >= acceptTable.size()) {
+        return NO_NODE;
+    }
+
+    const quint8& symbol_entry { symbolTable[modifiers << 8 | vkid] };
+
+    if(!symbol_entry) {
+        return NO_NODE;
+    }
+
+    return transitionTable[node * symbolCount + symbol_entry - 1];
+}
+
+HOTKEY_ACTION KeySequenceTrie::GetAcceptedAction(quint16 node) const {
+    return node < acceptTable.size() ? acceptTable[node] : HOTKEY_ACTION::NOTHING;
+}
+
+bool KeySequenceTrie::IsEmpty() const {
+    return symbolCount == 0;
+}
+
+quint32 KeySequenceTrie::GetTimeout() const {
+    return timeoutMs;
+}
+
+void KeySequenceTrie::SetTimeout(quint32 timeout_ms) {
+    timeoutMs = timeout_ms;
+}
+
+KeySequenceTrie::KeySequenceTrie()
+    :
+      symbolTable        {      },
+      symbolCount        { 0    },
+      transitionTable    {      },
+      acceptTable        {      },
+      timeoutMs          { 1000 }
+{
+
+}
+
+
+
+void KeySequenceMatcher::SetTrie(const std::shared_ptr<const KeySequenceTrie>& key_sequence_trie) {
+    keySequenceTrie = key_sequence_trie;
+    Reset();
+}
+
+const std::shared_ptr<const KeySequenceTrie>& KeySequenceMatcher::GetTrie() const {
+    return keySequenceTrie;
+}
+
+HOTKEY_ACTION KeySequenceMatcher::Feed(quint32 modifiers, quint32 vkid, quint32 time_ms) {
+    if(keySequenceTrie == nullptr || keySequenceTrie->IsEmpty()) {
+        return HOTKEY_ACTION::NOTHING;
+    }
+
+    if(currentNode != KeySequenceTrie::ROOT_NODE && time_ms - lastKeyTimeMs > keySequenceTrie->GetTimeout()) {
+        currentNode = KeySequenceTrie::ROOT_NODE;
+    }
+
+    lastKeyTimeMs = time_ms;
+
+    quint16 next_node { keySequenceTrie->Step(currentNode, modifiers, vkid) };
+
+    // The key broke the current sequence, but it may still be the first chord of another one.
+    if(next_node == KeySequenceTrie::NO_NODE && currentNode != KeySequenceTrie::ROOT_NODE) {
+        next_node = keySequenceTrie->Step(KeySequenceTrie::ROOT_NODE, modifiers, vkid);
+    }
+
+    if(next_node == KeySequenceTrie::NO_NODE) {
+        currentNode = KeySequenceTrie::ROOT_NODE;
+        return HOTKEY_ACTION::NOTHING;
+    }
+
+    const HOTKEY_ACTION& accepted_action { keySequenceTrie->GetAcceptedAction(next_node) };
+    currentNode = accepted_action == HOTKEY_ACTION::NOTHING ? next_node : KeySequenceTrie::ROOT_NODE;
+
+    return accepted_action;
+}
+
+void KeySequenceMatcher::Reset() {
+    currentNode = KeySequenceTrie::ROOT_NODE;
+    lastKeyTimeMs = 0;
+}
+
+KeySequenceMatcher::KeySequenceMatcher()
+    :
+      keySequenceTrie    { nullptr                     },
+      currentNode        { KeySequenceTrie::ROOT_NODE  },
+      lastKeyTimeMs      { 0                           }
+{
+
+}
@@ -0,0 +1,85 @@
+#ifndef KEY_SEQUENCE_MATCHER_HPP
+#define KEY_SEQUENCE_MATCHER_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "hotkey_registry.hpp"
+
+/* Compiles key sequences such as "Ctrl+K, L" into a trie that is flattened into a transition table.
+ * Every distinct chord (modifier bitmask + VKID) used by any sequence is assigned a symbol index
+ * through a 4096 entry lookup table, so that advancing the trie by one key press is two array reads.
+ * A compiled trie is immutable, and can be shared between the GUI thread and the keyboard hook thread.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class KeySequenceTrie {
+public:
+    struct Chord {
+        quint32 Modifiers;    // WinApi MOD_ALT | MOD_CONTROL | MOD_SHIFT | MOD_WIN bitmask.
+        quint32 Vkid;
+    };
+
+    typedef QList<Chord>                              Sequence;
+    typedef QList<QPair<Sequence, HOTKEY_ACTION>>     BindingList;
+
+    static constexpr quint16 ROOT_NODE    { 0x0000 };
+    static constexpr quint16 NO_NODE      { 0xFFFF };
+
+    // Nobody types more chords than this from memory, and it bounds the transition table, which grows with nodes * symbols.
+    static constexpr qsizetype MAX_SEQUENCE_LENGTH { 16 };
+
+    // Parses a comma separated list of up to MAX_SEQUENCE_LENGTH chords, e.g. "Ctrl+K, L" or "Ctrl+Shift+0x6A, F5"; keys are parsed by VkidTable::ParseVkid.
+    static bool ParseSequence(const QString& sequence_string, Sequence& out_sequence, QString* out_error = nullptr);
+
+protected:
+    std::array<quint8, 16 * 256>    symbolTable;        // Indexed by (modifiers << 8 | vkid); stores symbol index + 1, or 0 if the chord is unused.
+    quint32                         symbolCount;
+
+    std::vector<quint16>            transitionTable;    // Indexed by (node * symbolCount + symbol); stores the next node, or NO_NODE.
+    std::vector<HOTKEY_ACTION>      acceptTable;        // Indexed by node; the action completed by reaching the node, or HOTKEY_ACTION::NOTHING.
+
+    quint32                         timeoutMs;          // Maximum delay between two chords of the same sequence.
+
+public:
+    /* Replaces the contents of the trie with the given bindings. Fails if a sequence is empty, uses
+     * an invalid chord, or is a prefix of (or identical to) another sequence, as the shorter one would
+     * always complete first and make the longer one unreachable.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    bool             Compile(const BindingList& bindings, QString* out_error = nullptr);
+
+    quint16          Step(quint16 node, quint32 modifiers, quint32 vkid) const;
+    HOTKEY_ACTION    GetAcceptedAction(quint16 node) const;
+
+    bool             IsEmpty() const;
+    quint32          GetTimeout() const;
+    void             SetTimeout(quint32 timeout_ms);
+
+    KeySequenceTrie();
+};
+
+/* Tracks the progress of the key presses fed into it through a shared KeySequenceTrie. A key that
+ * doesn't continue the current sequence restarts matching from the root with that same key, and
+ * so does any key that arrives after the trie's timeout has elapsed since the previous one.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class KeySequenceMatcher {
+protected:
+    std::shared_ptr<const KeySequenceTrie>    keySequenceTrie;
+    quint16                                   currentNode;
+    quint32                                   lastKeyTimeMs;
+
+public:
+    void                                            SetTrie(const std::shared_ptr<const KeySequenceTrie>& key_sequence_trie);
+    const std::shared_ptr<const KeySequenceTrie>&   GetTrie() const;
+
+    // Feeds a non-modifier key press; time_ms only has to be monotonic, e.g. KBDLLHOOKSTRUCT::time.
+    HOTKEY_ACTION    Feed(quint32 modifiers, quint32 vkid, quint32 time_ms);
+    void             Reset();
+
+    KeySequenceMatcher();
+};
+
+#endif // KEY_SEQUENCE_MATCHER_HPP
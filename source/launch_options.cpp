@@ -0,0 +1,203 @@
+#include "launch_options.hpp"
+#include "vkid_table.hpp"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QMap>
+
+const QString LaunchOptions::DefaultConfigPath { "./defaults.json" };
+
+namespace {
+    void addOptions(QCommandLineParser& parser) {
+        parser.setApplicationDescription("Locks the cursor to the foreground window.");
+        parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
+
+        parser.addOptions({
+            { "debug",            "Spawns a console that mirrors the log."                                                                            },
+            { "stats",            "Prints the metrics of the running instance, and exits."                                                           },
+            { "help",             "Displays this help."                                                                                               },
+            { "config",           "Reads the JSON settings from <path> instead of ./defaults.json.",                                                 "path"     },
+            { "no-config",        "Neither reads nor generates the JSON settings file."                                                               },
+            { "headless",         "Runs without showing the window; the running instance can still be driven through the control socket."            },
+            { "method",           "Selects the activation method: none, hotkey, image, title, rule or fullscreen.",                                  "method"   },
+            { "target-image",     "Locks while a process with the image <name> owns the foreground window.",                                         "name"     },
+            { "target-title",     "Locks while the foreground window's title is <title>.",                                                           "title"    },
+            { "target-rule",      "Locks while the rule <expression> holds, e.g. running(\"game.exe\") and not suspended.",                          "expression" },
+            { "hotkey",           "Toggles the lock with the key <vkid>, e.g. 0x6A.",                                                                "vkid"     },
+            { "lock",             "Locks the cursor to the current foreground window."                                                                },
+            { "unlock",           "Unlocks the cursor."                                                                                               },
+            { "toggle",           "Toggles the cursor lock."                                                                                          },
+            { "lock-for",         "Locks right away, then unlocks and exits after <duration>, e.g. 90s or 5m.",                                      "duration" },
+            { "wait-for-process", "Exits once the --target-image process has been found and has exited again."                                       },
+            { "record",           "Records the events seen by the activation methods into <path>.",                                                  "path"     },
+            { "replay",           "Replays a recording through the activation logic as fast as possible, prints a summary, and exits.",              "path"     },
+            { "replay-passes",    "Repeats the replay <count> times, e.g. to measure the throughput of the activation logic.",                       "count"    },
+            { "replay-expect",    "Fails the replay unless its lock transitions match the \"<microseconds> locked|unlocked\" lines in <path>.",      "path"     },
+            { "memory-report",    "Starts up, prints the memory used by each subsystem, and exits; fails if the working set is over budget."          }
+        });
+    }
+}
+
+bool LaunchOptions::Parse(const QStringList& arguments, LaunchOptions& out_options, QString& out_error) {
+    QCommandLineParser parser;
+    addOptions(parser);
+
+    if(!parser.parse(arguments)) {
+        out_error = parser.errorText();
+        return false;
+    }
+
+    if(!parser.positionalArguments().isEmpty()) {
+        out_error = "Unexpected argument: " + parser.positionalArguments().first();
+        return false;
+    }
+
+    LaunchOptions options;
+
+    options.Debug          = parser.isSet("debug");
+    options.Stats          = parser.isSet("stats");
+    options.Help           = parser.isSet("help");
+    options.SkipConfig     = parser.isSet("no-config");
+    options.Headless       = parser.isSet("headless");
+    options.Lock           = parser.isSet("lock");
+    options.Unlock         = parser.isSet("unlock");
+    options.Toggle         = parser.isSet("toggle");
+    options.WaitForProcess = parser.isSet("wait-for-process");
+    options.MemoryReport   = parser.isSet("memory-report");
+
+    options.TargetImage    = parser.value("target-image");
+    options.TargetTitle    = parser.value("target-title");
+    options.TargetRule     = parser.value("target-rule");
+    options.Hotkey         = parser.value("hotkey");
+    options.Method         = parser.value("method").toLower();
+
+    options.RecordPath     = parser.value("record");
+    options.ReplayPath     = parser.value("replay");
+    options.ReplayExpectPath = parser.value("replay-expect");
+
+    if(parser.isSet("replay-passes")) {
+        bool conversion_succeeded { false };
+        options.ReplayPasses = parser.value("replay-passes").toUInt(&conversion_succeeded);
+
+        if(!conversion_succeeded || !options.ReplayPasses) {
+            out_error = "--replay-passes must be a positive number";
+            return false;
+        }
+    }
+
+    if(parser.isSet("config")) {
+        options.ConfigPath = parser.value("config");
+    }
+
+    // Each target implies its method, so at most one of them may be given, and it has to agree with --method.
+    const QMap<QString, QString>& targets {
+        { "image",  options.TargetImage },
+        { "title",  options.TargetTitle },
+        { "rule",   options.TargetRule  },
+        { "hotkey", options.Hotkey      }
+    };
+
+    for(auto iterator { targets.cbegin() }; iterator != targets.cend(); ++iterator) {
+        if(iterator.value().isEmpty()) {
+            continue;
+        }
+
+        if(!options.Method.isEmpty() && options.Method != iterator.key()) {
+            out_error = "The target options conflict with each other, or with --method " + options.Method;
+            return false;
+        }
+
+        options.Method = iterator.key();
+    }
+
+    if(!options.Method.isEmpty() && !QStringList { "none", "hotkey", "image", "title", "rule", "fullscreen" }.contains(options.Method)) {
+        out_error = "--method must be one of: none, hotkey, image, title, rule, fullscreen";
+        return false;
+    }
+
+    quint32 vkid { 0 };
+
+    if(!options.Hotkey.isEmpty() && !VkidTable::ParseVkid(options.Hotkey, vkid)) {
+        out_error = "--hotkey is not a valid VKID: " + options.Hotkey;
+        return false;
+    }
+
+    if(parser.isSet("lock-for") && !ParseDuration(parser.value("lock-for"), options.LockForMs)) {
+        out_error = "--lock-for is not a valid duration of at most 24 days: " + parser.value("lock-for");
+        return false;
+    }
+
+    if(!options.ReplayExpectPath.isEmpty() && options.ReplayPath.isEmpty()) {
+        out_error = "--replay-expect requires --replay";
+        return false;
+    }
+
+    if(options.WaitForProcess && options.TargetImage.isEmpty()) {
+        out_error = "--wait-for-process requires --target-image";
+        return false;
+    }
+
+    if(static_cast<int>(options.Lock) + static_cast<int>(options.Unlock) + static_cast<int>(options.Toggle) > 1) {
+        out_error = "Only one of --lock, --unlock and --toggle may be given";
+        return false;
+    }
+
+    out_options = options;
+    return true;
+}
+
+QString LaunchOptions::HelpText() {
+    QCommandLineParser parser;
+    addOptions(parser);
+    return parser.helpText();
+}
+
+bool LaunchOptions::ParseDuration(const QString& text, qint64& out_ms) {
+    static const QRegularExpression duration_expression { "^\\s*(\\d+)\\s*(ms|s|m|h)?\\s*$", QRegularExpression::CaseInsensitiveOption };
+
+    static const QMap<QString, qint64>& unit_multipliers {
+        { "ms", 1       },
+        { "s",  1000    },
+        { "m",  60000   },
+        { "h",  3600000 },
+        { "",   1000    }
+    };
+
+    const QRegularExpressionMatch& match { duration_expression.match(text) };
+
+    if(!match.hasMatch()) {
+        return false;
+    }
+
+    bool conversion_succeeded { false };
+    const qint64& amount { match.captured(1).toLongLong(&conversion_succeeded) };
+
+    const qint64& multiplier { unit_multipliers.value(match.captured(2).toLower()) };
+
+    // Compared before multiplying, so that the product can't overflow either.
+    if(!conversion_succeeded || amount <= 0 || amount > MaxDurationMs / multiplier) {
+        return false;
+    }
+
+    out_ms = amount * multiplier;
+    return true;
+}
+
+LaunchOptions::LaunchOptions()
+    :
+      Debug             { false             },
+      Stats             { false             },
+      Help              { false             },
+      ConfigPath        { DefaultConfigPath },
+      SkipConfig        { false             },
+      Headless          { false             },
+      Lock              { false             },
+      Unlock            { false             },
+      Toggle            { false             },
+      LockForMs         { -1                },
+      WaitForProcess    { false             },
+      ReplayPasses      { 1                 },
+      MemoryReport      { false             }
+{
+
+}
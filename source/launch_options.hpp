@@ -0,0 +1,56 @@
+#ifndef LAUNCH_OPTIONS_HPP
+#define LAUNCH_OPTIONS_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <limits>
+
+/* Everything that can be configured from the command line. Targets given here are applied after
+ * the JSON settings, so they override them, which lets launchers start the locker preconfigured
+ * for a specific game without touching the JSON file.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+struct LaunchOptions {
+    static const QString DefaultConfigPath;
+
+    bool       Debug;             // --debug, spawns a console that mirrors the log.
+    bool       Stats;             // --stats, prints the metrics of the running instance and exits.
+    bool       Help;              // --help
+
+    QString    ConfigPath;        // --config <path>
+    bool       SkipConfig;        // --no-config, neither reads nor generates the JSON file.
+    bool       Headless;          // --headless, never shows the window, and skips the stylesheet.
+
+    QString    Method;            // --method <none|hotkey|image|title|rule|fullscreen>
+    QString    TargetImage;       // --target-image <name>, implies --method image.
+    QString    TargetTitle;       // --target-title <title>, implies --method title.
+    QString    TargetRule;        // --target-rule <expression>, implies --method rule.
+    QString    Hotkey;            // --hotkey <vkid>, implies --method hotkey.
+
+    bool       Lock;              // --lock
+    bool       Unlock;            // --unlock
+    bool       Toggle;            // --toggle
+    qint64     LockForMs;         // --lock-for <duration>, locks right away, then unlocks and exits once the duration elapses; -1 if unset.
+    bool       WaitForProcess;    // --wait-for-process, exits once the --target-image process has been found and has exited again.
+
+    QString    RecordPath;        // --record <path>, records the activation events into <path>.
+    QString    ReplayPath;        // --replay <path>, replays a recording through the activation engine, prints a summary and exits.
+    quint32    ReplayPasses;      // --replay-passes <count>
+    QString    ReplayExpectPath;  // --replay-expect <path>, compares the replay's lock transitions with the ones listed in <path>.
+
+    bool       MemoryReport;      // --memory-report, starts up, lets the event loop settle, prints the memory used per subsystem and exits.
+
+    /* Parses the complete argument list, including the program name. Returns false and sets out_error
+     * if an option is unknown, is missing its value, or has an invalid value.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    static bool       Parse(const QStringList& arguments, LaunchOptions& out_options, QString& out_error);
+    static QString    HelpText();
+
+    static constexpr qint64 MaxDurationMs { std::numeric_limits<int>::max() };    // About 24.8 days; QTimer takes its interval as an int.
+
+    static bool       ParseDuration(const QString& text, qint64& out_ms);    // A number with an optional ms, s, m or h suffix; seconds if there's none. Fails above MaxDurationMs.
+
+    LaunchOptions();
+};
+
+#endif // LAUNCH_OPTIONS_HPP
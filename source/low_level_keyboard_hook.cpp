@@ -0,0 +1,209 @@
+#include "low_level_keyboard_hook.hpp"
+#include "metrics_registry.hpp"
+
+#include <QtCore/QtDebug>
+
+std::atomic<LowLevelKeyboardHook*> LowLevelKeyboardHook::activeInstance { nullptr };
+
+namespace {
+    MetricsRegistry::Counter&   hookFiresMetric   { MetricsRegistry::Instance().RegisterCounter("cursorlocker_hotkey_fires_total", "source=\"low_level_hook\"", "Number of hotkey and key sequence actions performed.") };
+    MetricsRegistry::Histogram& hookLatencyMetric { MetricsRegistry::Instance().RegisterHistogram("cursorlocker_hotkey_latency_seconds", "source=\"low_level_hook\"", "Time from the key event to the action being performed.", MetricsRegistry::LatencyBucketsUs(), 1e-6) };
+}
+
+LRESULT CALLBACK LowLevelKeyboardHook::hookProcedure(int code, WPARAM w_param, LPARAM l_param) {
+    LowLevelKeyboardHook* instance { activeInstance.load(std::memory_order_acquire) };
+
+    if(code == HC_ACTION && instance != nullptr) {
+        if(instance->handleKeyEvent(w_param, *reinterpret_cast<KBDLLHOOKSTRUCT*>(l_param))) {
+            return 1;    // Swallow the key press, the same way a registered hotkey would.
+        }
+    }
+
+    return CallNextHookEx(nullptr, code, w_param, l_param);
+}
+
+bool LowLevelKeyboardHook::handleKeyEvent(WPARAM message, const KBDLLHOOKSTRUCT& key_event) {
+    const quint8& vkid     { static_cast<quint8>(key_event.vkCode) };
+    const bool&   key_down { message == WM_KEYDOWN || message == WM_SYSKEYDOWN };
+
+    quint32 modifier { 0 };
+
+    switch(vkid) {
+    case VK_LMENU    : case VK_RMENU    : case VK_MENU    : modifier = MOD_ALT;     break;
+    case VK_LCONTROL : case VK_RCONTROL : case VK_CONTROL : modifier = MOD_CONTROL; break;
+    case VK_LSHIFT   : case VK_RSHIFT   : case VK_SHIFT   : modifier = MOD_SHIFT;   break;
+    case VK_LWIN     : case VK_RWIN                       : modifier = MOD_WIN;     break;
+    }
+
+    if(modifier) {
+        heldModifiers = key_down ? (heldModifiers | modifier) : (heldModifiers & ~modifier);
+    }
+
+    if(!key_down) {
+        keysHeldDown.reset(vkid);
+        return false;
+    }
+
+    const bool& is_repeat { keysHeldDown.test(vkid) };
+    keysHeldDown.set(vkid);
+
+    for(size_t action_index { 0 }; action_index < bindingTable[vkid].size(); ++action_index) {
+        const quint32& binding { bindingTable[vkid][action_index].load(std::memory_order_relaxed) };
+
+        if((binding & 0x80000000) && (binding & 0xFFFF) == heldModifiers) {
+            // Swallow repeats of a bound key, but only act on the initial press.
+            if(!is_repeat) {
+                keySequenceMatcher.Reset();
+                performAction(static_cast<HOTKEY_ACTION>(action_index), key_event.time);
+            }
+
+            return true;
+        }
+    }
+
+    // Modifier keys only ever take part in sequences as part of a chord, so they aren't fed on their own.
+    if(modifier || is_repeat) {
+        return false;
+    }
+
+    const std::shared_ptr<const KeySequenceTrie>& pending_trie { std::atomic_load(&pendingKeySequenceTrie) };
+
+    if(pending_trie != keySequenceMatcher.GetTrie()) {
+        keySequenceMatcher.SetTrie(pending_trie);
+    }
+
+    const HOTKEY_ACTION& sequence_action { keySequenceMatcher.Feed(heldModifiers, vkid, key_event.time) };
+
+    // Only the key completing a sequence is swallowed; the preceding chords still reach the focused application.
+    if(sequence_action != HOTKEY_ACTION::NOTHING) {
+        performAction(sequence_action, key_event.time);
+        return true;
+    }
+
+    return false;
+}
+
+void LowLevelKeyboardHook::performAction(HOTKEY_ACTION action, DWORD event_time) {
+    // Deferred actions aren't performed here, but left to the GUI thread, which receives them through ActionPerformed.
+    const bool& deferred {
+        action == HOTKEY_ACTION::TOGGLE_MUTE || (action == HOTKEY_ACTION::TOGGLE_LOCK && toggleDeferred.load(std::memory_order_relaxed))
+    };
+
+    switch(deferred ? HOTKEY_ACTION::NOTHING : action) {
+    case HOTKEY_ACTION::TOGGLE_LOCK :
+        cursorLock.Toggle();
+        break;
+
+    case HOTKEY_ACTION::FORCE_LOCK :
+    case HOTKEY_ACTION::RECLIP :
+        if(action == HOTKEY_ACTION::FORCE_LOCK || cursorLock.IsEnabled()) {
+            cursorLock.SetEnabled(true);
+        }
+        break;
+
+    case HOTKEY_ACTION::FORCE_UNLOCK :
+        cursorLock.SetEnabled(false);
+        break;
+
+    default :
+        break;
+    }
+
+    if(!deferred && (action == HOTKEY_ACTION::TOGGLE_LOCK || action == HOTKEY_ACTION::FORCE_LOCK || action == HOTKEY_ACTION::FORCE_UNLOCK)) {
+        soundMixer.Trigger(cursorLock.IsEnabled() ? SOUND_CUE::LOCK_ACTIVATED : SOUND_CUE::LOCK_DEACTIVATED);
+    }
+
+    // event_time shares its time base with GetTickCount, which makes it comparable with the MSG::time of WM_HOTKEY.
+    const quint32& latency_ms { GetTickCount() - event_time };
+
+    hookFiresMetric.Increment();
+    hookLatencyMetric.Observe(latency_ms * 1000ull);
+
+    emit ActionPerformed(action, deferred, cursorLock.IsEnabled(), latency_ms);
+}
+
+void LowLevelKeyboardHook::run() {
+    hookThreadId = GetCurrentThreadId();
+
+    // Ensure this thread has a message queue before the hook is installed, so that Stop() can always post WM_QUIT.
+    MSG message;
+    PeekMessage(&message, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+    LowLevelKeyboardHook* expected_instance { nullptr };
+
+    if(!activeInstance.compare_exchange_strong(expected_instance, this, std::memory_order_acq_rel)) {
+        qCritical() << "A low-level keyboard hook is already active, refusing to install a second one.";
+        return;
+    }
+
+    HHOOK hook_handle { SetWindowsHookEx(WH_KEYBOARD_LL, &LowLevelKeyboardHook::hookProcedure, GetModuleHandle(nullptr), 0) };
+
+    if(hook_handle == nullptr) {
+        qCritical() << "SetWindowsHookEx(WH_KEYBOARD_LL) failed with error code" << GetLastError();
+        activeInstance = nullptr;
+        return;
+    }
+
+    qInfo() << "Installed low-level keyboard hook on thread" << hookThreadId.load();
+
+    while(GetMessage(&message, nullptr, 0, 0) > 0) {
+        TranslateMessage(&message);
+        DispatchMessage(&message);
+    }
+
+    UnhookWindowsHookEx(hook_handle);
+    activeInstance = nullptr;
+
+    qInfo() << "Removed low-level keyboard hook.";
+}
+
+void LowLevelKeyboardHook::SetBinding(quint32 vkid, quint32 modifiers, HOTKEY_ACTION action) {
+    if(vkid < bindingTable.size() && action < HOTKEY_ACTION::COUNT) {
+        bindingTable[vkid][static_cast<size_t>(action)] = 0x80000000 | (modifiers & 0xFFFF);
+    }
+}
+
+void LowLevelKeyboardHook::ClearBinding(quint32 vkid, HOTKEY_ACTION action) {
+    if(vkid < bindingTable.size() && action < HOTKEY_ACTION::COUNT) {
+        bindingTable[vkid][static_cast<size_t>(action)] = 0;
+    }
+}
+
+void LowLevelKeyboardHook::SetToggleDeferred(bool deferred) {
+    toggleDeferred.store(deferred, std::memory_order_relaxed);
+}
+
+void LowLevelKeyboardHook::SetKeySequenceTrie(const std::shared_ptr<const KeySequenceTrie>& key_sequence_trie) {
+    std::atomic_store(&pendingKeySequenceTrie, key_sequence_trie);
+}
+
+void LowLevelKeyboardHook::Stop() {
+    // The thread may not have created its message queue yet, in which case PostThreadMessage fails and has to be retried.
+    while(isRunning() && !(hookThreadId && PostThreadMessage(hookThreadId, WM_QUIT, 0, 0))) {
+        QThread::yieldCurrentThread();
+    }
+
+    wait();
+}
+
+LowLevelKeyboardHook::LowLevelKeyboardHook(CursorLock& cursor_lock, SoundMixer& sound_mixer, QObject* parent)
+    :
+      QThread                   { parent      },
+      bindingTable              {             },
+      cursorLock                { cursor_lock },
+      soundMixer                { sound_mixer },
+      hookThreadId              { 0           },
+      toggleDeferred            { false       },
+      pendingKeySequenceTrie    { nullptr     },
+      heldModifiers             { 0           }
+{
+    for(std::array<std::atomic<quint32>, static_cast<size_t>(HOTKEY_ACTION::COUNT)>& vkid_bindings : bindingTable) {
+        for(std::atomic<quint32>& binding : vkid_bindings) {
+            binding = 0;
+        }
+    }
+}
+
+LowLevelKeyboardHook::~LowLevelKeyboardHook() {
+    Stop();
+}
@@ -0,0 +1,71 @@
+#ifndef LOW_LEVEL_KEYBOARD_HOOK_HPP
+#define LOW_LEVEL_KEYBOARD_HOOK_HPP
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QThread>
+
+#include <array>
+#include <atomic>
+#include <bitset>
+
+#include "hotkey_registry.hpp"
+#include "key_sequence_matcher.hpp"
+#include "cursor_lock.hpp"
+#include "sound_mixer.hpp"
+
+/* Alternative to RegisterHotKey for games that hold focus in a way that prevents WM_HOTKEY from
+ * being delivered. Installs a WH_KEYBOARD_LL hook on a dedicated time-critical thread running its
+ * own message loop, matches key presses against a binding table indexed by VKID and action, and
+ * feeds them to a KeySequenceMatcher for multi-chord sequences, and performs the lock related
+ * actions on that thread directly through CursorLock, triggering their sound cues through the
+ * SoundMixer. The GUI thread is only notified afterwards, through the queued ActionPerformed signal,
+ * which also carries the actions left to it: muting, and toggling while SetToggleDeferred is set.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class LowLevelKeyboardHook : public QThread {
+Q_OBJECT
+
+protected:
+    static std::atomic<LowLevelKeyboardHook*> activeInstance;    // WH_KEYBOARD_LL procedures take no context pointer; only one hook may be active.
+    static LRESULT CALLBACK hookProcedure(int code, WPARAM w_param, LPARAM l_param);
+
+    /* One slot per action for every VKID, so that actions bound to the same key with different modifiers
+     * don't overwrite each other. Each slot packs a binding as (1 << 31) | modifiers, or 0 if the action
+     * isn't bound to the VKID, so that the hook thread can read it without locking while the GUI thread rebinds.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    std::array<std::array<std::atomic<quint32>, static_cast<size_t>(HOTKEY_ACTION::COUNT)>, 256>    bindingTable;
+
+    CursorLock&                 cursorLock;
+    SoundMixer&                 soundMixer;
+    std::atomic<DWORD>          hookThreadId;
+    std::atomic<bool>           toggleDeferred;       // Set by the GUI thread while TOGGLE_LOCK means something other than toggling the lock.
+
+    std::shared_ptr<const KeySequenceTrie>    pendingKeySequenceTrie;    // Published by the GUI thread with std::atomic_store, picked up by the hook thread.
+    KeySequenceMatcher          keySequenceMatcher;   // Only touched by the hook thread.
+
+    std::bitset<256>            keysHeldDown;         // Only touched by the hook thread; used to emulate MOD_NOREPEAT.
+    quint32                     heldModifiers;        // Only touched by the hook thread; WinApi MOD_* bitmask of the held modifier keys.
+
+    bool                        handleKeyEvent(WPARAM message, const KBDLLHOOKSTRUCT& key_event);
+    void                        performAction(HOTKEY_ACTION action, DWORD event_time);
+    virtual void                run() override;
+
+public:
+    Q_SIGNAL void               ActionPerformed(HOTKEY_ACTION action, bool deferred, bool cursor_lock_state, quint32 latency_ms);    // If deferred, the GUI thread has to perform the action.
+
+    void                        SetBinding(quint32 vkid, quint32 modifiers, HOTKEY_ACTION action);
+    void                        ClearBinding(quint32 vkid, HOTKEY_ACTION action);
+    void                        SetToggleDeferred(bool deferred);    // E.g. while the rule method is selected, where the toggle suspends the rule.
+    void                        SetKeySequenceTrie(const std::shared_ptr<const KeySequenceTrie>& key_sequence_trie);
+
+    void                        Stop();
+
+    explicit LowLevelKeyboardHook(CursorLock& cursor_lock, SoundMixer& sound_mixer, QObject* parent = nullptr);
+    virtual ~LowLevelKeyboardHook() override;
+};
+
+#endif // LOW_LEVEL_KEYBOARD_HOOK_HPP
@@ -1,23 +1,277 @@
 #include <QtWidgets/QApplication>
+#include <QtCore/QTimer>
+#include <QtCore/QFile>
 #include <iostream>
 
+#include <shellapi.h>
+
 #include "main_window_dialog.hxx"
+#include "control_client.hpp"
+#include "single_instance_guard.hpp"
+#include "launch_options.hpp"
+#include "metrics_registry.hpp"
+#include "activation_recording.hpp"
+#include "memory_audit.hpp"
 #include "debugging.hpp"
 
+// The arguments as UTF-16, since argv is in the ANSI code page; needed before a QCoreApplication exists to provide them.
+QStringList commandLineArguments() {
+    QStringList arguments;
+
+    int argument_count { 0 };
+    LPWSTR* argument_vector { CommandLineToArgvW(GetCommandLineW(), &argument_count) };
+
+    if(argument_vector != nullptr) {
+        for(int i { 0 }; i < argument_count; ++i) {
+            arguments.append(QString::fromWCharArray(argument_vector[i]));
+        }
+
+        LocalFree(argument_vector);
+    }
+
+    return arguments;
+}
+
+// Prints the metrics of the already running instance, in the Prometheus text format.
+int dumpStats(int argc, char* argv[]) {
+    QCoreApplication application(argc, argv);
+    Debugging::AttachParentConsole();
+
+    ControlClient control_client;
+    QByteArray exposition;
+
+    if(!control_client.Connect() || !control_client.QueryMetrics(exposition)) {
+        fprintf(stdout, "Could not retrieve metrics from a running instance: %s\n", control_client.GetLastError().toStdString().c_str());
+        return 1;
+    }
+
+    fprintf(stdout, "%s", exposition.constData());
+    return 0;
+}
+
+// Replays an activation recording through the activation engine, without touching the cursor, and prints what it decided.
+int replayRecording(const LaunchOptions& launch_options) {
+    Debugging::AttachParentConsole();
+
+    ActivationReplay replay;
+    ActivationEngine engine;
+    QString error;
+
+    if(!replay.Open(launch_options.ReplayPath, error)) {
+        fprintf(stdout, "%s\n", error.toStdString().c_str());
+        return 1;
+    }
+
+    QStringList expected_transitions;
+
+    if(!launch_options.ReplayExpectPath.isEmpty()) {
+        QFile expectation_file { launch_options.ReplayExpectPath };
+
+        if(!expectation_file.open(QFile::ReadOnly | QFile::Text)) {
+            fprintf(stdout, "Could not open the expected transitions: %s\n", expectation_file.errorString().toStdString().c_str());
+            return 1;
+        }
+
+        // One "<microseconds> locked|unlocked" line per transition; blank lines and # comments describe the scenario.
+        for(const QString& line : QString::fromUtf8(expectation_file.readAll()).split('\n')) {
+            const QString& simplified_line { line.simplified() };
+
+            if(!simplified_line.isEmpty() && !simplified_line.startsWith('#')) {
+                expected_transitions.append(simplified_line);
+            }
+        }
+    }
+
+    QStringList transitions;
+
+    const ActivationReplay::Summary& summary {
+        replay.Run(engine, launch_options.ReplayPasses, [&transitions](const ActivationEvent& event, bool lock_state) -> void {
+            fprintf(stdout, "%12.6f s  %s\n", event.TimestampUs / 1e6, lock_state ? "locked" : "unlocked");
+            transitions.append(QString::number(event.TimestampUs) + (lock_state ? " locked" : " unlocked"));
+        })
+    };
+
+    const double& elapsed_seconds { summary.ElapsedNs / 1e9 };
+
+    fprintf(stdout,
+            "\n"
+            "Recorded span:     %.3f s\n"
+            "Events:            %llu (%u pass(es))\n"
+            "Lock decisions:    %llu lock, %llu unlock, %llu toggle\n"
+            "Lock transitions:  %llu\n"
+            "Targets:           %llu found, %llu lost\n"
+            "Replay time:       %.3f ms (%.0f events/s)\n",
+            summary.RecordedSpanUs / 1e6,
+            summary.EventCount, launch_options.ReplayPasses,
+            summary.LockActions, summary.UnlockActions, summary.ToggleActions,
+            summary.LockTransitions,
+            summary.TargetsFound, summary.TargetsLost,
+            elapsed_seconds * 1e3, elapsed_seconds > 0 ? summary.EventCount / elapsed_seconds : 0.0);
+
+    if(launch_options.ReplayExpectPath.isEmpty()) {
+        return 0;
+    }
+
+    for(qsizetype i { 0 }; i < qMax(transitions.size(), expected_transitions.size()); ++i) {
+        const QString& actual   { i < transitions.size()          ? transitions.at(i)          : QString { "nothing" } };
+        const QString& expected { i < expected_transitions.size() ? expected_transitions.at(i) : QString { "nothing" } };
+
+        if(actual != expected) {
+            fprintf(stdout, "\nTransition %lld differs from %s: expected %s, got %s\n",
+                    static_cast<long long>(i + 1), launch_options.ReplayExpectPath.toStdString().c_str(),
+                    expected.toStdString().c_str(), actual.toStdString().c_str());
+            return 2;
+        }
+    }
+
+    fprintf(stdout, "\nAll %lld transitions match %s\n", static_cast<long long>(transitions.size()), launch_options.ReplayExpectPath.toStdString().c_str());
+    return 0;
+}
+
+// Microseconds since the process was created, including process startup that happened before main.
+qint64 microsecondsSinceProcessCreation() {
+    FILETIME creation_time, exit_time, kernel_time, user_time, current_time;
+
+    if(!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return -1;
+    }
+
+    GetSystemTimePreciseAsFileTime(&current_time);
+
+    const ULARGE_INTEGER& creation { { creation_time.dwLowDateTime, creation_time.dwHighDateTime } };
+    const ULARGE_INTEGER& current  { { current_time.dwLowDateTime,  current_time.dwHighDateTime  } };
+
+    return static_cast<qint64>(current.QuadPart - creation.QuadPart) / 10;    // FILETIME counts 100 ns intervals.
+}
+
+// Hands the options over to the instance that's already running, then exits without constructing any widgets.
+int forwardToPrimaryInstance(int argc, char* argv[], const LaunchOptions& launch_options) {
+    QCoreApplication application(argc, argv);
+    Debugging::AttachParentConsole();
+
+    const QString& unforwardable_option { SingleInstanceGuard::UnforwardableOption(launch_options) };
+
+    if(!unforwardable_option.isEmpty()) {
+        fprintf(stdout, "%s can't be used while another instance is running.\n", unforwardable_option.toStdString().c_str());
+        return 1;
+    }
+
+    QString error;
+
+    if(!SingleInstanceGuard::ForwardToPrimaryInstance(SingleInstanceGuard::OptionsToRequests(launch_options), error)) {
+        fprintf(stdout, "Could not forward the arguments to the running instance: %s\n", error.toStdString().c_str());
+        return 1;
+    }
+
+    const qint64& forwarding_latency_us { microsecondsSinceProcessCreation() };
+
+    fprintf(stdout, "Forwarded to the running instance in %lld us.\n", forwarding_latency_us);
+
+    return 0;
+}
+
+/* Starts up as usual, gives the event loop a few seconds to settle (the first process snapshot, the
+ * first paint), then prints the memory attributed to each subsystem and exits.
+ * Returns 2 if the working set is over its budget, so that a script can keep track of the footprint.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+int reportMemory(int argc, char* argv[], const LaunchOptions& launch_options) {
+    static constexpr qint32 SETTLE_TIME_MS { 3000 };
+
+    Debugging::AttachParentConsole();
+
+    MemoryAudit& memory_audit { MemoryAudit::Instance() };
+    memory_audit.Enable();
+
+    MemoryAudit::Scope application_scope { "Qt application" };
+    QApplication application(argc, argv);
+    application_scope.End();
+
+    MemoryAudit::Scope main_window_scope { "main window" };
+    MainWindowDialog main_window_dialog { launch_options };
+    main_window_scope.End();
+
+    MemoryAudit::Scope event_loop_scope { launch_options.Headless ? "event loop" : "event loop, window shown" };
+
+    if(!launch_options.Headless) {
+        main_window_dialog.show();
+    }
+
+    QTimer::singleShot(SETTLE_TIME_MS, &application, &QCoreApplication::quit);
+    application.exec();
+    event_loop_scope.End();
+
+    fprintf(stdout, "%s", memory_audit.Report().toStdString().c_str());
+
+    return memory_audit.IsWithinBudget() ? 0 : 2;
+}
+
+// Reports how long it took from process creation until the event loop is about to start, per launch mode.
+void recordStartupTime(const LaunchOptions& launch_options) {
+    const QString& mode {
+        launch_options.LockForMs > 0      ? "lock_for"         :
+        launch_options.WaitForProcess     ? "wait_for_process" :
+        launch_options.Headless           ? "headless"         :
+                                            "window"
+    };
+
+    const qint64& startup_time_us { microsecondsSinceProcessCreation() };
+
+    MetricsRegistry::Instance().RegisterGauge("cursorlocker_startup_seconds", "mode=\"" + mode + "\",config=\"" + (launch_options.SkipConfig ? "none" : "json") + "\"",
+                                              "Time from process creation until the event loop started.", 1e-6).Set(startup_time_us);
+
+    qInfo() << "Started in" << startup_time_us << "us, mode:" << mode << (launch_options.SkipConfig ? "without" : "with") << "JSON settings.";
+}
+
 int main(int argc, char* argv[]) {
-    for(int i { 0 }; i < argc; ++i) {
-        const char* argument { argv[i] };
+    LaunchOptions launch_options;
+    QString error;
 
-        if(!_stricmp(argument, "--debug")) {
-            Debugging::SpawnDebugConsole();
+    const bool& options_valid { LaunchOptions::Parse(commandLineArguments(), launch_options, error) };
+
+    if(!options_valid || launch_options.Help) {
+        Debugging::AttachParentConsole();
+
+        if(!options_valid) {
+            fprintf(stdout, "%s\n\n", error.toStdString().c_str());
         }
+
+        fprintf(stdout, "%s", LaunchOptions::HelpText().toStdString().c_str());
+        return options_valid ? 0 : 1;
+    }
+
+    if(launch_options.Stats) {
+        return dumpStats(argc, argv);
+    }
+
+    if(!launch_options.ReplayPath.isEmpty()) {
+        return replayRecording(launch_options);
+    }
+
+    // Checked before installing the message handler, which would otherwise truncate the running instance's log file.
+    const SingleInstanceGuard single_instance_guard;
+
+    if(!single_instance_guard.IsPrimaryInstance()) {
+        return forwardToPrimaryInstance(argc, argv, launch_options);
+    }
+
+    if(launch_options.Debug) {
+        Debugging::SpawnDebugConsole();
     }
 
     qInstallMessageHandler(Debugging::DebugMessageHandler);
 
+    if(launch_options.MemoryReport) {
+        return reportMemory(argc, argv, launch_options);
+    }
+
     QApplication application(argc, argv);
-    MainWindowDialog main_window_dialog;
-    main_window_dialog.show();
+    MainWindowDialog main_window_dialog { launch_options };
+
+    if(!launch_options.Headless) {
+        main_window_dialog.show();
+    }
+
+    recordStartupTime(launch_options);
 
     return application.exec();
 }
@@ -1,69 +1,84 @@
 #include "main_window_dialog.hxx"
 #include "ui_main_window_dialog.h"
 
-enum struct ACTIVATION_METHOD {
-    NOTHING         =   0b00000000,
-    HOTKEY          =   0b00000001,
-    PROCESS_IMAGE   =   0b00000010,
-    WINDOW_TITLE    =   0b00000100,
-};
-
-qsizetype MainWindowDialog::loadQssStylesheet(const QString& style_sheet_path, QByteArray& out_bytes) const {
-    QFileInfo style_sheet_info { style_sheet_path };
-
-    if(!style_sheet_info.exists() || !style_sheet_info.isFile()) {
-        return -1;
-    }
-
-    QFile style_sheet_file { style_sheet_info.absoluteFilePath() };
-
-    if(style_sheet_file.open(QFile::ReadOnly | QFile::Text)) {
-        const QByteArray& style_sheet_bytes { style_sheet_file.readAll() };
-        style_sheet_file.close();
-
-        out_bytes = style_sheet_bytes;
-
-        return style_sheet_bytes.size();
-    }
-
-    return -2;
+namespace {
+    MetricsRegistry::Counter&   hotkeyFiresMetric   { MetricsRegistry::Instance().RegisterCounter("cursorlocker_hotkey_fires_total", "source=\"wm_hotkey\"", "Number of hotkey and key sequence actions performed.") };
+    MetricsRegistry::Histogram& hotkeyLatencyMetric { MetricsRegistry::Instance().RegisterHistogram("cursorlocker_hotkey_latency_seconds", "source=\"wm_hotkey\"", "Time from the key event to the action being performed.", MetricsRegistry::LatencyBucketsUs(), 1e-6) };
+    MetricsRegistry::Counter&   imageMissesMetric   { MetricsRegistry::Instance().RegisterCounter("cursorlocker_activation_match_misses_total", "method=\"image\"", "Number of activation checks that didn't find their target.") };
+    MetricsRegistry::Counter&   titleMissesMetric   { MetricsRegistry::Instance().RegisterCounter("cursorlocker_activation_match_misses_total", "method=\"title\"", "Number of activation checks that didn't find their target.") };
+    MetricsRegistry::Counter&   ruleMissesMetric    { MetricsRegistry::Instance().RegisterCounter("cursorlocker_activation_match_misses_total", "method=\"rule\"", "Number of activation checks that didn't find their target.") };
+    MetricsRegistry::Counter&   fullscreenMissesMetric { MetricsRegistry::Instance().RegisterCounter("cursorlocker_activation_match_misses_total", "method=\"fullscreen\"", "Number of activation checks that didn't find their target.") };
+    MetricsRegistry::Histogram& fullscreenLatencyMetric { MetricsRegistry::Instance().RegisterHistogram("cursorlocker_fullscreen_detection_latency_seconds", {}, "Time from the focus, geometry or display change to the foreground window's fullscreen state being reported.", MetricsRegistry::LatencyBucketsUs(), 1e-6) };
+    MetricsRegistry::Counter&   titleWakeupsMetric  { MetricsRegistry::Instance().RegisterCounter("cursorlocker_poll_wakeups_total", "source=\"title_poll\"", "Number of times a polling timer woke the process up.") };
+    MetricsRegistry::Histogram& titleAllocationsMetric { MetricsRegistry::Instance().RegisterHistogram("cursorlocker_tick_heap_allocations", "tick=\"title_check\"", "Heap allocations made on the GUI thread per polling tick, including what the subscribers did with it; only counted in debug builds.", MemoryAudit::AllocationBuckets()) };
+
+    MetricsRegistry::Histogram& styleSheetApplyTimeMetric { MetricsRegistry::Instance().RegisterHistogram("cursorlocker_stylesheet_apply_seconds", {}, "Time spent loading and applying a changed stylesheet, including setStyleSheet.", MetricsRegistry::LatencyBucketsUs(), 1e-6) };
 }
 
 qsizetype MainWindowDialog::loadAndApplyQssStylesheet(const QString& style_sheet_path) {
-    QByteArray style_sheet_bytes;
+    const MemoryAudit::Scope memory_audit_scope { "stylesheet" };
 
-    const qsizetype& bytes_read {
-        loadQssStylesheet(style_sheet_path, style_sheet_bytes)
+    QElapsedTimer apply_timer;
+    apply_timer.start();
+
+    // The default stylesheet is compiled into the binary when available, but a copy next to the executable takes precedence.
+    const QString& resolved_style_sheet_path {
+        style_sheet_path == styleSheetFilePath && !QFileInfo::exists(style_sheet_path) && QFileInfo::exists(StylesheetCache::EmbeddedDefaultPath)
+            ? StylesheetCache::EmbeddedDefaultPath
+            : style_sheet_path
     };
 
-    switch(bytes_read) {
-    case -1:
+    const StylesheetCache::Stylesheet* style_sheet { nullptr };
+    QString compile_error;
+
+    switch(styleSheetCache.Load(resolved_style_sheet_path, style_sheet, compile_error)) {
+    case StylesheetCache::LOAD_RESULT::NOT_FOUND:
         qWarning() << "Skipping stylesheet loading, as the stylesheet could not be found, using default Windows style instead.";
-        break;
+        return -1;
+
+    case StylesheetCache::LOAD_RESULT::IO_ERROR:
+        qCritical() << "Encountered an I/O error when attempting to open stylesheet file for reading, location: \"" << resolved_style_sheet_path << "\" - are you sure you have permission to read from this location?";
+        return -2;
+
+    case StylesheetCache::LOAD_RESULT::INVALID:
+        qCritical() << "Skipping stylesheet" << resolved_style_sheet_path << "as it's malformed:" << compile_error;
+        return -3;
 
-    case -2:
-        qCritical() << "Encountered an I/O error when attempting to open stylesheet file for reading, location: \"" << styleSheetFilePath << "\" - are you sure you have permission to read from this location?";
+    case StylesheetCache::LOAD_RESULT::CACHED:
+    case StylesheetCache::LOAD_RESULT::COMPILED:
         break;
+    }
 
-    default:
-        const QFileInfo style_sheet_info   { style_sheet_path };
-        const QFileInfo resource_file_info { QString { "%1/%2.rcc" }.arg(style_sheet_info.path(), style_sheet_info.completeBaseName()) };
+    const QFileInfo style_sheet_info   { style_sheet_path };
+    const QFileInfo resource_file_info { QString { "%1/%2.rcc" }.arg(style_sheet_info.path(), style_sheet_info.completeBaseName()) };
 
+    if(resource_file_info.absoluteFilePath() != registeredResourceFilePath) {
         if(resource_file_info.exists() && resource_file_info.isFile()) {
             if(QResource::registerResource(resource_file_info.absoluteFilePath())) {
                 qInfo() << "Registered resource file:" << resource_file_info.absoluteFilePath();
+                registeredResourceFilePath = resource_file_info.absoluteFilePath();
             } else {
                 qWarning() << "Failed to register resource file:" << resource_file_info.absoluteFilePath();
             }
         } else {
             qInfo() << "Could not find a matching resource file for the stylesheet that was found. Path that was checked:" << resource_file_info.absoluteFilePath();
         }
+    }
 
-        setStyleSheet(style_sheet_bytes);
-        break;
+    // setStyleSheet repolishes every widget in the window, so it's skipped if the stylesheet hasn't changed since it was last applied.
+    if(style_sheet->ContentHash != appliedStyleSheetHash) {
+        setStyleSheet(style_sheet->Compiled);
+        appliedStyleSheetHash = style_sheet->ContentHash;
+
+        styleSheetApplyTimeMetric.Observe(static_cast<quint64>(apply_timer.nsecsElapsed() / 1000));
+
+        qInfo() << "Applied stylesheet" << resolved_style_sheet_path
+                << "compiled from" << style_sheet->SourceSize
+                << "to" << style_sheet->Compiled.size()
+                << "characters in" << apply_timer.nsecsElapsed() / 1000 << "us.";
     }
 
-    return bytes_read;
+    return style_sheet->SourceSize;
 }
 
 qsizetype MainWindowDialog::loadAndApplyQssStylesheet() {
@@ -106,8 +121,16 @@ void MainWindowDialog::changeActivationMethod(int method_index) {
     unsetAmToHotkey();
     unsetAmToProcessImageName();
     unsetAmToForegroundWindowTitle();
+    unsetAmToRule();
+
+    static const QList<quint32>& timed_activation_methods_indexes { 3 };    // The process image method is driven by processSnapshotService instead.
 
-    static const QList<quint32>& timed_activation_methods_indexes { 2, 3 };
+    static const QList<ACTIVATION_METHOD>& activation_methods_by_index {
+        ACTIVATION_METHOD::NOTHING, ACTIVATION_METHOD::HOTKEY, ACTIVATION_METHOD::PROCESS_IMAGE, ACTIVATION_METHOD::WINDOW_TITLE, ACTIVATION_METHOD::RULE, ACTIVATION_METHOD::FULLSCREEN
+    };
+
+    // Dispatched before the method is set up, as subscribing to the snapshot service may publish a snapshot right away.
+    dispatchActivationEvent(ActivationEvent::TYPE::METHOD_CHANGED, static_cast<quint64>(activation_methods_by_index.value(method_index, ACTIVATION_METHOD::NOTHING)));
 
     switch(method_index) {
     case 0 :
@@ -127,11 +150,22 @@ void MainWindowDialog::changeActivationMethod(int method_index) {
     case 3 :
         setAmToForegroundWindowTitle();
         break;
+
+    case 4 :
+        setAmToRule();
+        break;
+
+    case 5 :
+        setAmToFullscreen();
+        break;
     }
 
-    if(timed_activation_methods_indexes.contains(method_index)) {
+    if(timed_activation_methods_indexes.contains(method_index) && !powerStateMonitor->IsIdle()) {
         timedActivationMethodTimer->start(500);
     }
+
+    const QString& method_name { JsonSettingsDialog::ActivationMethodResolverITOS.value(method_index) };
+    controlServer->PublishEvent("method " + (method_name.isEmpty() ? QString { "none" } : method_name));
 }
 
 bool MainWindowDialog::changeActivationMethod(const QString& method) {
@@ -185,6 +219,19 @@ void MainWindowDialog::editActivationMethodParameter() {
             setAmpForegroundWindowTitle(ui->linActivationParameter->text());
             break;
 
+        case ACTIVATION_METHOD::RULE : {
+            const QString& rule_error { setAmpActivationRule(ui->linActivationParameter->text()) };
+
+            if(!rule_error.isEmpty()) {
+                QMessageBox::warning(this, "Invalid Rule!", "The rule could not be compiled, and won't lock until it's corrected: " + rule_error);
+            }
+            break;
+        }
+
+        case ACTIVATION_METHOD::FULLSCREEN :
+            setAmpFullscreenExclusions(ui->linActivationParameter->text());
+            break;
+
         case ACTIVATION_METHOD::NOTHING :
             break;
         }
@@ -215,11 +262,21 @@ void MainWindowDialog::clearActivationMethodParameter() {
         setAmpForegroundWindowTitle("");
         break;
     }
+
+    case ACTIVATION_METHOD::RULE : {
+        setAmpActivationRule("");
+        break;
     }
 
-    if(lastCursorLockStateSet) {
+    case ACTIVATION_METHOD::FULLSCREEN : {
+        setAmpFullscreenExclusions("");
+        break;
+    }
+    }
+
+    if(cursorLock.IsEnabled()) {
         setCursorLockEnabled(false);
-        seLockDeactivated.play();
+        soundMixer.Trigger(SOUND_CUE::LOCK_DEACTIVATED);
         qInfo() << "Cursor lock disabled, as activation method parameters have been cleared.";
     }
 }
@@ -238,9 +295,7 @@ void MainWindowDialog::handleModifierListBitmaskChanged(const quint32& bitmask)
 // Hotkey Input / Recorder
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void MainWindowDialog::updateUiWithRecordedHotkey(HotkeyRecorderWidget::Hotkey windows_hotkey) {
-    const QString& hex_vkid { QString { "0x%1" }.arg(QString::number(windows_hotkey.Vkid, 16), 2, QChar { '0' }) };
-
-    ui->linActivationParameter->setText(hex_vkid);
+    ui->linActivationParameter->setText(QLatin1String { VkidTable::ToHexString(windows_hotkey.Vkid) });
     ampwHotkeyModifierDropdown->SetModifierCheckStateFromBitmask(windows_hotkey.Modifiers);
 
     qInfo() << "Ui has been set to use recorded hotkey: " << windows_hotkey.ToString();
@@ -257,6 +312,7 @@ void MainWindowDialog::updateHotkeyInputWithNewModifierBitmask(const quint32& ne
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void MainWindowDialog::spawnVkidTableWidgetDialog() {
     if(vkidTableWidgetDialog == nullptr) {
+        const MemoryAudit::Scope memory_audit_scope { "VKID table dialog" };
         vkidTableWidgetDialog = new VkidTableWidgetDialog { this };
 
         connect(vkidTableWidgetDialog, &VkidTableWidgetDialog::destroyed, [this]() -> void {
@@ -277,12 +333,17 @@ QString MainWindowDialog::setAmpHotkeyVkid(const quint32& vkid) {
 
     unregisterAmpHotkey();
 
+    // The rule method uses the same hotkey to suspend and resume the rule.
+    if(selectedActivationMethod == ACTIVATION_METHOD::RULE && vkid) {
+        registerAmpHotkey();
+    }
+
     if(selectedActivationMethod == ACTIVATION_METHOD::HOTKEY) {
         if(vkid) {
             registerAmpHotkey();
 
             const QString& vkid_hexstr  {
-                QString { "0x%1" }.arg(vkid, 2, 16, QLatin1Char { '0' })
+                QString::fromLatin1(VkidTable::ToHexString(vkid))
             };
 
             ui->linActivationParameter->setText(vkid_hexstr);
@@ -301,47 +362,22 @@ QString MainWindowDialog::setAmpHotkeyVkid(const QString& vkid_hexstr) {
         return setAmpHotkeyVkid(0x00);
     }
 
-    char hex_conversion_buffer[5];
-
-    ZeroMemory(hex_conversion_buffer,
-               sizeof(hex_conversion_buffer));
+    quint32 vkid { 0 };
 
-    bool conversion_success { false };
-    qint32 vkid = vkid_hexstr.toInt(&conversion_success, 16);
-
-    if(conversion_success) {
-        return setAmpHotkeyVkid(static_cast<uint8_t>(vkid));
+    if(VkidTable::ParseVkid(vkid_hexstr, vkid)) {
+        return setAmpHotkeyVkid(vkid);
     } else {
-        qCritical() << "Failed to convert hexadecimal VKID string into an integer \"" << vkid_hexstr << "\"";
+        qCritical() << "Failed to convert VKID string into an integer \"" << vkid_hexstr << "\"";
         return QString {};    // Return empty QString on conversion failure.
     }
 }
 
 bool MainWindowDialog::registerAmpHotkey() {
-    BOOL result { RegisterHotKey(HWND(winId()), ampHotkeyId, MOD_NOREPEAT | ampHotkeyModifiersBitmask, ampHotkeyVkid) };
-
-    qInfo() << "RegisterHotKey(HWND(winId), 0x"
-            << QString::number(ampHotkeyId, 16)
-            << ", MOD_NOREPEAT | "
-            << QString::number(ampHotkeyModifiersBitmask)
-            << ", 0x"
-            << QString::number(ampHotkeyVkid, 16)
-            << ") returned "
-            << (result ? "true" : "false");
-
-    return result;
+    return hotkeyRegistry.Register(HOTKEY_ACTION::TOGGLE_LOCK, ampHotkeyModifiersBitmask, ampHotkeyVkid);
 }
 
 bool MainWindowDialog::unregisterAmpHotkey() {
-    BOOL result { UnregisterHotKey(HWND(winId()), ampHotkeyId) };
-
-    if(result) {
-        qInfo() << "UnregisterHotKey(HWND(winId), 0x"
-                << QString::number(ampHotkeyId, 16)
-                << ") returned true";
-    }
-
-    return result;
+    return hotkeyRegistry.Unregister(HOTKEY_ACTION::TOGGLE_LOCK);
 }
 
 void MainWindowDialog::setAmToHotkey() {
@@ -359,11 +395,7 @@ void MainWindowDialog::setAmToHotkey() {
     ampHotkeyModifiersBitmask = ampwHotkeyModifierDropdown->GetModifierCheckStateAsBitmask();
 
     if(ampHotkeyVkid) {
-        const QString& vkid_hexstr  {
-            QString { "0x%1" }.arg(ampHotkeyVkid, 2, 16, QChar { '0' })
-        };
-
-        ui->linActivationParameter->setText(vkid_hexstr);
+        ui->linActivationParameter->setText(QLatin1String { VkidTable::ToHexString(ampHotkeyVkid) });
 
         registerAmpHotkey();
     }
@@ -385,12 +417,243 @@ void MainWindowDialog::unsetAmToHotkey() {
 }
 
 void MainWindowDialog::activateBecauseTargetHotkeyWasPressed() {
-    if(toggleCursorLockState()) {
-        qInfo() << "Activated cursor lock via hotkey.";
-        seLockActivated.play();
+    dispatchActivationEvent(ActivationEvent::TYPE::HOTKEY);
+}
+
+
+
+
+// Global Hotkey Registry
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void MainWindowDialog::applyActionHotkeys(const QMap<QString, JsonSettingsDialog::HotkeyBinding>& action_hotkeys) {
+    for(auto iterator { action_hotkeys.cbegin() }; iterator != action_hotkeys.cend(); ++iterator) {
+        const HOTKEY_ACTION& action { HotkeyRegistry::ActionResolverSTOA.value(iterator.key(), HOTKEY_ACTION::NOTHING) };
+
+        // TOGGLE_LOCK belongs to the hotkey activation method, and is only registered while that method is selected.
+        if(action == HOTKEY_ACTION::NOTHING || action == HOTKEY_ACTION::TOGGLE_LOCK) {
+            continue;
+        }
+
+        quint32 vkid { 0 };
+
+        if(VkidTable::ParseVkid(iterator.value().Vkid, vkid)) {
+            hotkeyRegistry.Register(action, iterator.value().ModifierBitmask, vkid);
+        } else {
+            hotkeyRegistry.Unregister(action);
+        }
+    }
+}
+
+void MainWindowDialog::dispatchHotkeyAction(HOTKEY_ACTION action) {
+    switch(action) {
+    case HOTKEY_ACTION::TOGGLE_LOCK :
+        emit targetHotkeyWasPressed();
+        break;
+
+    case HOTKEY_ACTION::FORCE_LOCK :
+        if(!cursorLock.IsEnabled()) {
+            setCursorLockEnabled(true);
+
+            if(cursorLock.IsEnabled()) {
+                qInfo() << "Activated cursor lock via force lock hotkey.";
+                soundMixer.Trigger(SOUND_CUE::LOCK_ACTIVATED);
+                recordLockOverride(true);
+            }
+        }
+        break;
+
+    case HOTKEY_ACTION::FORCE_UNLOCK :
+        if(cursorLock.IsEnabled()) {
+            setCursorLockEnabled(false);
+            qInfo() << "Deactivated cursor lock via force unlock hotkey.";
+            soundMixer.Trigger(SOUND_CUE::LOCK_DEACTIVATED);
+            recordLockOverride(false);
+        }
+        break;
+
+    case HOTKEY_ACTION::TOGGLE_MUTE :
+        toggleSoundEffectsMuted();
+        break;
+
+    case HOTKEY_ACTION::RECLIP :
+        // Re-applies the clip to the current foreground window, e.g. after it was moved or resized.
+        if(cursorLock.IsEnabled()) {
+            setCursorLockEnabled(true);
+        }
+        break;
+
+    case HOTKEY_ACTION::COUNT :
+    case HOTKEY_ACTION::NOTHING :
+        break;
+    }
+}
+
+
+
+
+// Low-Level Keyboard Hook
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void MainWindowDialog::setLowLevelHookEnabled(bool state) {
+    if(state && lowLevelKeyboardHook == nullptr) {
+        lowLevelKeyboardHook = new LowLevelKeyboardHook { cursorLock, soundMixer };
+
+        connect(lowLevelKeyboardHook, &LowLevelKeyboardHook::ActionPerformed,
+                this,                 &MainWindowDialog::onLowLevelHookActionPerformed,
+                Qt::QueuedConnection);
+
+        hotkeyRegistry.SetLowLevelHook(lowLevelKeyboardHook);
+        lowLevelKeyboardHook->SetKeySequenceTrie(keySequenceTrie);
+        lowLevelKeyboardHook->SetToggleDeferred(selectedActivationMethod == ACTIVATION_METHOD::RULE);
+        lowLevelKeyboardHook->start(QThread::TimeCriticalPriority);
+    } else if(!state && lowLevelKeyboardHook != nullptr) {
+        hotkeyRegistry.SetLowLevelHook(nullptr);
+        lowLevelKeyboardHook->Stop();
+
+        delete lowLevelKeyboardHook;
+        lowLevelKeyboardHook = nullptr;
+    }
+}
+
+void MainWindowDialog::applyKeySequences(const QMap<QString, QString>& key_sequences) {
+    KeySequenceTrie::BindingList bindings;
+
+    for(auto iterator { key_sequences.cbegin() }; iterator != key_sequences.cend(); ++iterator) {
+        KeySequenceTrie::Sequence sequence;
+        QString parse_error;
+
+        if(iterator.value().isEmpty()) {
+            continue;
+        }
+
+        if(KeySequenceTrie::ParseSequence(iterator.value(), sequence, &parse_error)) {
+            bindings.append(qMakePair(sequence, HotkeyRegistry::ActionResolverSTOA.value(iterator.key(), HOTKEY_ACTION::NOTHING)));
+        } else {
+            qWarning() << "Ignoring key sequence" << iterator.value() << "for action" << iterator.key() << "--" << parse_error;
+        }
+    }
+
+    std::shared_ptr<KeySequenceTrie> compiled_trie { std::make_shared<KeySequenceTrie>() };
+    QString compile_error;
+
+    if(!compiled_trie->Compile(bindings, &compile_error)) {
+        qCritical() << "Failed to compile key sequences:" << compile_error;
+        compiled_trie.reset();
+    } else if(compiled_trie->IsEmpty()) {
+        compiled_trie.reset();
     } else {
-        qInfo() << "Deactivated cursor lock via hotkey.";
-        seLockDeactivated.play();
+        qInfo() << "Compiled" << bindings.size() << "key sequences.";
+    }
+
+    keySequenceTrie = compiled_trie;
+
+    if(lowLevelKeyboardHook != nullptr) {
+        lowLevelKeyboardHook->SetKeySequenceTrie(keySequenceTrie);
+    }
+}
+
+void MainWindowDialog::onLowLevelHookActionPerformed(HOTKEY_ACTION action, bool deferred, bool cursor_lock_state, quint32 latency_ms) {
+    // Deferred actions go through the same path as WM_HOTKEY, which also gets them into the activation engine and the recording.
+    if(deferred) {
+        dispatchHotkeyAction(action);
+    } else if(action == HOTKEY_ACTION::TOGGLE_LOCK || action == HOTKEY_ACTION::FORCE_LOCK || action == HOTKEY_ACTION::FORCE_UNLOCK) {
+        qInfo() << (cursor_lock_state ? "Activated" : "Deactivated")
+                << "cursor lock via low-level hook action"
+                << HotkeyRegistry::ActionResolverATOS.value(action);
+
+        recordLockOverride(cursor_lock_state);
+    }
+
+    // Comparable with the WM_HOTKEY latency logged in nativeEvent, as both are measured against the GetTickCount() time base.
+    qDebug() << "Low-level hook performed action"
+             << HotkeyRegistry::ActionResolverATOS.value(action)
+             << QString::number(latency_ms)
+             << "ms after the key event.";
+}
+
+
+
+
+// Activation Engine
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void MainWindowDialog::dispatchActivationEvent(ActivationEvent::TYPE type, quint64 value, const QString& text) {
+    const ActivationEvent event {
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(),
+        type,
+        value,
+        text
+    };
+
+    activationRecorder.Record(event);
+    applyActivationDecision(activationEngine.Process(event));
+}
+
+// The lock has already changed, so the decision isn't applied; a replay's simulated lock follows it instead.
+void MainWindowDialog::recordLockOverride(bool lock_state) {
+    const ActivationEvent event {
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(),
+        ActivationEvent::TYPE::LOCK_OVERRIDDEN,
+        lock_state ? quint64 { 1 } : quint64 { 0 },
+        QString {}
+    };
+
+    activationRecorder.Record(event);
+    activationEngine.Process(event);
+}
+
+void MainWindowDialog::applyActivationDecision(const ActivationEngine::Decision& decision) {
+    const ACTIVATION_METHOD& method { activationEngine.GetMethod() };
+
+    // Not a QString, which would be allocated on every decision rather than only when it's logged.
+    const char* target_kind {
+        method == ACTIVATION_METHOD::PROCESS_IMAGE ? "process"           :
+        method == ACTIVATION_METHOD::RULE          ? "rule"              :
+        method == ACTIVATION_METHOD::FULLSCREEN    ? "fullscreen window" :
+                                                     "window"
+    };
+
+    switch(decision.Action) {
+    case ActivationEngine::LOCK_ACTION::LOCK :
+        setCursorLockEnabled(true);
+        break;
+
+    case ActivationEngine::LOCK_ACTION::UNLOCK :
+        setCursorLockEnabled(false);
+        break;
+
+    case ActivationEngine::LOCK_ACTION::TOGGLE :
+        if(toggleCursorLockState()) {
+            qInfo() << "Activated cursor lock via hotkey.";
+            soundMixer.Trigger(SOUND_CUE::LOCK_ACTIVATED);
+        } else {
+            qInfo() << "Deactivated cursor lock via hotkey.";
+            soundMixer.Trigger(SOUND_CUE::LOCK_DEACTIVATED);
+        }
+        break;
+
+    case ActivationEngine::LOCK_ACTION::NONE :
+        break;
+    }
+
+    if(decision.Missed) {
+        (method == ACTIVATION_METHOD::PROCESS_IMAGE ? imageMissesMetric      :
+         method == ACTIVATION_METHOD::RULE          ? ruleMissesMetric       :
+         method == ACTIVATION_METHOD::FULLSCREEN    ? fullscreenMissesMetric :
+                                                      titleMissesMetric).Increment();
+    }
+
+    switch(decision.Edge) {
+    case ActivationEngine::TARGET_EDGE::FOUND :
+        qInfo() << "Enabling lock because target" << target_kind << "was found: " << activationEngine.GetTarget();
+        soundMixer.Trigger(SOUND_CUE::LOCK_ACTIVATED);
+        break;
+
+    case ActivationEngine::TARGET_EDGE::LOST :
+        qInfo() << "Disabling lock because target" << target_kind << "was lost: " << activationEngine.GetTarget();
+        soundMixer.Trigger(SOUND_CUE::LOCK_DEACTIVATED);
+        break;
+
+    case ActivationEngine::TARGET_EDGE::NONE :
+        break;
     }
 }
 
@@ -399,22 +662,23 @@ void MainWindowDialog::activateBecauseTargetHotkeyWasPressed() {
 
 // Process Scanner Dialog
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void MainWindowDialog::spawnProcessScannerDialog(ProcessScanner::SCAN_SCOPE process_scanner_scope) {
+void MainWindowDialog::spawnProcessScannerDialog(ProcessSnapshotDialog::SCAN_SCOPE process_scanner_scope) {
     if(processScannerDialog == nullptr) {
-        qInfo() << "Constructing new ProcessScannerDialog instance.";
+        qInfo() << "Constructing new ProcessSnapshotDialog instance.";
 
-        processScannerDialog = new ProcessScannerDialog { this, process_scanner_scope };
+        const MemoryAudit::Scope memory_audit_scope { "process scanner dialog" };
+        processScannerDialog = new ProcessSnapshotDialog { processSnapshotService, process_scanner_scope, this };
 
         ui->btnEditActivationParameter->setEnabled(false);
         btnStartWindowGrabber->setEnabled(false);
 
-        connect(processScannerDialog, &ProcessScannerDialog::destroyed, [&](QObject*) -> void {
+        connect(processScannerDialog, &ProcessSnapshotDialog::destroyed, [&](QObject*) -> void {
             ui->btnEditActivationParameter->setEnabled(true);
             btnStartWindowGrabber->setEnabled(true);
             processScannerDialog = nullptr;
         });
 
-        connect(processScannerDialog, &ProcessScannerDialog::treeSelectionMade, [&](QString selection, HWND window_handle) -> void {
+        connect(processScannerDialog, &ProcessSnapshotDialog::treeSelectionMade, [&](QString selection, HWND window_handle) -> void {
             ui->linActivationParameter->setText(selection);
             delete processScannerDialog;
             processScannerDialog = nullptr;
@@ -431,6 +695,7 @@ void MainWindowDialog::spawnProcessScannerDialog(ProcessScanner::SCAN_SCOPE proc
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void MainWindowDialog::setAmpProcessImageName(const QString& process_image_name) {
     amParamProcessImageName = process_image_name;
+    dispatchActivationEvent(ActivationEvent::TYPE::TARGET_CHANGED, static_cast<quint64>(ACTIVATION_METHOD::PROCESS_IMAGE), process_image_name);
 
     if(selectedActivationMethod == ACTIVATION_METHOD::PROCESS_IMAGE) {
         ui->linActivationParameter->setText(amParamProcessImageName);
@@ -449,76 +714,70 @@ void MainWindowDialog::setAmToProcessImageName() {
                 << "\"";
     }
 
-    timedActivationMethodConnection = connect(timedActivationMethodTimer,   SIGNAL(timeout()),
-                                              this,                         SLOT(activateIfTargetProcessRunning()));
+    processSnapshotConnection = connect(processSnapshotService,   &ProcessSnapshotService::SnapshotPublished,
+                                        this,                     &MainWindowDialog::activateIfTargetProcessRunning);
+
+    processSnapshotService->AddSubscriber();
 
     insertActivationParameterWidget(btnSpawnProcessScanner, false);
 
     btnSpawnProcessScannerConnection = connect(btnSpawnProcessScanner, &QPushButton::clicked,
-                                               std::bind(&MainWindowDialog::spawnProcessScannerDialog, this, ProcessScanner::PROCESS_MODE));
+                                               std::bind(&MainWindowDialog::spawnProcessScannerDialog, this, ProcessSnapshotDialog::SCAN_SCOPE::PROCESS_MODE));
 
     qInfo() << "Activation method has been set to process image name.";
 }
 
 void MainWindowDialog::unsetAmToProcessImageName() {
-    disconnect(timedActivationMethodConnection);
+    if(disconnect(processSnapshotConnection)) {
+        processSnapshotService->RemoveSubscriber();
+    }
+
     removeActivationParameterWidget(btnSpawnProcessScanner);
     disconnect(btnSpawnProcessScannerConnection);
 }
 
-void MainWindowDialog::activateIfTargetProcessRunning() {
-    if(!amParamProcessImageName.size()) {
-        setCursorLockEnabled(false);
-        processHasBeenFound = false;
-        return;
-    }
-
-    HANDLE process_snapshot { CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS,  0) };
+void MainWindowDialog::activateIfTargetProcessRunning(ProcessSnapshotPtr snapshot) {
+    const QHash<quint64, QString>& known_processes { activationEngine.GetRunningProcesses() };
 
-    if(process_snapshot == INVALID_HANDLE_VALUE) {
-        qCritical() << "Invalid handle value for snapshot of type TH32CS_SNAPPROCESS. Cannot see running tasks!";
-        return;
-    }
-
-    PROCESSENTRY32 process_entry_32;
-    process_entry_32.dwSize = sizeof(PROCESSENTRY32);
-
-    if(Process32First(process_snapshot, &process_entry_32)) {
-        bool process_included_in_scan { false };
+    // Only the differences are dispatched, which keeps recordings compact; the engine's own model is the baseline.
+    for(const ProcessSnapshot::Process& process : snapshot->Processes) {
+        if(!snapshot->IsInSession(process)) {
+            continue;
+        }
 
-        do {
-            if(amParamProcessImageName == QString::fromWCharArray(process_entry_32.szExeFile)) {
-                process_included_in_scan = true;
-                break;
-            }
-        } while(Process32Next(process_snapshot, &process_entry_32));
+        const auto& known_process { known_processes.constFind(process.Pid) };
 
-        if(process_included_in_scan) {
-            setCursorLockEnabled(true);
+        if(known_process == known_processes.constEnd() || known_process.value() != process.ImageName) {
+            dispatchActivationEvent(ActivationEvent::TYPE::PROCESS_STARTED, process.Pid, process.ImageName);
+        }
+    }
 
-            if(!processHasBeenFound) {
-                qInfo() << "Enabling lock because target process was found: "
-                        << amParamProcessImageName;
+    // Collected first, as dispatching an exit changes the engine's model while it's being iterated.
+    exitedPids.clear();
 
-                processHasBeenFound = true;
+    for(auto known_process { known_processes.cbegin() }; known_process != known_processes.cend(); ++known_process) {
+        const ProcessSnapshot::Process* process { snapshot->FindProcess(static_cast<DWORD>(known_process.key())) };
 
-                seLockActivated.play();
-            }
-        } else {
-            setCursorLockEnabled(false);
+        if(process == nullptr || !snapshot->IsInSession(*process)) {
+            exitedPids.append(known_process.key());
+        }
+    }
 
-            if(processHasBeenFound) {
-                qInfo() << "Disabling lock because target process was lost: "
-                        << amParamProcessImageName;
+    for(const quint64& pid : exitedPids) {
+        dispatchActivationEvent(ActivationEvent::TYPE::PROCESS_EXITED, pid);
+    }
 
-                processHasBeenFound = false;
+    dispatchActivationEvent(ActivationEvent::TYPE::PROCESS_SCAN_COMPLETED);
 
-                seLockDeactivated.play();
-            }
+    // Losing the target no longer means it exited, as the process image method also lets go when the target loses focus.
+    if(launchOptions.WaitForProcess && selectedActivationMethod == ACTIVATION_METHOD::PROCESS_IMAGE) {
+        if(activationEngine.IsImageRunning(amParamProcessImageName)) {
+            waitedForProcessFound = true;
+        } else if(waitedForProcessFound) {
+            qInfo() << "Exiting, as --wait-for-process was given and the target process has exited.";
+            QCoreApplication::quit();
         }
     }
-
-    CloseHandle(process_snapshot);
 }
 
 
@@ -528,6 +787,7 @@ void MainWindowDialog::activateIfTargetProcessRunning() {
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void MainWindowDialog::setAmpForegroundWindowTitle(const QString& foreground_window_title) {
     amParamForegroundWindowTitle = foreground_window_title;
+    dispatchActivationEvent(ActivationEvent::TYPE::TARGET_CHANGED, static_cast<quint64>(ACTIVATION_METHOD::WINDOW_TITLE), foreground_window_title);
 
     if(selectedActivationMethod == ACTIVATION_METHOD::WINDOW_TITLE) {
         ui->linActivationParameter->setText(amParamForegroundWindowTitle);
@@ -554,7 +814,7 @@ void MainWindowDialog::setAmToForegroundWindowTitle() {
     insertActivationParameterWidget(btnSpawnProcessScanner, false);
 
     btnSpawnProcessScannerConnection = connect(btnSpawnProcessScanner, &QPushButton::clicked,
-                                               std::bind(&MainWindowDialog::spawnProcessScannerDialog, this, ProcessScanner::WINDOW_MODE));
+                                               std::bind(&MainWindowDialog::spawnProcessScannerDialog, this, ProcessSnapshotDialog::SCAN_SCOPE::WINDOW_MODE));
 }
 
 void MainWindowDialog::unsetAmToForegroundWindowTitle() {
@@ -565,101 +825,222 @@ void MainWindowDialog::unsetAmToForegroundWindowTitle() {
 }
 
 void MainWindowDialog::activateIfForegroundWindowMatchesTarget() {
-    if(!amParamForegroundWindowTitle.size()) {
-        setCursorLockEnabled(false);
-        windowTitleHasBeenFound = false;
+    // The watcher reports foreground changes and renames as they happen, but a title can also change without a name change event.
+    const MemoryAudit::AllocationCounter allocation_counter { titleAllocationsMetric };
+
+    // Compared in place, so that a QString is only allocated when the title actually changed.
+    const HWND foreground_window_hwnd { GetForegroundWindow() };
+    const QStringView& foreground_window_title { WindowIdentity::ReadWindowTitle(foreground_window_hwnd, foregroundTitleBuffer) };
+
+    if(foreground_window_title != activationEngine.GetForegroundTitle()) {
+        dispatchActivationEvent(ActivationEvent::TYPE::FOREGROUND_CHANGED, reinterpret_cast<quint64>(foreground_window_hwnd), foreground_window_title.toString());
+    }
+
+    dispatchActivationEvent(ActivationEvent::TYPE::TITLE_CHECK);
+}
+
+void MainWindowDialog::onForegroundWindowChanged(WindowIdentity identity) {
+    // Location changes are only hooked for the foreground process, so the new window may have moved unnoticed while in the background.
+    cursorLock.OnWindowGeometryChanged(identity.Handle);
+
+    if(identity.ImageName != activationEngine.GetForegroundImage()) {
+        dispatchActivationEvent(ActivationEvent::TYPE::FOREGROUND_OWNER_CHANGED, identity.Pid, identity.ImageName);
+    }
+
+    // In between, so that the fullscreen method judges the new window by its new owner and its own state, rather than the previous window's.
+    updateFullscreenState(identity.Handle, foregroundWindowWatcher->GetLastEventTime());
+
+    dispatchActivationEvent(ActivationEvent::TYPE::FOREGROUND_CHANGED, reinterpret_cast<quint64>(identity.Handle), identity.Title);
+}
+
+
+
+// Rule Activation Method
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+QString MainWindowDialog::setAmpActivationRule(const QString& activation_rule) {
+    QString rule_error;
+
+    // Compiled here only to report errors; the engine compiles its own copy from the dispatched event.
+    if(!activation_rule.isEmpty() && !ActivationRule {}.Compile(activation_rule, &rule_error)) {
+        qCritical() << "Invalid activation rule \"" << activation_rule << "\":" << rule_error;
+    }
+
+    amParamActivationRule = activation_rule;
+    dispatchActivationEvent(ActivationEvent::TYPE::TARGET_CHANGED, static_cast<quint64>(ACTIVATION_METHOD::RULE), activation_rule);
+
+    if(selectedActivationMethod == ACTIVATION_METHOD::RULE) {
+        ui->linActivationParameter->setText(amParamActivationRule);
+    }
+
+    return rule_error;
+}
+
+void MainWindowDialog::setAmToRule() {
+    selectedActivationMethod = ACTIVATION_METHOD::RULE;
+    ui->linActivationParameter->setPlaceholderText("Rule, e.g. running(\"SkyrimSE.exe\") and title(\"Skyrim Special Edition\") and not suspended");
+
+    if(amParamActivationRule.size()) {
+        ui->linActivationParameter->setText(amParamActivationRule);
+    }
+
+    // running() predicates are fed by the same snapshots as the process image method, title() predicates by foregroundWindowWatcher.
+    processSnapshotConnection = connect(processSnapshotService,   &ProcessSnapshotService::SnapshotPublished,
+                                        this,                     &MainWindowDialog::activateIfTargetProcessRunning);
+
+    processSnapshotService->AddSubscriber();
+
+    // The activation method hotkey toggles the suspended predicate, so the low-level hook mustn't toggle the lock itself.
+    connect(this, &MainWindowDialog::targetHotkeyWasPressed,
+            this, &MainWindowDialog::activateBecauseTargetHotkeyWasPressed);
+
+    if(lowLevelKeyboardHook != nullptr) {
+        lowLevelKeyboardHook->SetToggleDeferred(true);
+    }
+
+    if(ampHotkeyVkid) {
+        registerAmpHotkey();
+    }
+
+    qInfo() << "Activation method has been set to rule.";
+}
+
+void MainWindowDialog::unsetAmToRule() {
+    if(selectedActivationMethod != ACTIVATION_METHOD::RULE) {
         return;
     }
 
-    wchar_t window_title_buffer[256];
-    ZeroMemory(window_title_buffer, sizeof(window_title_buffer));
+    if(disconnect(processSnapshotConnection)) {
+        processSnapshotService->RemoveSubscriber();
+    }
 
-    HWND foreground_window { GetForegroundWindow() };
-    GetWindowText(foreground_window, window_title_buffer, sizeof(window_title_buffer));
+    disconnect(this, &MainWindowDialog::targetHotkeyWasPressed,
+               this, &MainWindowDialog::activateBecauseTargetHotkeyWasPressed);
 
-    if(amParamForegroundWindowTitle == QString::fromWCharArray(window_title_buffer)) {
-        setCursorLockEnabled(true);
+    if(lowLevelKeyboardHook != nullptr) {
+        lowLevelKeyboardHook->SetToggleDeferred(false);
+    }
 
-        if(!windowTitleHasBeenFound) {
-            qInfo() << "Enabling lock because target window was found: "
-                    << amParamForegroundWindowTitle;
+    unregisterAmpHotkey();
+}
 
-            windowTitleHasBeenFound = true;
 
-            seLockActivated.play();
-        }
-    } else {
-        setCursorLockEnabled(false);
 
-        if(windowTitleHasBeenFound) {
-            qInfo() << "Disabling lock because target window was lost: "
-                    << amParamForegroundWindowTitle;
+// Fullscreen Activation Method
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void MainWindowDialog::setAmpFullscreenExclusions(const QString& fullscreen_exclusions) {
+    amParamFullscreenExclusions = fullscreen_exclusions;
+    dispatchActivationEvent(ActivationEvent::TYPE::TARGET_CHANGED, static_cast<quint64>(ACTIVATION_METHOD::FULLSCREEN), fullscreen_exclusions);
+
+    if(selectedActivationMethod == ACTIVATION_METHOD::FULLSCREEN) {
+        ui->linActivationParameter->setText(amParamFullscreenExclusions);
+    }
+}
+
+void MainWindowDialog::setAmToFullscreen() {
+    selectedActivationMethod = ACTIVATION_METHOD::FULLSCREEN;
+    ui->linActivationParameter->setPlaceholderText("Image names to ignore, e.g. vlc.exe, chrome.exe");
+
+    // Also fills in linActivationParameter. Re-dispatching the exclusions has the engine check the current foreground window right away, rather than on the next focus change.
+    setAmpFullscreenExclusions(amParamFullscreenExclusions);
+
+    qInfo() << "Activation method has been set to fullscreen.";
+}
+
+void MainWindowDialog::updateFullscreenState(HWND window_handle, DWORD event_time) {
+    if(!fullscreenDetector.Update(window_handle)) {
+        return;
+    }
+
+    dispatchActivationEvent(ActivationEvent::TYPE::SOURCE_CHANGED, fullscreenDetector.IsFullscreen() ? 1 : 0, ActivationEngine::FullscreenSourceName);
+
+    // Measured against the GetTickCount() time base, like the WM_HOTKEY latency; the initial check has no event to measure from.
+    if(event_time) {
+        const quint32& latency_ms { GetTickCount() - event_time };
+        fullscreenLatencyMetric.Observe(latency_ms * 1000ull);
+
+        qDebug() << "Foreground window"
+                 << (fullscreenDetector.IsFullscreen() ? "became" : "is no longer")
+                 << "fullscreen, detected"
+                 << QString::number(latency_ms)
+                 << "ms after the event.";
+    }
+}
+
+
+
+// Power State Monitor
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void MainWindowDialog::onIdleStateChanged(bool idle) {
+    processSnapshotService->SetPaused(idle);    // Takes its own catch-up snapshot on resume.
 
-            windowTitleHasBeenFound = false;
-            seLockDeactivated.play();
+    if(selectedActivationMethod == ACTIVATION_METHOD::WINDOW_TITLE) {
+        if(idle) {
+            timedActivationMethodTimer->stop();
+        } else {
+            timedActivationMethodTimer->start(500);
+            activateIfForegroundWindowMatchesTarget();
         }
     }
+
+    controlServer->PublishEvent(idle ? "paused" : "resumed");
 }
 
 
 
 // Foreground Window Grabber
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-void MainWindowDialog::onWindowGrabberTimerTimeout() {
-    const auto& stop_and_reset {
-        [&]() -> void {
-            btnStartWindowGrabber->setText("Grab");
+void MainWindowDialog::stopWindowGrabber() {
+    windowGrabberDeadlineTimer->stop();
 
-            windowGrabberTimer->stop();
-            windowGrabberTimerTimeoutCounter = 0;
+    if(disconnect(windowGrabberConnection)) {
+        foregroundWindowWatcher->RemoveSubscriber();
+    }
 
-            ui->linActivationParameter->clear();
-            ui->linActivationParameter->setEnabled(true);
-            ui->btnEditActivationParameter->setEnabled(true);
-            btnSpawnProcessScanner->setEnabled(true);
-        }};
+    btnStartWindowGrabber->setText("Grab");
 
-    if(++windowGrabberTimerTimeoutCounter > windowGrabberTimerMaxTimeouts) {
-        stop_and_reset();
-    } else {
-        ui->linActivationParameter->setText(
-                    "Switch to target window within timeframe: "
-                    + QString::number(windowGrabberTimerTimeoutCounter)
-                    + " / "
-                    + QString::number(windowGrabberTimerMaxTimeouts)
-                    );
+    ui->linActivationParameter->clear();
+    ui->linActivationParameter->setEnabled(true);
+    ui->btnEditActivationParameter->setEnabled(true);
+    btnSpawnProcessScanner->setEnabled(true);
+}
 
-        HWND foreground_window { GetForegroundWindow() };
+void MainWindowDialog::onWindowGrabberForegroundChanged(WindowIdentity identity) {
+    // Bringing this program's own windows (e.g. the process scanner) to the foreground doesn't count as a selection.
+    if(!identity.IsValid() || identity.Pid == GetCurrentProcessId()) {
+        return;
+    }
 
-        // Other window has been selected, as foreground_window doesn't match this program's window.
-        if(foreground_window != HWND(winId())) {
-            stop_and_reset();
+    stopWindowGrabber();
+    soundMixer.Trigger(SOUND_CUE::WINDOW_GRABBER_TICK);
 
-            wchar_t window_title[256];
-            ZeroMemory(window_title, sizeof(window_title));
-            qint32 bytes_written { GetWindowText(foreground_window, window_title, sizeof(window_title)) };
+    grabbedWindowIdentity = identity;
 
-            qInfo() << "GetWindowText() wrote "
-                    << QString::number(bytes_written)
-                    << " bytes to char window_title[256]";
+    qInfo() << "Grabbed foreground window"
+            << grabbedWindowIdentity.Title
+            << "of class" << grabbedWindowIdentity.ClassName
+            << "owned by" << grabbedWindowIdentity.ImageName
+            << "with PID" << grabbedWindowIdentity.Pid;
 
-            if(selectedActivationMethod == ACTIVATION_METHOD::WINDOW_TITLE && ui->btnEditActivationParameter->text() == "Confirm") {
-                ui->btnEditActivationParameter->setText("Edit");
+    if(selectedActivationMethod == ACTIVATION_METHOD::WINDOW_TITLE && ui->btnEditActivationParameter->text() == "Confirm") {
+        ui->btnEditActivationParameter->setText("Edit");
 
-                ui->linActivationParameter->setEnabled(false);
-                ui->cbxActivationMethod->setEnabled(true);
+        ui->linActivationParameter->setEnabled(false);
+        ui->cbxActivationMethod->setEnabled(true);
 
-                btnSpawnProcessScanner->setEnabled(false);
-                btnStartWindowGrabber->setEnabled(false);
+        btnSpawnProcessScanner->setEnabled(false);
+        btnStartWindowGrabber->setEnabled(false);
 
-                setAmpForegroundWindowTitle(QString::fromWCharArray(window_title));
-            }
-        } else {
-            seWindowGrabberTick.play();
-        }
+        setAmpForegroundWindowTitle(grabbedWindowIdentity.Title);
     }
 }
 
+void MainWindowDialog::onWindowGrabberDeadlineExpired() {
+    qInfo() << "Window grabber timed out without another window being brought to the foreground.";
+
+    stopWindowGrabber();
+    soundMixer.Trigger(SOUND_CUE::WINDOW_GRABBER_TICK);
+}
+
 void MainWindowDialog::onWindowGrabberButtonClicked() {
     if(btnStartWindowGrabber->text() == "Grab") {
         btnStartWindowGrabber->setText("Stop");
@@ -668,17 +1049,19 @@ void MainWindowDialog::onWindowGrabberButtonClicked() {
         ui->btnEditActivationParameter->setEnabled(false);
         btnSpawnProcessScanner->setEnabled(false);
 
-        windowGrabberTimer->start(500);
-    } else if(btnStartWindowGrabber->text() == "Stop") {
-        btnStartWindowGrabber->setText("Grab");
+        ui->linActivationParameter->setText(
+                    "Switch to the target window within "
+                    + QString::number(windowGrabberTimeoutMs / 1000.0, 'g', 2)
+                    + " seconds"
+                    );
 
-        windowGrabberTimer->stop();
-        windowGrabberTimerTimeoutCounter = 0;
+        windowGrabberConnection = connect(foregroundWindowWatcher,    &ForegroundWindowWatcher::ForegroundWindowChanged,
+                                          this,                       &MainWindowDialog::onWindowGrabberForegroundChanged);
 
-        ui->linActivationParameter->clear();
-        ui->linActivationParameter->setEnabled(true);
-        ui->btnEditActivationParameter->setEnabled(true);
-        btnSpawnProcessScanner->setEnabled(true);
+        foregroundWindowWatcher->AddSubscriber();
+        windowGrabberDeadlineTimer->start(windowGrabberTimeoutMs);
+    } else if(btnStartWindowGrabber->text() == "Stop") {
+        stopWindowGrabber();
     }
 }
 
@@ -688,6 +1071,7 @@ void MainWindowDialog::onWindowGrabberButtonClicked() {
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void MainWindowDialog::spawnJsonSettingsDialog() {
     if(jsonSettingsDialog == nullptr) {
+        const MemoryAudit::Scope memory_audit_scope { "JSON settings dialog" };
         jsonSettingsDialog = new JsonSettingsDialog { jsonConfigFilePath, this };
 
         connect(jsonSettingsDialog, &JsonSettingsDialog::destroyed, [&]() -> void {
@@ -709,8 +1093,19 @@ void MainWindowDialog::loadAndApplyJsonSettings() {
         if(bytes_read > 0) {
             setAmpForegroundWindowTitle(json_settings.ForegroundWindowTitle);
             setAmpProcessImageName(json_settings.ProcessImageName);
+            setAmpActivationRule(json_settings.RuleExpression);
+            setAmpFullscreenExclusions(json_settings.FullscreenExclusions);
             setAmpHotkeyVkid(json_settings.HotkeyVkid);
             setSoundEffectsMutedState(json_settings.InitialMuteState);
+            applyKeySequences(json_settings.KeySequences);
+
+            if(!json_settings.LowLevelHook && keySequenceTrie != nullptr) {
+                qInfo() << "Enabling the low-level keyboard hook, as key sequences can't be detected with RegisterHotKey.";
+            }
+
+            setLowLevelHookEnabled(json_settings.LowLevelHook || keySequenceTrie != nullptr);
+            applyActionHotkeys(json_settings.ActionHotkeys);
+            cursorLock.SetClipPolicy(json_settings.Clip);
             ampwHotkeyModifierDropdown->SetModifierCheckStateFromBitmask(json_settings.HotkeyModifierBitmask);
             changeActivationMethod(json_settings.ActivationMethod);
 
@@ -723,7 +1118,9 @@ void MainWindowDialog::loadAndApplyJsonSettings() {
                         << QString::number(bytes_read);
         }
     } else {
-        QMessageBox::information(this, "Generating New JSON File", "The required defaults.json file could not be found, generating a new one at this location: " + json_file_info.absoluteFilePath());
+        if(!launchOptions.Headless) {
+            QMessageBox::information(this, "Generating New JSON File", "The required defaults.json file could not be found, generating a new one at this location: " + json_file_info.absoluteFilePath());
+        }
 
         qInfo() << "Generating a new JSON config file at this location, because an existing one could not be found:"
                 << json_file_info.absoluteFilePath();
@@ -741,25 +1138,75 @@ void MainWindowDialog::loadAndApplyJsonSettings() {
         }
     }
 
-    loadAndApplyQssStylesheet(json_settings.StylesheetPath);
+    // The window is never shown in headless mode, so there's nothing to style.
+    if(!launchOptions.Headless) {
+        loadAndApplyQssStylesheet(json_settings.StylesheetPath);
+    }
+}
+
+
+// Launch Options
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+void MainWindowDialog::applyLaunchOptions() {
+    if(!launchOptions.TargetImage.isEmpty()) {
+        setAmpProcessImageName(launchOptions.TargetImage);
+    } else if(!launchOptions.TargetTitle.isEmpty()) {
+        setAmpForegroundWindowTitle(launchOptions.TargetTitle);
+    } else if(!launchOptions.TargetRule.isEmpty()) {
+        setAmpActivationRule(launchOptions.TargetRule);
+    } else if(!launchOptions.Hotkey.isEmpty()) {
+        setAmpHotkeyVkid(launchOptions.Hotkey);
+    }
+
+    // The parameters are set first, so that the method picks them up as it's selected.
+    if(!launchOptions.Method.isEmpty()) {
+        changeActivationMethod(launchOptions.Method == "none" ? QString {} : launchOptions.Method);
+    }
+
+    if(launchOptions.Lock || launchOptions.LockForMs > 0) {
+        setCursorLockEnabled(true);
+    } else if(launchOptions.Unlock) {
+        setCursorLockEnabled(false);
+    } else if(launchOptions.Toggle) {
+        toggleCursorLockState();
+    }
+
+    if(launchOptions.Lock || launchOptions.LockForMs > 0 || launchOptions.Unlock || launchOptions.Toggle) {
+        recordLockOverride(cursorLock.IsEnabled());
+    }
+
+    if(launchOptions.LockForMs > 0) {
+        qInfo() << "Locked for" << launchOptions.LockForMs << "ms, as --lock-for was given.";
+
+        // LaunchOptions::ParseDuration rejects anything above MaxDurationMs, so the narrowing is lossless.
+        QTimer::singleShot(static_cast<int>(launchOptions.LockForMs), this, [this]() -> void {
+            qInfo() << "Exiting, as the --lock-for duration has elapsed.";
+
+            changeActivationMethod(QString {});    // Keeps the activation method from re-locking before the event loop exits.
+            setCursorLockEnabled(false);
+            QCoreApplication::quit();
+        });
+    }
 }
 
 
 // Sound Effects
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void MainWindowDialog::setSoundEffectsMutedState(bool state) {
-    soundEffectsMuted = state;
-
-    seLockActivated.setMuted(soundEffectsMuted);
-    seLockDeactivated.setMuted(soundEffectsMuted);
-    seWindowGrabberTick.setMuted(soundEffectsMuted);
+    soundMixer.SetMuted(state);
 
+    // The output stream, and with it the audio backend, is only kept open while the cues can be heard.
+    if(state) {
+        soundMixer.Stop();
+    } else if(!soundMixer.IsRunning()) {
+        const MemoryAudit::Scope memory_audit_scope { "sound" };
+        soundMixer.Start();
+    }
     ui->btnMuteSoundEffects->setText(state ? "Unmute" : "Mute");
 }
 
 void MainWindowDialog::toggleSoundEffectsMuted() {
-    soundEffectsMuted ^= true;
-    setSoundEffectsMutedState(soundEffectsMuted);
+    setSoundEffectsMutedState(!soundMixer.IsMuted());
 }
 
 
@@ -769,32 +1216,151 @@ void MainWindowDialog::toggleSoundEffectsMuted() {
 // Cursor Lock
 // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 void MainWindowDialog::setCursorLockEnabled(const bool& state) {
-    if(state) {
-        HWND foreground_window_hwnd { GetForegroundWindow() };
-        RECT foreground_window_rect;
+    cursorLock.SetEnabled(state);
+}
 
-        if(foreground_window_hwnd != nullptr && IsWindow(foreground_window_hwnd)) {
-            if(GetWindowRect(foreground_window_hwnd, &foreground_window_rect)) {
-                ClipCursor(&foreground_window_rect);
-                lastCursorLockStateSet = state;
-            }
+bool MainWindowDialog::toggleCursorLockState() {
+    return cursorLock.Toggle();
+}
+
+
+
+
+
+
+// Control Server
+// ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+QString MainWindowDialog::handleControlCommand(const QString& command, const QString& argument) {
+    qInfo() << "Control request:" << command << argument;
+
+    if(command == "ping") {
+        return "ok pong";
+    }
+
+    // The exposition spans multiple lines, so it's sent as a byte count followed by that many bytes of text.
+    if(command == "metrics") {
+        MemoryAudit::PublishMetrics();
+        activationSourceManager->PublishMetrics();
+        const QByteArray& exposition { MetricsRegistry::Instance().ToPrometheusText() };
+
+        // The response line's own terminator doubles as the exposition's final newline.
+        return "ok " + QString::number(exposition.size()) + '\n' + QString::fromUtf8(exposition.endsWith('\n') ? exposition.chopped(1) : exposition);
+    }
+
+    // Sent by a second instance that was launched without any arguments to forward.
+    if(command == "show") {
+        showNormal();
+        raise();
+        activateWindow();
+        return "ok";
+    }
+
+    // Forwarded by a second instance that was launched with --lock-for; unlike that option, it leaves this instance running.
+    qint64 lock_duration_ms { -1 };
+
+    if(command == "lock-for" && (!LaunchOptions::ParseDuration(argument, lock_duration_ms) || lock_duration_ms <= 0)) {
+        return "error not a valid duration: " + argument;
+    }
+
+    if(command == "lock" || command == "lock-for" || command == "unlock" || command == "toggle") {
+        const bool& previous_state { cursorLock.IsEnabled() };
+
+        // Whichever lock request came last decides, so an earlier lock-for no longer unlocks.
+        controlUnlockTimer->stop();
+
+        if(command == "toggle") {
+            toggleCursorLockState();
+        } else {
+            setCursorLockEnabled(command != "unlock");
         }
-    } else {
-        ClipCursor(nullptr);
-        lastCursorLockStateSet = state;
+
+        if(cursorLock.IsEnabled() != previous_state) {
+            soundMixer.Trigger(cursorLock.IsEnabled() ? SOUND_CUE::LOCK_ACTIVATED : SOUND_CUE::LOCK_DEACTIVATED);
+        }
+
+        recordLockOverride(cursorLock.IsEnabled());
+
+        if((command == "lock" || command == "lock-for") && !cursorLock.IsEnabled()) {
+            return "error there is no foreground window to lock the cursor to";
+        }
+
+        // LaunchOptions::ParseDuration rejects anything above MaxDurationMs, so the narrowing is lossless.
+        if(command == "lock-for") {
+            controlUnlockTimer->start(static_cast<int>(lock_duration_ms));
+        }
+
+        return cursorLock.IsEnabled() ? "ok locked" : "ok unlocked";
     }
-}
 
+    if(command == "method") {
+        const QString& method { argument == "none" ? QString {} : argument };
 
-bool MainWindowDialog::toggleCursorLockState() {
-    setCursorLockEnabled(lastCursorLockStateSet ^ true);
-    return lastCursorLockStateSet;
-}
+        if(!changeActivationMethod(method)) {
+            return "error method must be one of: none, hotkey, image, title, rule, fullscreen";
+        }
 
+        return "ok";
+    }
 
+    if(command == "target") {
+        const qsizetype& separator_index { argument.indexOf(' ') };
+        const QString& method    { separator_index < 0 ? argument : argument.left(separator_index) };
+        const QString& parameter { separator_index < 0 ? QString {} : argument.mid(separator_index + 1) };
 
+        if(method != "image" && method != "title" && method != "hotkey" && method != "rule" && method != "fullscreen") {
+            return "error target must be of the form: target <image|title|hotkey|rule|fullscreen> <parameter>";
+        }
 
+        if(JsonSettingsDialog::ActivationMethodResolverITOS.value(ui->cbxActivationMethod->currentIndex()) != method) {
+            changeActivationMethod(method);
+        }
 
+        if(method == "image") {
+            setAmpProcessImageName(parameter);
+            processSnapshotService->TakeSnapshot();    // Check right away, rather than up to one interval later.
+        } else if(method == "hotkey") {
+            if(setAmpHotkeyVkid(parameter).isEmpty()) {
+                return "error not a valid VKID: " + parameter;
+            }
+        } else if(method == "rule") {
+            const QString& rule_error { setAmpActivationRule(parameter) };
+
+            if(!rule_error.isEmpty()) {
+                return "error invalid rule: " + rule_error;
+            }
+        } else if(method == "fullscreen") {
+            setAmpFullscreenExclusions(parameter);
+        } else {
+            setAmpForegroundWindowTitle(parameter);
+            activateIfForegroundWindowMatchesTarget();
+        }
+
+        return "ok";
+    }
+
+    if(command == "state") {
+        const QString& method { JsonSettingsDialog::ActivationMethodResolverITOS.value(ui->cbxActivationMethod->currentIndex()) };
+        QString target;
+
+        switch(selectedActivationMethod) {
+        case ACTIVATION_METHOD::HOTKEY        : target = QString::fromLatin1(VkidTable::ToHexString(ampHotkeyVkid)); break;
+        case ACTIVATION_METHOD::PROCESS_IMAGE : target = amParamProcessImageName;                                   break;
+        case ACTIVATION_METHOD::WINDOW_TITLE  : target = amParamForegroundWindowTitle;                              break;
+        case ACTIVATION_METHOD::RULE          : target = amParamActivationRule;                                     break;
+        case ACTIVATION_METHOD::FULLSCREEN    : target = amParamFullscreenExclusions;                               break;
+        case ACTIVATION_METHOD::NOTHING       :                                                                     break;
+        }
+
+        // The target goes last, as it's the only value that may contain spaces.
+        return QString { "ok locked=%1 muted=%2 method=%3 target=%4" }.arg(
+                    cursorLock.IsEnabled() ? "1" : "0",
+                    soundMixer.IsMuted() ? "1" : "0",
+                    method.isEmpty() ? "none" : method,
+                    target);
+    }
+
+    return "error unknown command: " + command;
+}
 
 bool MainWindowDialog::nativeEvent(const QByteArray& event_type, void* message, qintptr* result) {
     Q_UNUSED(event_type)
@@ -803,12 +1369,31 @@ bool MainWindowDialog::nativeEvent(const QByteArray& event_type, void* message,
 
     MSG* msg { reinterpret_cast<MSG*>(message) };
 
+    // WM_INPUT is left for DefWindowProc even when handled, as that's what releases the raw input buffer.
+    if(msg->message == WM_INPUT) {
+        cursorEscapeWatchdog.HandleRawInput(msg);
+        return QMainWindow::nativeEvent(event_type, message, result);
+    }
+
+    if(msg->message == WM_WTSSESSION_CHANGE || msg->message == WM_POWERBROADCAST) {
+        powerStateMonitor->HandleNativeEvent(msg);
+        return QMainWindow::nativeEvent(event_type, message, result);
+    }
+
+    // Games switching the display mode when they enter or leave exclusive fullscreen land here too.
+    if(msg->message == WM_DISPLAYCHANGE) {
+        cursorLock.OnWindowGeometryChanged(nullptr);    // Monitor rectangles and DPI may have changed without the clipped window moving.
+        fullscreenDetector.InvalidateMonitors();
+        updateFullscreenState(foregroundWindowWatcher->GetForegroundWindow(), msg->time);
+        return QMainWindow::nativeEvent(event_type, message, result);
+    }
+
     /* msg->lParam Is a 64-bit integer and stores the VKID of the pressed hotkey in byte 3/8 (little-endian)
-     * and so it cannot be directly compared with ampHotkeyVkid, as it stores the VKID in byte 1/1 so the
+     * and so it cannot be directly compared with a binding's VKID, as it stores the VKID in byte 1/1 so the
      * comparison will always fail. Instead, lParam should be bitshifted 16 bits to the right so that the VKID
      * is located in byte 1/8, and then bitwise AND with 0xFF should be performed to exclude any other bits that
      * may be present in the 64-bit integer, and leave only the bits in position 1/8 which should be the VKID.
-     * After this is done, it may be compared as normal without issue.
+     * After this is done, it may be compared as normal without issue. HotkeyRegistry::Resolve does this.
      *
      *                                                  lParam >> 16
      * ????     ????     ????     ????     ????     |--VKID-----------v
@@ -816,8 +1401,22 @@ bool MainWindowDialog::nativeEvent(const QByteArray& event_type, void* message,
      * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
     if (msg->message == WM_HOTKEY) {
-        if(msg->wParam == ampHotkeyId && ((msg->lParam >> 16) & 0xFF) == ampHotkeyVkid) {
-            emit targetHotkeyWasPressed();
+        const HOTKEY_ACTION& action { hotkeyRegistry.Resolve(msg->wParam, msg->lParam) };
+
+        if(action != HOTKEY_ACTION::NOTHING) {
+            dispatchHotkeyAction(action);
+
+            // msg->time is the GetTickCount() timestamp of when the message was posted, so this measures hotkey to clip latency.
+            const quint32& latency_ms { GetTickCount() - msg->time };
+
+            hotkeyFiresMetric.Increment();
+            hotkeyLatencyMetric.Observe(latency_ms * 1000ull);
+
+            qDebug() << "Dispatched hotkey action"
+                     << HotkeyRegistry::ActionResolverATOS.value(action)
+                     << QString::number(latency_ms)
+                     << "ms after WM_HOTKEY was posted.";
+
             return true;
         }
 
@@ -840,7 +1439,7 @@ void MainWindowDialog::mousePressEvent(QMouseEvent* mouse_press_event) {
     return QMainWindow::mousePressEvent(mouse_press_event);
 }
 
-MainWindowDialog::MainWindowDialog(QWidget* parent)
+MainWindowDialog::MainWindowDialog(const LaunchOptions& launch_options, QWidget* parent)
     :
       // Debug Console & Related Widgets Initialization
 
@@ -861,33 +1460,48 @@ MainWindowDialog::MainWindowDialog(QWidget* parent)
 
       ampHotkeyModifiersBitmask           { WINMOD_NULLMOD                    },
       ampHotkeyVkid                       { 0x000                             },
-      ampHotkeyId                         { 0x1A4                             },
+
+      hotkeyRegistry                      { 0x1A4                             },
+      lowLevelKeyboardHook                { nullptr                           },
 
 
       // Process scanner member variables initialization.
       processScannerDialog                { nullptr                           },     // ProcessScannerDialog instance, must be nullptr as spawnProcessScannerDialog takes care of construction and destruction.
       btnSpawnProcessScanner              { new QPushButton          { this } },     // QPushButton connected to spawnProcessScannerDialog further down in the constructor.
 
+      processSnapshotService              { new ProcessSnapshotService { this } },
+
       timedActivationMethodTimer          { new QTimer               { this } },
 
       // Process Image Name
-      processHasBeenFound                 { false                             },
       amParamProcessImageName             { QString { "" }                    },
 
       // Foreground Window Title
-      windowTitleHasBeenFound             { false                             },
       amParamForegroundWindowTitle        { QString { "" }                    },
 
+      // Activation Rule
+      amParamActivationRule               { QString { "" }                    },
+      amParamFullscreenExclusions         { QString { "" }                    },
+      fullscreenDetector                  {                                   },
+
       // Foreground Window Grabber
-      windowGrabberTimerMaxTimeouts       { 15                                },
-      windowGrabberTimerTimeoutCounter    { NULL                              },
-      windowGrabberTimer                  { new QTimer               { this } },
+      windowGrabberTimeoutMs              { 7500                              },
+      windowGrabberDeadlineTimer          { new QTimer               { this } },
       btnStartWindowGrabber               { new QPushButton          { this } },
 
-      jsonConfigFilePath                  { "./defaults.json"                 },
+      foregroundWindowWatcher             { new ForegroundWindowWatcher { this } },
+      powerStateMonitor                   { new PowerStateMonitor    { this } },
+      activationSourceManager             { new ActivationSourceManager { this } },
+      controlServer                       { new ControlServer        { this } },
+      controlUnlockTimer                  { new QTimer               { this } },
+
+      launchOptions                       { launch_options                    },
+      waitedForProcessFound               { false                             },
+
+      jsonConfigFilePath                  { launch_options.ConfigPath         },
       jsonSettingsDialog                  { nullptr                           },
 
-      soundEffectsMuted                   { false                             }
+      cursorEscapeWatchdog                { cursorLock                        }
 
 {
     ui->setupUi(this);
@@ -905,9 +1519,16 @@ MainWindowDialog::MainWindowDialog(QWidget* parent)
 
     resize(static_cast<qint32>(minimumWidth() * 1.2), height());
 
-    seLockActivated.setSource(QUrl::fromLocalFile(":/sounds/lock-activated.wav"));
-    seLockDeactivated.setSource(QUrl::fromLocalFile(":/sounds/lock-deactivated.wav"));
-    seWindowGrabberTick.setSource(QUrl::fromLocalFile(":/sounds/window-grabber-tick.wav"));
+    hotkeyRegistry.SetWindowHandle(HWND(winId()));
+    powerStateMonitor->Register(HWND(winId()));
+
+    soundMixer.LoadCue(SOUND_CUE::LOCK_ACTIVATED,      ":/sounds/lock-activated.wav");
+    soundMixer.LoadCue(SOUND_CUE::LOCK_DEACTIVATED,    ":/sounds/lock-deactivated.wav");
+    soundMixer.LoadCue(SOUND_CUE::WINDOW_GRABBER_TICK, ":/sounds/window-grabber-tick.wav");
+
+#ifdef CURSORLOCKER_NO_SOUND
+    ui->btnMuteSoundEffects->setHidden(true);
+#endif
 
     // Set ampwHotkeyModifierDropdown initial values.
     ampwHotkeyModifierDropdown->setEnabled(false);
@@ -931,6 +1552,9 @@ MainWindowDialog::MainWindowDialog(QWidget* parent)
     btnStartWindowGrabber->setHidden(true);
     btnStartWindowGrabber->setMinimumWidth(90);
 
+    windowGrabberDeadlineTimer->setSingleShot(true);
+    controlUnlockTimer->setSingleShot(true);
+
     btnSpawnVkidTableWidgetDialog->setText("VKID Table");
     btnSpawnVkidTableWidgetDialog->setEnabled(false);
     btnSpawnVkidTableWidgetDialog->setHidden(true);
@@ -958,8 +1582,64 @@ MainWindowDialog::MainWindowDialog(QWidget* parent)
     connect(ampwHotkeyModifierDropdown,        &KbModifierListWidget::ModifierBitmaskChanged,
             this,                              &MainWindowDialog::updateHotkeyInputWithNewModifierBitmask);
 
-    connect(windowGrabberTimer,                &QTimer::timeout,
-            this,                              &MainWindowDialog::onWindowGrabberTimerTimeout);
+    connect(windowGrabberDeadlineTimer,        &QTimer::timeout,
+            this,                              &MainWindowDialog::onWindowGrabberDeadlineExpired);
+
+    connect(controlUnlockTimer,                &QTimer::timeout,
+            this,                              [this]() -> void {
+                                                   qInfo() << "Unlocking, as the duration of the lock-for request has elapsed.";
+                                                   handleControlCommand("unlock", QString {});
+                                               });
+
+    connect(foregroundWindowWatcher,           &ForegroundWindowWatcher::ForegroundWindowGeometryChanged,
+            this,                              [this](HWND window_handle) -> void {
+                                                   cursorLock.OnWindowGeometryChanged(window_handle);
+                                                   dispatchActivationEvent(ActivationEvent::TYPE::GEOMETRY_CHANGED, reinterpret_cast<quint64>(window_handle));
+                                                   updateFullscreenState(window_handle, foregroundWindowWatcher->GetLastEventTime());
+                                               });
+
+    connect(foregroundWindowWatcher,           &ForegroundWindowWatcher::ForegroundWindowChanged,
+            this,                              &MainWindowDialog::onForegroundWindowChanged);
+
+    connect(powerStateMonitor,                 &PowerStateMonitor::IdleStateChanged,
+            this,                              &MainWindowDialog::onIdleStateChanged);
+
+    connect(activationSourceManager,           &ActivationSourceManager::SourceStateChanged,
+            this,                              [this](QString name, bool active) -> void {
+                                                   dispatchActivationEvent(ActivationEvent::TYPE::SOURCE_CHANGED, active ? 1 : 0, name);
+                                               });
+
+    connect(timedActivationMethodTimer,        &QTimer::timeout,
+            this,                              []() -> void { titleWakeupsMetric.Increment(); });
+
+    connect(foregroundWindowWatcher,           &ForegroundWindowWatcher::ForegroundWindowRenamed,
+            this,                              &MainWindowDialog::onForegroundWindowChanged);
+
+    // Held for the lifetime of the dialog, so that the clip rectangle follows the locked window when it's moved or resized.
+    foregroundWindowWatcher->AddSubscriber();
+
+    // Releases the handles the owner resolver holds on to, and with them the PIDs of the processes that exited.
+    connect(processSnapshotService,            &ProcessSnapshotService::SnapshotPublished,
+            this,                              [this](ProcessSnapshotPtr snapshot) -> void {
+                                                   foregroundWindowWatcher->GetOwnerResolver().Invalidate(snapshot->RemovedPids);
+                                               });
+
+    controlServer->SetCommandHandler(std::bind(&MainWindowDialog::handleControlCommand, this, std::placeholders::_1, std::placeholders::_2));
+    controlServer->Listen();
+
+    // The lock may change state on the low-level hook thread, so the event is forwarded to the GUI thread, which owns both the
+    // control server and the window that raw input is delivered to.
+    cursorLock.SetStateChangedCallback([this](bool state) -> void {
+        QMetaObject::invokeMethod(this, [this, state]() -> void {
+            if(cursorLock.IsEnabled()) {
+                cursorEscapeWatchdog.Arm(HWND(winId()));
+            } else {
+                cursorEscapeWatchdog.Disarm();
+            }
+
+            controlServer->PublishEvent(state ? "locked" : "unlocked");
+        }, Qt::QueuedConnection);
+    });
 
     connect(btnStartWindowGrabber,             &QPushButton::clicked,
             this,                              &MainWindowDialog::onWindowGrabberButtonClicked);
@@ -987,15 +1667,44 @@ MainWindowDialog::MainWindowDialog(QWidget* parent)
 
     // QSS Stylesheet Polish Connections
     // ----------------------------------------------------------------------------------------------------
-    connect(ui->linActivationParameter,        &QLineEdit::textChanged, [&]() -> void { style()->polish(ui->linActivationParameter); });
-    connect(ampwHotkeyRecorder,                &QLineEdit::textChanged, [&]() -> void { style()->polish(ampwHotkeyRecorder);         });
+    StylesheetCache::RepolishOnEmptinessChange(ui->linActivationParameter);
+    StylesheetCache::RepolishOnEmptinessChange(ampwHotkeyRecorder);
+
+    // Opened before the settings are applied, so that the recording starts with the method and target.
+    if(!launchOptions.RecordPath.isEmpty()) {
+        if(activationRecorder.Open(launchOptions.RecordPath)) {
+            qInfo() << "Recording activation events to" << launchOptions.RecordPath;
+        } else {
+            qCritical() << "Could not open" << launchOptions.RecordPath << "to record activation events into.";
+        }
+    }
+
+    // Started after the recorder, so that the first state of every source is recorded; the states arrive through the event loop.
+    activationSourceManager->LoadPlugins(QCoreApplication::applicationDirPath() + "/plugins");
+
+    // The watcher only reports changes, so the engine is told about the window that already has focus.
+    onForegroundWindowChanged(WindowIdentity::FromHandle(foregroundWindowWatcher->GetForegroundWindow(), &foregroundWindowWatcher->GetOwnerResolver()));
 
-    // Load JSON Settings
+    // Load JSON Settings & Apply Launch Options
     // ----------------------------------------------------------------------------------------------------
-    loadAndApplyJsonSettings();    // Also responsible for loading and applying stylesheet, based on the JSON file values.
+    if(!launchOptions.SkipConfig) {
+        loadAndApplyJsonSettings();    // Also responsible for loading and applying stylesheet, based on the JSON file values.
+    } else if(!launchOptions.Headless) {
+        loadAndApplyQssStylesheet();
+    }
+
+    // Opens the sound output stream, unless the JSON settings muted the cues.
+    setSoundEffectsMutedState(soundMixer.IsMuted());
+
+    applyLaunchOptions();
 }
 
 MainWindowDialog::~MainWindowDialog() {
+    cursorLock.SetStateChangedCallback(nullptr);
+    cursorEscapeWatchdog.Disarm();
+    powerStateMonitor->Unregister();
+    activationSourceManager->UnloadPlugins();
+    setLowLevelHookEnabled(false);
     setCursorLockEnabled(false);
     delete ui;
 }
@@ -15,10 +15,14 @@
 
 #include <Windows.h>
 
+#include <chrono>
+
 #include <QtGui/QMouseEvent>
 #include <QtCore/QEvent>
 
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSet>
 #include <QtCore/QPair>
 
 #include <QtCore/QJsonDocument>
@@ -33,26 +37,40 @@
 #include <QtWidgets/QScrollBar>
 #include <QtWidgets/QMenu>
 
-#include <QtMultimedia/QSoundEffect>
 #include <QtCore/QResource>
 
 #include <hotkey_recorder_widget.hpp>
-#include <vkid_table_widget.hpp>
 
-#include "process_scanner_dialog.hxx"
+#include "process_snapshot_dialog.hxx"
+#include "process_snapshot_service.hpp"
 #include "json_settings_dialog.hxx"
 #include "vkid_table_widget_dialog.hxx"
 
 #include "keyboard_modifier_list_widget.hpp"
 #include "anonymous_event_filter.hpp"
+#include "hotkey_registry.hpp"
+#include "low_level_keyboard_hook.hpp"
+#include "cursor_lock.hpp"
+#include "cursor_escape_watchdog.hpp"
+#include "power_state_monitor.hpp"
+#include "activation_source_manager.hpp"
+#include "fullscreen_detector.hpp"
+#include "sound_mixer.hpp"
+#include "foreground_window_watcher.hpp"
+#include "control_server.hpp"
+#include "metrics_registry.hpp"
+#include "launch_options.hpp"
+#include "stylesheet_cache.hpp"
+#include "activation_engine.hpp"
+#include "activation_recording.hpp"
+#include "memory_audit.hpp"
+#include "vkid_table.hpp"
 
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindowDialog; }
 QT_END_NAMESPACE
 
-enum struct ACTIVATION_METHOD;
-
 class MainWindowDialog : public QMainWindow {
 Q_OBJECT
 protected:
@@ -60,7 +78,10 @@ protected:
 
     const QString styleSheetFilePath;
 
-    Q_SLOT qsizetype loadQssStylesheet(const QString&, QByteArray& out_bytes) const;
+    StylesheetCache    styleSheetCache;               // Compiled stylesheets, so that reloading the settings doesn't re-read or re-apply an unchanged stylesheet.
+    QByteArray         appliedStyleSheetHash;         // ContentHash of the stylesheet that was last passed to setStyleSheet.
+    QString            registeredResourceFilePath;    // The .rcc file that was last registered alongside a stylesheet.
+
     Q_SLOT qsizetype loadAndApplyQssStylesheet(const QString&);
     Q_SLOT qsizetype loadAndApplyQssStylesheet();
 
@@ -101,13 +122,12 @@ protected:
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
     quint32        ampHotkeyModifiersBitmask;                  // Bitmask that stores the WinApi modifier key bitmask values that will be used to register the hotkey.
     quint32        ampHotkeyVkid;                              // The virtual key ID that identifies the target key that will be used to register the hotkey.
-    quint32        ampHotkeyId;                                // The ID used by WinApi to identify the registered hotkey, which can later be used to unregister it.
 
     QString        setAmpHotkeyVkid(const quint32&);           // Changes the VKID that will be used for the hotkey to another value.
     QString        setAmpHotkeyVkid(const QString&);           // Overload that converts the QString into a quint32 before passing it to the primary overload.
 
-    bool           registerAmpHotkey();                        // Registers a WinAPI hotkey using ampHotkeyId and ampHotkeyVkid.
-    bool           unregisterAmpHotkey();                      // Unregisters the hotkey previously registered with ampHotkeyId.
+    bool           registerAmpHotkey();                        // Registers ampHotkeyVkid as the HOTKEY_ACTION::TOGGLE_LOCK binding of hotkeyRegistry.
+    bool           unregisterAmpHotkey();                      // Unregisters the HOTKEY_ACTION::TOGGLE_LOCK binding.
 
     void           setAmToHotkey();                            // Set the activation method to hotkey.
     void           unsetAmToHotkey();                          // Unset the hotkey activation method.
@@ -115,13 +135,48 @@ protected:
     Q_SLOT void    activateBecauseTargetHotkeyWasPressed();
 
 
+    // Global Hotkey Registry
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    HotkeyRegistry    hotkeyRegistry;                          // Owns every registered global hotkey; the activation method hotkey is its HOTKEY_ACTION::TOGGLE_LOCK binding.
+
+    void              applyActionHotkeys(const QMap<QString, JsonSettingsDialog::HotkeyBinding>&);    // (Re-)registers the action hotkeys other than TOGGLE_LOCK.
+    void              dispatchHotkeyAction(HOTKEY_ACTION);     // Performs the action resolved from a WM_HOTKEY message.
+
+
+    // Low-Level Keyboard Hook
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    LowLevelKeyboardHook*    lowLevelKeyboardHook;             // Optional hook thread that replaces RegisterHotKey for hotkeyRegistry while it exists.
+
+    std::shared_ptr<const KeySequenceTrie>    keySequenceTrie;    // Compiled key sequences, handed to lowLevelKeyboardHook whenever it's started.
+
+    void                     setLowLevelHookEnabled(bool);     // Starts or stops lowLevelKeyboardHook, moving hotkeyRegistry's bindings accordingly.
+    void                     applyKeySequences(const QMap<QString, QString>&);    // Compiles the key sequences into keySequenceTrie.
+    Q_SLOT void              onLowLevelHookActionPerformed(HOTKEY_ACTION, bool deferred, bool cursor_lock_state, quint32 latency_ms);
+
+
+    // Activation Engine
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    ActivationEngine      activationEngine;                    // Decides when the activation methods lock and unlock; fed every event through dispatchActivationEvent.
+    ActivationRecorder    activationRecorder;                  // Records the dispatched events while --record is given, for offline replay.
+
+    void                  dispatchActivationEvent(ActivationEvent::TYPE, quint64 value = 0, const QString& text = QString {});
+    void                  applyActivationDecision(const ActivationEngine::Decision&);
+    void                  recordLockOverride(bool lock_state);    // Tells the engine and the recording about a lock change that was made around the activation methods.
+
+
     // Process Scanner Dialog
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-    ProcessScannerDialog*      processScannerDialog;                // The ProcessScannerDialog instance pointer that spawnProcessScannerDialog manages the construction and destruction of.
+    ProcessSnapshotDialog*     processScannerDialog;                // The ProcessSnapshotDialog instance pointer that spawnProcessScannerDialog manages the construction and destruction of.
     QPushButton*               btnSpawnProcessScanner;              // Button connected to spawnProcessScannerDialog; allows for the selection of window titles and process images from a dialog.
     QMetaObject::Connection    btnSpawnProcessScannerConnection;    // The connection between btnSpawnProcessScanner and spawnProcessScanerDialog, so that it may later be disconnected.
 
-    Q_SLOT void                spawnProcessScannerDialog(ProcessScanner::SCAN_SCOPE);
+    Q_SLOT void                spawnProcessScannerDialog(ProcessSnapshotDialog::SCAN_SCOPE);
+
+
+    // Process Snapshot Service
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    ProcessSnapshotService*    processSnapshotService;              // Shared process enumeration, consumed by the process image activation method and processScannerDialog.
+    QMetaObject::Connection    processSnapshotConnection;           // The connection between processSnapshotService and activateIfTargetProcessRunning, while subscribed.
 
 
     // Timer For Timed Activation Methods (Process Image Name & Foreground Window Title)
@@ -132,19 +187,18 @@ protected:
 
     // Process Image Activation Method
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-    bool           processHasBeenFound;
     QString        amParamProcessImageName;                   // The process image name that will be used for the process image name activation method.
     void           setAmpProcessImageName(const QString&);    // Changes the process image name activation method parameter to a new value.
 
     void           setAmToProcessImageName();                 // Sets the activation method for the cursor lock to process image name mode.
     void           unsetAmToProcessImageName();               // Unsets the activation method from process image name mode.
 
-    Q_SLOT void    activateIfTargetProcessRunning();
+    Q_SLOT void    activateIfTargetProcessRunning(ProcessSnapshotPtr);
+    QVector<quint64>    exitedPids;    // Scratch space of activateIfTargetProcessRunning, kept between scans so that they don't allocate.
 
 
     // Foreground Window Activation Method
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-    bool           windowTitleHasBeenFound;
     QString        amParamForegroundWindowTitle;                   // The window title that will be used for the window title activation method.
     void           setAmpForegroundWindowTitle(const QString&);    // Changes the foreground window title activation method parameter to a new value.
 
@@ -152,19 +206,74 @@ protected:
     void           unsetAmToForegroundWindowTitle();               // Unsets the activation method from foreground window title.
 
     Q_SLOT void    activateIfForegroundWindowMatchesTarget();
+    QVector<wchar_t>    foregroundTitleBuffer;    // Scratch space of activateIfForegroundWindowMatchesTarget, kept between checks so that they don't allocate.
+    Q_SLOT void    onForegroundWindowChanged(WindowIdentity);     // Also connected to renames, which the window title method reacts to all the same.
 
 
-    // Foreground Window Grabber
+    // Rule Activation Method
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-    const quint32    windowGrabberTimerMaxTimeouts;
-    quint32          windowGrabberTimerTimeoutCounter;
-    QTimer*          windowGrabberTimer;
-    QPushButton*     btnStartWindowGrabber;
+    QString        amParamActivationRule;                     // The rule expression that will be used for the rule activation method; see ActivationRule for the syntax.
+    QString        setAmpActivationRule(const QString&);      // Changes the rule activation method parameter; returns the compile error, or an empty string if the rule is valid.
+
+    void           setAmToRule();                             // Sets the activation method for the cursor lock to rule mode.
+    void           unsetAmToRule();                           // Unsets the activation method from rule mode.
 
-    Q_SLOT void      onWindowGrabberTimerTimeout();
+
+    // Fullscreen Activation Method
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    QString               amParamFullscreenExclusions;                  // Comma separated image names whose fullscreen windows the fullscreen activation method ignores.
+    void                  setAmpFullscreenExclusions(const QString&);   // Changes the fullscreen activation method parameter to a new value.
+
+    void                  setAmToFullscreen();                          // Sets the activation method for the cursor lock to fullscreen mode; there's nothing to unset, as detection always runs.
+
+    FullscreenDetector    fullscreenDetector;                           // Reported to the activation engine as the ActivationEngine::FullscreenSourceName source, whichever method is selected.
+    void                  updateFullscreenState(HWND window_handle, DWORD event_time);    // Re-checks the foreground window; event_time is the GetTickCount() timestamp of what prompted it, or 0.
+
+
+    // Foreground Window Grabber
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    const qint32               windowGrabberTimeoutMs;           // How long the grabber waits for another window to be brought to the foreground.
+    QTimer*                    windowGrabberDeadlineTimer;       // Single-shot; cancels the grab once windowGrabberTimeoutMs has passed.
+    QPushButton*               btnStartWindowGrabber;
+    QMetaObject::Connection    windowGrabberConnection;          // The connection between foregroundWindowWatcher and onWindowGrabberForegroundChanged, while grabbing.
+    WindowIdentity             grabbedWindowIdentity;            // The full identity of the most recently grabbed window.
+
+    void             stopWindowGrabber();
+    Q_SLOT void      onWindowGrabberForegroundChanged(WindowIdentity);
+    Q_SLOT void      onWindowGrabberDeadlineExpired();
     Q_SLOT void      onWindowGrabberButtonClicked();
 
 
+    // Foreground Window Watcher
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    ForegroundWindowWatcher*    foregroundWindowWatcher;         // Shared source of foreground window change events.
+
+
+    // Power State Monitor
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    PowerStateMonitor*    powerStateMonitor;                     // Pauses the polling activation methods while the session is locked, suspended or has its display off. Fed by nativeEvent.
+    Q_SLOT void           onIdleStateChanged(bool idle);
+
+
+    // Activation Source Plugins
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    ActivationSourceManager*    activationSourceManager;         // Runs the plugins from the plugins directory, whose states the rule method checks with source("<name>").
+
+
+    // Control Server
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    ControlServer*    controlServer;                           // Local IPC endpoint for external automation; see ControlServer for the protocol.
+    QTimer*           controlUnlockTimer;                      // Single-shot; ends a "lock-for" request, unless another lock request came in first.
+    QString           handleControlCommand(const QString& command, const QString& argument);    // Performs a control request on the GUI thread, and returns its response line.
+
+
+    // Launch Options
+    // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+    const LaunchOptions    launchOptions;                      // The command line options this instance was started with.
+    bool                   waitedForProcessFound;              // Whether the --wait-for-process target has been seen running yet.
+    void                   applyLaunchOptions();               // Applies the command line targets and one-shot modes, after the JSON settings.
+
+
     // JSON Settings Dialog
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
     QString                jsonConfigFilePath;
@@ -175,9 +284,7 @@ protected:
 
     // Sound Effects
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-    QSoundEffect    seLockActivated, seLockDeactivated;      // Sound effects that play when the cursor lock is activated or deactivated.
-    QSoundEffect    seWindowGrabberTick;                     // Sound effect that's played when a new foreground window is grabbed, or the window grabber times out.
-    bool            soundEffectsMuted;                       // Stores the mute toggle state of the above sound effects.
+    SoundMixer      soundMixer;                              // Plays the lock activated/deactivated and window grabber tick cues; shared with lowLevelKeyboardHook.
 
     Q_SLOT void     setSoundEffectsMutedState(bool);
     Q_SLOT void     toggleSoundEffectsMuted();
@@ -185,14 +292,17 @@ protected:
 
     // Cursor Lock
     // ------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-    bool lastCursorLockStateSet;
+    CursorLock cursorLock;    // Owns the ClipCursor state; shared with lowLevelKeyboardHook, which may change it from its own thread.
     void setCursorLockEnabled(const bool&);
     bool toggleCursorLockState();
 
+    CursorEscapeWatchdog cursorEscapeWatchdog;    // Armed while the lock is enabled; re-asserts the clip when something else releases it. Fed WM_INPUT by nativeEvent.
+
 
     // Override of nativeEvent in order to handle Windows message queue events, namely those sent when a hotkey
-    // that was previously registered using RegisterHotKey() was pressed. targetHotkeyWasPressed signal is emitted
-    // if the event type is WM_HOTKEY, and the hotkey ID and VKID match those used to register the hotkey.
+    // that was previously registered using RegisterHotKey() was pressed. If the event type is WM_HOTKEY and
+    // hotkeyRegistry resolves it to an action, the action is dispatched; targetHotkeyWasPressed is emitted for
+    // HOTKEY_ACTION::TOGGLE_LOCK.
     Q_SIGNAL void targetHotkeyWasPressed();
     virtual bool nativeEvent(const QByteArray& event_type, void* message, qintptr* result) override;
 
@@ -203,7 +313,7 @@ protected:
 
 
 public:
-    explicit MainWindowDialog(QWidget* parent = nullptr);
+    explicit MainWindowDialog(const LaunchOptions& launch_options, QWidget* parent = nullptr);
     virtual ~MainWindowDialog() override;
 };
 
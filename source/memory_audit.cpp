@@ -0,0 +1,250 @@
+#include "memory_audit.hpp"
+#include "metrics_registry.hpp"
+
+#include <Psapi.h>
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#endif
+
+namespace {
+#ifdef _DEBUG
+    thread_local quint64 threadAllocationCount { 0 };
+
+    // Runs inside the allocator, so it must not allocate itself; _CRT_BLOCK allocations are the CRT's own bookkeeping.
+    int countAllocation(int allocation_type, void*, size_t, int block_type, long, const unsigned char*, int) {
+        if(block_type != _CRT_BLOCK && (allocation_type == _HOOK_ALLOC || allocation_type == _HOOK_REALLOC)) {
+            ++threadAllocationCount;
+        }
+
+        return TRUE;
+    }
+
+    // Installed during static initialization, so that everything from main onwards is counted.
+    const _CRT_ALLOC_HOOK previousAllocationHook { _CrtSetAllocHook(countAllocation) };
+#endif
+
+    MetricsRegistry::Gauge& workingSetMetric    { MetricsRegistry::Instance().RegisterGauge("cursorlocker_memory_working_set_bytes", {}, "The working set of the process, when the metrics were last queried.") };
+    MetricsRegistry::Gauge& privateBytesMetric  { MetricsRegistry::Instance().RegisterGauge("cursorlocker_memory_private_bytes", {}, "The private bytes committed by the process, when the metrics were last queried.") };
+
+    QString formatMiB(qint64 bytes, bool signed_delta) {
+        return QString::asprintf(signed_delta ? "%+10.2f MiB" : "%10.2f MiB", bytes / (1024.0 * 1024.0));
+    }
+
+    QString formatRow(const QString& name, const MemoryAudit::Usage& usage, bool signed_delta) {
+        return QString { "%1 %2 %3 %4 %5\n" }.arg(
+                    name.leftJustified(30, ' ', true),
+                    formatMiB(usage.WorkingSetBytes, signed_delta),
+                    formatMiB(usage.PrivateBytes, signed_delta),
+                    formatMiB(usage.HeapBytes, signed_delta),
+                    QString::asprintf(signed_delta ? "%+12lld" : "%12lld", usage.HeapBlocks));
+    }
+}
+
+MemoryAudit::Usage& MemoryAudit::Usage::operator+=(const Usage& other) {
+    WorkingSetBytes += other.WorkingSetBytes;
+    PrivateBytes    += other.PrivateBytes;
+    HeapBytes       += other.HeapBytes;
+    HeapBlocks      += other.HeapBlocks;
+    return *this;
+}
+
+MemoryAudit::Usage& MemoryAudit::Usage::operator-=(const Usage& other) {
+    WorkingSetBytes -= other.WorkingSetBytes;
+    PrivateBytes    -= other.PrivateBytes;
+    HeapBytes       -= other.HeapBytes;
+    HeapBlocks      -= other.HeapBlocks;
+    return *this;
+}
+
+MemoryAudit::Usage MemoryAudit::Usage::operator-(const Usage& other) const {
+    Usage difference { *this };
+    difference -= other;
+    return difference;
+}
+
+void MemoryAudit::Scope::End() {
+    if(active) {
+        MemoryAudit::Instance().end();
+        active = false;
+    }
+}
+
+MemoryAudit::Scope::Scope(const QString& subsystem)
+    :
+      active    { MemoryAudit::Instance().IsEnabled() }
+{
+    if(active) {
+        MemoryAudit::Instance().begin(subsystem);
+    }
+}
+
+MemoryAudit::Scope::~Scope() {
+    End();
+}
+
+void MemoryAudit::begin(const QString& subsystem) {
+    openScopes.append({ subsystem, Measure(), Usage { 0, 0, 0, 0 } });
+}
+
+void MemoryAudit::end() {
+    const OpenScope& scope { openScopes.takeLast() };
+    const Usage& growth { Measure() - scope.Start };
+
+    Usage own_growth { growth };
+    own_growth -= scope.ClaimedByNested;
+
+    if(!openScopes.isEmpty()) {
+        openScopes.last().ClaimedByNested += growth;
+    }
+
+    for(Subsystem& subsystem : subsystems) {
+        if(subsystem.Name == scope.Subsystem) {
+            subsystem.Growth += own_growth;
+            return;
+        }
+    }
+
+    subsystems.append({ scope.Subsystem, own_growth });
+}
+
+MemoryAudit::AllocationCounter::AllocationCounter(MetricsRegistry::Histogram& allocations_histogram)
+    :
+      histogram     { allocations_histogram                      },
+      startCount    { MemoryAudit::GetThreadAllocationCount()    }
+{
+
+}
+
+MemoryAudit::AllocationCounter::~AllocationCounter() {
+    if(MemoryAudit::CountsAllocations()) {
+        histogram.Observe(MemoryAudit::GetThreadAllocationCount() - startCount);
+    }
+}
+
+MemoryAudit& MemoryAudit::Instance() {
+    static MemoryAudit instance;
+    return instance;
+}
+
+MemoryAudit::Usage MemoryAudit::Measure(bool walk_heaps) {
+    Usage usage { 0, 0, 0, 0 };
+
+    PROCESS_MEMORY_COUNTERS_EX counters {};
+
+    if(GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+        usage.WorkingSetBytes = static_cast<qint64>(counters.WorkingSetSize);
+        usage.PrivateBytes    = static_cast<qint64>(counters.PrivateUsage);
+    }
+
+    if(!walk_heaps) {
+        return usage;
+    }
+
+    // The CRT heap that both this executable and the Qt libraries allocate from is one of these.
+    QVector<HANDLE> heaps(static_cast<qsizetype>(GetProcessHeaps(0, nullptr)));
+    heaps.resize(static_cast<qsizetype>(GetProcessHeaps(static_cast<DWORD>(heaps.size()), heaps.data())));
+
+    for(const HANDLE& heap : heaps) {
+        if(!HeapLock(heap)) {
+            continue;
+        }
+
+        PROCESS_HEAP_ENTRY entry {};
+
+        while(HeapWalk(heap, &entry)) {
+            if(entry.wFlags & PROCESS_HEAP_ENTRY_BUSY) {
+                usage.HeapBytes += static_cast<qint64>(entry.cbData);
+                ++usage.HeapBlocks;
+            }
+        }
+
+        HeapUnlock(heap);
+    }
+
+    return usage;
+}
+
+void MemoryAudit::PublishMetrics() {
+    const Usage& usage { Measure(false) };
+    workingSetMetric.Set(usage.WorkingSetBytes);
+    privateBytesMetric.Set(usage.PrivateBytes);
+}
+
+bool MemoryAudit::CountsAllocations() {
+#ifdef _DEBUG
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 MemoryAudit::GetThreadAllocationCount() {
+#ifdef _DEBUG
+    return threadAllocationCount;
+#else
+    return 0;
+#endif
+}
+
+const QVector<quint64>& MemoryAudit::AllocationBuckets() {
+    static const QVector<quint64> allocation_buckets {
+        0, 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024
+    };
+
+    return allocation_buckets;
+}
+
+void MemoryAudit::Enable() {
+    if(enabled) {
+        return;
+    }
+
+    baseline = Measure();
+    enabled = true;
+}
+
+bool MemoryAudit::IsEnabled() const {
+    return enabled;
+}
+
+QString MemoryAudit::Report() const {
+    const Usage& current { Measure() };
+
+    QString report;
+    report += QString { "%1 %2 %3 %4 %5\n" }.arg("Subsystem", -30).arg("Working set", 14).arg("Private", 14).arg("Heap in use", 14).arg("Heap blocks", 12);
+    report += formatRow("startup (executable, DLLs)", baseline, false);
+
+    Usage unattributed { current - baseline };
+
+    for(const Subsystem& subsystem : subsystems) {
+        report += formatRow(subsystem.Name, subsystem.Growth, true);
+        unattributed -= subsystem.Growth;
+    }
+
+    report += formatRow("unattributed", unattributed, true);
+    report += formatRow("total", current, false);
+
+    const qint64& headroom { static_cast<qint64>(WORKING_SET_BUDGET_BYTES) - current.WorkingSetBytes };
+
+    report += QString { "\nWorking set budget: %1, %2 %3\n" }.arg(
+                formatMiB(static_cast<qint64>(WORKING_SET_BUDGET_BYTES), false).trimmed(),
+                formatMiB(qAbs(headroom), false).trimmed(),
+                QString { headroom >= 0 ? "to spare" : "over budget" });
+
+    return report;
+}
+
+bool MemoryAudit::IsWithinBudget() const {
+    return Measure(false).WorkingSetBytes <= static_cast<qint64>(WORKING_SET_BUDGET_BYTES);
+}
+
+MemoryAudit::MemoryAudit()
+    :
+      enabled       { false        },
+      baseline      { 0, 0, 0, 0   },
+      subsystems    {              },
+      openScopes    {              }
+{
+
+}
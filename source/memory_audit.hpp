@@ -0,0 +1,118 @@
+#ifndef MEMORY_AUDIT_HPP
+#define MEMORY_AUDIT_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "metrics_registry.hpp"
+
+/* Breaks the memory footprint of the process down by subsystem, for --memory-report. Every scope
+ * samples the working set, the private bytes, and the bytes in use across every heap of the
+ * process (which the Qt libraries allocate from too) when it begins and ends, and attributes the
+ * growth in between to its subsystem, minus whatever nested scopes already claimed. Walking the
+ * heaps is slow, so scopes do nothing unless the audit was enabled, which costs them a single
+ * branch. Working sets are process-wide, so scopes must only be opened on the GUI thread.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class MemoryAudit {
+public:
+    static constexpr quint64 WORKING_SET_BUDGET_BYTES { 48ull * 1024 * 1024 };    // For the window, settled, with sound enabled.
+
+    struct Usage {
+        qint64    WorkingSetBytes;
+        qint64    PrivateBytes;
+        qint64    HeapBytes;      // Bytes allocated and not yet freed, excluding the heap's own overhead.
+        qint64    HeapBlocks;
+
+        Usage& operator+=(const Usage& other);
+        Usage& operator-=(const Usage& other);
+        Usage  operator-(const Usage& other) const;
+    };
+
+    class Scope {
+    protected:
+        bool active;
+
+    public:
+        void End();    // Ends the scope early; the destructor then does nothing.
+
+        explicit Scope(const QString& subsystem);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    /* Observes the number of heap allocations the calling thread made between its construction and
+     * destruction into a histogram. Only debug builds count anything: counting relies on the debug
+     * CRT's allocation hook, which the debug Qt libraries allocate through as well.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    class AllocationCounter {
+    protected:
+        MetricsRegistry::Histogram&    histogram;
+        quint64                        startCount;
+
+    public:
+        explicit AllocationCounter(MetricsRegistry::Histogram& allocations_histogram);
+        ~AllocationCounter();
+
+        AllocationCounter(const AllocationCounter&) = delete;
+        AllocationCounter& operator=(const AllocationCounter&) = delete;
+    };
+
+protected:
+    struct Subsystem {
+        QString    Name;
+        Usage      Growth;
+    };
+
+    struct OpenScope {
+        QString    Subsystem;
+        Usage      Start;
+        Usage      ClaimedByNested;
+    };
+
+    bool                  enabled;
+    Usage                 baseline;
+    QVector<Subsystem>    subsystems;    // In the order they were first seen.
+    QVector<OpenScope>    openScopes;
+
+    void                  begin(const QString& subsystem);
+    void                  end();
+
+    MemoryAudit();
+
+public:
+    static MemoryAudit&   Instance();
+
+    static Usage          Measure(bool walk_heaps = true);
+    static void           PublishMetrics();    // Updates the working set and private bytes gauges; cheap, as it doesn't walk the heaps.
+
+    static bool           CountsAllocations();
+    static quint64        GetThreadAllocationCount();    // Heap allocations made by the calling thread so far; always 0 unless CountsAllocations.
+    static const QVector<quint64>& AllocationBuckets();   // 0, then powers of two up to 1024.
+
+    void                  Enable();    // Takes the baseline, which covers the executable and every library loaded at startup.
+    bool                  IsEnabled() const;
+
+    QString               Report() const;
+    bool                  IsWithinBudget() const;
+
+    MemoryAudit(const MemoryAudit&) = delete;
+    MemoryAudit& operator=(const MemoryAudit&) = delete;
+};
+
+#endif // MEMORY_AUDIT_HPP
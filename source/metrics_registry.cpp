@@ -0,0 +1,225 @@
+#include "metrics_registry.hpp"
+
+#include <QtCore/QTextStream>
+#include <QtCore/QLocale>
+
+#include <algorithm>
+#include <utility>
+
+void MetricsRegistry::Counter::Increment(quint64 amount) {
+    shards[currentShardIndex()].Value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+quint64 MetricsRegistry::Counter::GetValue() const {
+    quint64 value { 0 };
+
+    for(const Shard& shard : shards) {
+        value += shard.Value.load(std::memory_order_relaxed);
+    }
+
+    return value;
+}
+
+MetricsRegistry::Counter::Counter() {
+    for(Shard& shard : shards) {
+        shard.Value = 0;
+    }
+}
+
+void MetricsRegistry::Gauge::Set(qint64 new_value) {
+    value.store(new_value, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::Gauge::Add(qint64 amount) {
+    value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+qint64 MetricsRegistry::Gauge::GetValue() const {
+    return value.load(std::memory_order_relaxed);
+}
+
+MetricsRegistry::Gauge::Gauge()
+    :
+      value    { 0 }
+{
+
+}
+
+void MetricsRegistry::Histogram::Observe(quint64 value) {
+    const size_t& shard_index  { currentShardIndex() };
+    const size_t& bucket_index { static_cast<size_t>(std::lower_bound(upperBounds.cbegin(), upperBounds.cend(), value) - upperBounds.cbegin()) };
+
+    bucketShards[bucket_index][shard_index].Value.fetch_add(1, std::memory_order_relaxed);
+    sumShards[shard_index].Value.fetch_add(value, std::memory_order_relaxed);
+}
+
+const QVector<quint64>& MetricsRegistry::Histogram::GetUpperBounds() const {
+    return upperBounds;
+}
+
+QVector<quint64> MetricsRegistry::Histogram::GetBucketCounts() const {
+    QVector<quint64> bucket_counts(static_cast<qsizetype>(bucketShards.size()), 0);
+
+    for(size_t i { 0 }; i < bucketShards.size(); ++i) {
+        for(const Shard& shard : bucketShards[i]) {
+            bucket_counts[static_cast<qsizetype>(i)] += shard.Value.load(std::memory_order_relaxed);
+        }
+    }
+
+    return bucket_counts;
+}
+
+quint64 MetricsRegistry::Histogram::GetSum() const {
+    quint64 sum { 0 };
+
+    for(const Shard& shard : sumShards) {
+        sum += shard.Value.load(std::memory_order_relaxed);
+    }
+
+    return sum;
+}
+
+MetricsRegistry::Histogram::Histogram(const QVector<quint64>& upper_bounds)
+    :
+      upperBounds     { upper_bounds                                       },
+      bucketShards    ( static_cast<size_t>(upper_bounds.size()) + 1       )
+{
+    for(std::array<Shard, ShardCount>& bucket : bucketShards) {
+        for(Shard& shard : bucket) {
+            shard.Value = 0;
+        }
+    }
+
+    for(Shard& shard : sumShards) {
+        shard.Value = 0;
+    }
+}
+
+size_t MetricsRegistry::currentShardIndex() {
+    // Threads are dealt shards round-robin on first use; with fewer threads than shards, no two ever share one.
+    static std::atomic<size_t> next_shard_index { 0 };
+    thread_local const size_t shard_index { next_shard_index.fetch_add(1, std::memory_order_relaxed) % ShardCount };
+
+    return shard_index;
+}
+
+MetricsRegistry& MetricsRegistry::Instance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricsRegistry::Counter& MetricsRegistry::RegisterCounter(const QString& name, const QString& labels, const QString& help, double scale) {
+    QMutexLocker registration_locker { &registrationMutex };
+
+    counters.emplace_back();
+    entries.append({ METRIC_TYPE::COUNTER, name, labels, help, scale, &counters.back() });
+
+    return counters.back();
+}
+
+MetricsRegistry::Gauge& MetricsRegistry::RegisterGauge(const QString& name, const QString& labels, const QString& help, double scale) {
+    QMutexLocker registration_locker { &registrationMutex };
+
+    gauges.emplace_back();
+    entries.append({ METRIC_TYPE::GAUGE, name, labels, help, scale, &gauges.back() });
+
+    return gauges.back();
+}
+
+MetricsRegistry::Histogram& MetricsRegistry::RegisterHistogram(const QString& name, const QString& labels, const QString& help, const QVector<quint64>& upper_bounds, double scale) {
+    QMutexLocker registration_locker { &registrationMutex };
+
+    histograms.emplace_back(upper_bounds);
+    entries.append({ METRIC_TYPE::HISTOGRAM, name, labels, help, scale, &histograms.back() });
+
+    return histograms.back();
+}
+
+QByteArray MetricsRegistry::ToPrometheusText() const {
+    QMutexLocker registration_locker { &registrationMutex };
+
+    QString exposition;
+    QTextStream stream { &exposition };
+    QStringList described_names;
+
+    const auto& format_labels {
+        [](const QString& labels, const QString& extra_label) -> QString {
+            const QString& joined { labels.isEmpty() ? extra_label : (extra_label.isEmpty() ? labels : labels + ',' + extra_label) };
+            return joined.isEmpty() ? QString {} : '{' + joined + '}';
+        }
+    };
+
+    // Unscaled values are written as integers, and scaled ones with as many digits as it takes to round-trip, as QTextStream would round both to 6 digits.
+    const auto& format_value {
+        [](auto value, double scale) -> QString {
+            return scale == 1.0 ? QString::number(value) : QString::number(value * scale, 'g', QLocale::FloatingPointShortest);
+        }
+    };
+
+    // Entries sharing a name (differing only in labels) are one metric family, which is described only once.
+    QVector<const Entry*> sorted_entries;
+
+    for(const Entry& entry : entries) {
+        sorted_entries.append(&entry);
+    }
+
+    std::stable_sort(sorted_entries.begin(), sorted_entries.end(), [](const Entry* lhs, const Entry* rhs) -> bool {
+        return lhs->Name < rhs->Name;
+    });
+
+    for(const Entry* entry : std::as_const(sorted_entries)) {
+        if(!described_names.contains(entry->Name)) {
+            static const char* const type_names[] { "counter", "gauge", "histogram" };
+
+            stream << "# HELP " << entry->Name << ' ' << entry->Help << '\n';
+            stream << "# TYPE " << entry->Name << ' ' << type_names[static_cast<quint8>(entry->Type)] << '\n';
+
+            described_names.append(entry->Name);
+        }
+
+        switch(entry->Type) {
+        case METRIC_TYPE::COUNTER :
+            stream << entry->Name << format_labels(entry->Labels, {}) << ' ' << format_value(static_cast<const Counter*>(entry->Metric)->GetValue(), entry->Scale) << '\n';
+            break;
+
+        case METRIC_TYPE::GAUGE :
+            stream << entry->Name << format_labels(entry->Labels, {}) << ' ' << format_value(static_cast<const Gauge*>(entry->Metric)->GetValue(), entry->Scale) << '\n';
+            break;
+
+        case METRIC_TYPE::HISTOGRAM : {
+            const Histogram* histogram { static_cast<const Histogram*>(entry->Metric) };
+            const QVector<quint64>& bucket_counts { histogram->GetBucketCounts() };
+            quint64 cumulative_count { 0 };
+
+            for(qsizetype i { 0 }; i < bucket_counts.size(); ++i) {
+                cumulative_count += bucket_counts[i];
+
+                const QString& upper_bound {
+                    i < histogram->GetUpperBounds().size() ? QString::number(histogram->GetUpperBounds()[i] * entry->Scale) : QString { "+Inf" }
+                };
+
+                stream << entry->Name << "_bucket" << format_labels(entry->Labels, "le=\"" + upper_bound + '"') << ' ' << cumulative_count << '\n';
+            }
+
+            stream << entry->Name << "_sum" << format_labels(entry->Labels, {}) << ' ' << format_value(histogram->GetSum(), entry->Scale) << '\n';
+            stream << entry->Name << "_count" << format_labels(entry->Labels, {}) << ' ' << cumulative_count << '\n';
+            break;
+        }
+        }
+    }
+
+    stream.flush();
+    return exposition.toUtf8();
+}
+
+const QVector<quint64>& MetricsRegistry::LatencyBucketsUs() {
+    static const QVector<quint64> latency_buckets_us {
+        50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000
+    };
+
+    return latency_buckets_us;
+}
+
+MetricsRegistry::MetricsRegistry() {
+
+}
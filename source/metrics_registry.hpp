@@ -0,0 +1,107 @@
+#ifndef METRICS_REGISTRY_HPP
+#define METRICS_REGISTRY_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+#include <QtCore/QMutex>
+
+#include <array>
+#include <atomic>
+#include <deque>
+
+/* In-process metrics, exported in the Prometheus text exposition format. Recording a value is a
+ * single relaxed atomic add on a cache line picked by the calling thread, so the low-level hook
+ * thread, the sound thread and the GUI thread never contend with each other; reads sum the shards.
+ * Metrics are registered once (typically into a static reference) and live as long as the process.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class MetricsRegistry {
+public:
+    static constexpr size_t ShardCount { 8 };
+
+    // Keeps each shard on its own cache line, so that threads on different shards don't false-share.
+    struct alignas(64) Shard {
+        std::atomic<quint64> Value;
+    };
+
+    class Counter {
+    protected:
+        std::array<Shard, ShardCount> shards;
+
+    public:
+        void       Increment(quint64 amount = 1);
+        quint64    GetValue() const;
+
+        Counter();
+    };
+
+    class Gauge {
+    protected:
+        std::atomic<qint64> value;
+
+    public:
+        void       Set(qint64 new_value);
+        void       Add(qint64 amount);
+        qint64     GetValue() const;
+
+        Gauge();
+    };
+
+    // Cumulative histogram over fixed, ascending upper bounds; values above the last bound only count towards +Inf.
+    class Histogram {
+    protected:
+        const QVector<quint64>                       upperBounds;
+        std::deque<std::array<Shard, ShardCount>>    bucketShards;    // One per upper bound, plus +Inf.
+        std::array<Shard, ShardCount>                sumShards;
+
+    public:
+        void                       Observe(quint64 value);
+        const QVector<quint64>&    GetUpperBounds() const;
+        QVector<quint64>           GetBucketCounts() const;    // Per bucket, not cumulative; the last entry is +Inf.
+        quint64                    GetSum() const;
+
+        explicit Histogram(const QVector<quint64>& upper_bounds);
+    };
+
+protected:
+    enum struct METRIC_TYPE : quint8 {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM
+    };
+
+    struct Entry {
+        METRIC_TYPE    Type;
+        QString        Name;
+        QString        Labels;    // Prometheus label set without braces, e.g. source="wm_hotkey"; may be empty.
+        QString        Help;
+        double         Scale;     // Recorded values are multiplied by this on export, e.g. 1e-6 to export microseconds as seconds.
+        void*          Metric;
+    };
+
+    mutable QMutex         registrationMutex;
+    std::deque<Counter>    counters;
+    std::deque<Gauge>      gauges;
+    std::deque<Histogram>  histograms;
+    QVector<Entry>         entries;
+
+    static size_t          currentShardIndex();
+
+    MetricsRegistry();
+
+public:
+    static MetricsRegistry&    Instance();
+
+    Counter&       RegisterCounter(const QString& name, const QString& labels, const QString& help, double scale = 1.0);
+    Gauge&         RegisterGauge(const QString& name, const QString& labels, const QString& help, double scale = 1.0);
+    Histogram&     RegisterHistogram(const QString& name, const QString& labels, const QString& help, const QVector<quint64>& upper_bounds, double scale = 1.0);
+
+    QByteArray     ToPrometheusText() const;
+
+    static const QVector<quint64>& LatencyBucketsUs();    // 50 us to 1 s, roughly doubling.
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+};
+
+#endif // METRICS_REGISTRY_HPP
@@ -0,0 +1,150 @@
+#include "power_state_monitor.hpp"
+#include "metrics_registry.hpp"
+
+#include <WtsApi32.h>
+
+#include <QtCore/QtDebug>
+
+namespace {
+    MetricsRegistry::Gauge&     idleMetric             { MetricsRegistry::Instance().RegisterGauge("cursorlocker_power_idle", {}, "Whether polling is paused because the session is locked, disconnected, suspended or its display is off.") };
+    MetricsRegistry::Counter&   idleTimeMetric         { MetricsRegistry::Instance().RegisterCounter("cursorlocker_power_idle_seconds_total", {}, "Total time polling was paused, up to the most recent resume.", 1e-6) };
+    MetricsRegistry::Counter&   idleTransitionsMetric  { MetricsRegistry::Instance().RegisterCounter("cursorlocker_power_idle_transitions_total", {}, "Number of times polling was paused.") };
+
+    // GUID_CONSOLE_DISPLAY_STATE, spelled out so that the power setting GUIDs don't have to be linked in for a single value.
+    constexpr GUID CONSOLE_DISPLAY_STATE_GUID { 0x6FE69556, 0x704A, 0x47A0, { 0x8F, 0x24, 0xC2, 0x8D, 0x93, 0x6F, 0xDA, 0x47 } };
+}
+
+void PowerStateMonitor::setIdleReason(IDLE_REASON reason, bool in_effect) {
+    const bool was_idle { IsIdle() };
+
+    if(in_effect) {
+        idleReasons |= static_cast<quint8>(reason);
+    } else {
+        idleReasons &= ~static_cast<quint8>(reason);
+    }
+
+    if(was_idle == IsIdle()) {
+        return;
+    }
+
+    if(IsIdle()) {
+        idleTimer.start();
+        idleTransitionsMetric.Increment();
+        qInfo() << "Pausing activation polling, idle reasons = 0x" << QString::number(idleReasons, 16);
+    } else {
+        idleTimeMetric.Increment(static_cast<quint64>(idleTimer.nsecsElapsed() / 1000));
+        idleTimer.invalidate();
+        qInfo() << "Resuming activation polling.";
+    }
+
+    idleMetric.Set(IsIdle() ? 1 : 0);
+    emit IdleStateChanged(IsIdle());
+}
+
+bool PowerStateMonitor::Register(HWND target_window) {
+    if(targetWindow == target_window) {
+        return true;
+    }
+
+    Unregister();
+
+    if(!WTSRegisterSessionNotification(target_window, NOTIFY_FOR_THIS_SESSION)) {
+        qInfo() << "WTSRegisterSessionNotification failed, GetLastError() =" << GetLastError();
+        return false;
+    }
+
+    // Windows sends the current display state right away, so a display that's already off is picked up here.
+    displayStateNotification = RegisterPowerSettingNotification(target_window, &CONSOLE_DISPLAY_STATE_GUID, DEVICE_NOTIFY_WINDOW_HANDLE);
+
+    if(displayStateNotification == nullptr) {
+        qInfo() << "RegisterPowerSettingNotification failed, GetLastError() =" << GetLastError() << "- display state changes won't pause polling.";
+    }
+
+    targetWindow = target_window;
+    return true;
+}
+
+void PowerStateMonitor::Unregister() {
+    if(targetWindow == nullptr) {
+        return;
+    }
+
+    if(displayStateNotification != nullptr) {
+        UnregisterPowerSettingNotification(displayStateNotification);
+        displayStateNotification = nullptr;
+    }
+
+    WTSUnRegisterSessionNotification(targetWindow);
+    targetWindow = nullptr;
+}
+
+bool PowerStateMonitor::HandleNativeEvent(const MSG* msg) {
+    if(targetWindow == nullptr || msg->hwnd != targetWindow) {
+        return false;
+    }
+
+    if(msg->message == WM_WTSSESSION_CHANGE) {
+        switch(msg->wParam) {
+        case WTS_SESSION_LOCK         : setIdleReason(IDLE_REASON::SESSION_LOCKED, true);           break;
+        case WTS_SESSION_UNLOCK       : setIdleReason(IDLE_REASON::SESSION_LOCKED, false);          break;
+        case WTS_CONSOLE_DISCONNECT   :
+        case WTS_REMOTE_DISCONNECT    : setIdleReason(IDLE_REASON::SESSION_DISCONNECTED, true);     break;
+        case WTS_CONSOLE_CONNECT      :
+        case WTS_REMOTE_CONNECT       : setIdleReason(IDLE_REASON::SESSION_DISCONNECTED, false);    break;
+        default                       : return false;
+        }
+
+        return true;
+    }
+
+    if(msg->message == WM_POWERBROADCAST) {
+        switch(msg->wParam) {
+        case PBT_APMSUSPEND           : setIdleReason(IDLE_REASON::SYSTEM_SUSPENDED, true);         break;
+
+        // PBT_APMRESUMEAUTOMATIC is always sent on resume; PBT_APMRESUMESUSPEND only follows when a user is present.
+        case PBT_APMRESUMEAUTOMATIC   :
+        case PBT_APMRESUMESUSPEND     : setIdleReason(IDLE_REASON::SYSTEM_SUSPENDED, false);        break;
+
+        case PBT_POWERSETTINGCHANGE   : {
+            const POWERBROADCAST_SETTING* setting { reinterpret_cast<const POWERBROADCAST_SETTING*>(msg->lParam) };
+
+            if(setting == nullptr || !IsEqualGUID(setting->PowerSetting, CONSOLE_DISPLAY_STATE_GUID) || setting->DataLength < sizeof(DWORD)) {
+                return false;
+            }
+
+            // 0 is off, 1 is on, and 2 is dimmed; a dimmed display is still being looked at.
+            setIdleReason(IDLE_REASON::DISPLAY_OFF, *reinterpret_cast<const DWORD*>(setting->Data) == 0);
+            break;
+        }
+
+        default                       : return false;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool PowerStateMonitor::IsIdle() const {
+    return idleReasons != 0;
+}
+
+quint8 PowerStateMonitor::GetIdleReasons() const {
+    return idleReasons;
+}
+
+PowerStateMonitor::PowerStateMonitor(QObject* parent)
+    :
+      QObject                     { parent  },
+      targetWindow                { nullptr },
+      displayStateNotification    { nullptr },
+      idleReasons                 { 0       },
+      idleTimer                   {         }
+{
+
+}
+
+PowerStateMonitor::~PowerStateMonitor() {
+    Unregister();
+}
@@ -0,0 +1,53 @@
+#ifndef POWER_STATE_MONITOR_HPP
+#define POWER_STATE_MONITOR_HPP
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+
+// Every condition under which no target can be in the foreground of this session, so polling for one is pointless.
+enum struct IDLE_REASON : quint8 {
+    SESSION_LOCKED          =   0x01,    // WTS_SESSION_LOCK, until WTS_SESSION_UNLOCK.
+    SESSION_DISCONNECTED    =   0x02,    // The session was switched away from or its remote connection dropped, until it's connected again.
+    SYSTEM_SUSPENDED        =   0x04,    // PBT_APMSUSPEND, until the system resumes.
+    DISPLAY_OFF             =   0x08     // The console display was turned off, which is also what a blanking screensaver leads to.
+};
+
+/* Tracks whether the session is in a state where nobody can be using a target, from the session
+ * change and power broadcast messages that Windows sends to a registered window, so that the
+ * polling activation methods can stop waking the process up. The owning window forwards its
+ * messages to HandleNativeEvent. IdleStateChanged is only emitted when the session goes from
+ * active to idle or back, not when one idle reason is replaced by another.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class PowerStateMonitor : public QObject {
+Q_OBJECT
+
+protected:
+    HWND              targetWindow;               // The window receiving the notifications while registered, or nullptr.
+    HPOWERNOTIFY      displayStateNotification;
+    quint8            idleReasons;                // Bitmask of IDLE_REASON values currently in effect.
+    QElapsedTimer     idleTimer;                  // Running while idle, so that the idle time can be accounted for on resume.
+
+    void              setIdleReason(IDLE_REASON reason, bool in_effect);
+
+public:
+    Q_SIGNAL void     IdleStateChanged(bool idle);
+
+    bool              Register(HWND target_window);    // Subscribes target_window to session change and display state notifications.
+    void              Unregister();
+
+    bool              HandleNativeEvent(const MSG* msg);    // Returns true if the message was a notification meant for the monitor.
+
+    bool              IsIdle() const;
+    quint8            GetIdleReasons() const;
+
+    explicit PowerStateMonitor(QObject* parent = nullptr);
+    virtual ~PowerStateMonitor() override;
+};
+
+#endif // POWER_STATE_MONITOR_HPP
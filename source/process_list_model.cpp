@@ -0,0 +1,418 @@
+#include "process_list_model.hpp"
+
+#include <QtCore/QFileInfo>
+#include <QtConcurrent/QtConcurrent>
+
+#include <QtWidgets/QFileIconProvider>
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+QStringView ProcessTable::GetImageName(qsizetype process_index) const {
+    return QStringView { StringArena }.mid(ImageNameOffsets[process_index], ImageNameLengths[process_index]);
+}
+
+QStringView ProcessTable::GetTitle(qsizetype window_index) const {
+    return QStringView { StringArena }.mid(TitleOffsets[window_index], TitleLengths[window_index]);
+}
+
+std::shared_ptr<const ProcessTable> ProcessTable::FromSnapshot(const ProcessSnapshot& snapshot, bool include_windows) {
+    std::shared_ptr<ProcessTable> table { std::make_shared<ProcessTable>() };
+
+    const qsizetype& process_count { snapshot.Processes.size() };
+    const qsizetype& window_count  { include_windows ? snapshot.Windows.size() : 0 };
+
+    // Size the arena up front so that appending never reallocates.
+    qsizetype arena_size { 0 };
+
+    for(const ProcessSnapshot::Process& process : snapshot.Processes) {
+        arena_size += process.ImageName.size();
+    }
+
+    for(qsizetype i { 0 }; i < window_count; ++i) {
+        arena_size += snapshot.Windows[i].Title.size();
+    }
+
+    table->StringArena.reserve(arena_size);
+
+    // Both lists are sorted by PID, so a single merge pass finds the window range of every process.
+    QVector<quint32> first_window_indexes(process_count);
+    QVector<quint32> window_counts(process_count);
+    qsizetype window_index { 0 };
+
+    for(qsizetype i { 0 }; i < process_count; ++i) {
+        const DWORD& pid { snapshot.Processes[i].Pid };
+
+        while(window_index < window_count && snapshot.Windows[window_index].Pid < pid) {
+            ++window_index;
+        }
+
+        first_window_indexes[i] = static_cast<quint32>(window_index);
+
+        while(window_index < window_count && snapshot.Windows[window_index].Pid == pid) {
+            ++window_index;
+        }
+
+        window_counts[i] = static_cast<quint32>(window_index - first_window_indexes[i]);
+    }
+
+    QVector<quint32> process_order(process_count);
+    std::iota(process_order.begin(), process_order.end(), 0);
+
+    // Processes of other users' sessions can't be targeted from this one, so they aren't listed.
+    process_order.erase(std::remove_if(process_order.begin(), process_order.end(), [&snapshot](quint32 snapshot_index) {
+        return !snapshot.IsInSession(snapshot.Processes[snapshot_index]);
+    }), process_order.end());
+
+    std::stable_sort(process_order.begin(), process_order.end(), [&snapshot](quint32 left, quint32 right) {
+        return QString::compare(snapshot.Processes[left].ImageName, snapshot.Processes[right].ImageName, Qt::CaseInsensitive) < 0;
+    });
+
+    table->Pids.reserve(process_order.size());
+    table->ImageNameOffsets.reserve(process_order.size());
+    table->ImageNameLengths.reserve(process_order.size());
+    table->FirstWindowIndexes.reserve(process_order.size());
+    table->WindowCounts.reserve(process_order.size());
+
+    for(const quint32& snapshot_index : process_order) {
+        const ProcessSnapshot::Process& process { snapshot.Processes[snapshot_index] };
+
+        table->Pids.append(process.Pid);
+        table->ImageNameOffsets.append(static_cast<quint32>(table->StringArena.size()));
+        table->ImageNameLengths.append(static_cast<quint32>(process.ImageName.size()));
+        table->FirstWindowIndexes.append(first_window_indexes[snapshot_index]);
+        table->WindowCounts.append(window_counts[snapshot_index]);
+        table->StringArena.append(process.ImageName);
+    }
+
+    table->WindowHandles.reserve(window_count);
+    table->TitleOffsets.reserve(window_count);
+    table->TitleLengths.reserve(window_count);
+
+    for(qsizetype i { 0 }; i < window_count; ++i) {
+        const ProcessSnapshot::Window& window { snapshot.Windows[i] };
+
+        table->WindowHandles.append(window.Handle);
+        table->TitleOffsets.append(static_cast<quint32>(table->StringArena.size()));
+        table->TitleLengths.append(static_cast<quint32>(window.Title.size()));
+        table->StringArena.append(window.Title);
+    }
+
+    return table;
+}
+
+ProcessTableFilter ProcessTableFilter::Compute(const ProcessTable& table, const QString& filter_text, bool windows_only, const ProcessTableFilter* narrowing) {
+    ProcessTableFilter result;
+    result.FilterText = filter_text;
+
+    const bool& narrow { narrowing != nullptr && filter_text.contains(narrowing->FilterText, Qt::CaseInsensitive) };
+    const qsizetype& candidate_count { narrow ? narrowing->VisibleProcesses.size() : table.Pids.size() };
+
+    result.VisibleProcesses.reserve(candidate_count);
+    result.VisibleWindowOffsets.reserve(candidate_count + 1);
+    result.VisibleWindowOffsets.append(0);
+
+    for(qsizetype i { 0 }; i < candidate_count; ++i) {
+        const quint32& process_index { narrow ? narrowing->VisibleProcesses[i] : static_cast<quint32>(i) };
+        const bool& process_matches { table.GetImageName(process_index).contains(filter_text, Qt::CaseInsensitive) };
+
+        // A window is listed if its own title matches, or if the process it belongs to matches.
+        const quint32& window_begin { narrow ? narrowing->VisibleWindowOffsets[i]     : table.FirstWindowIndexes[process_index] };
+        const quint32& window_end   { narrow ? narrowing->VisibleWindowOffsets[i + 1] : table.FirstWindowIndexes[process_index] + table.WindowCounts[process_index] };
+
+        for(quint32 j { window_begin }; j < window_end; ++j) {
+            const quint32& window_index { narrow ? narrowing->VisibleWindows[j] : j };
+
+            if(process_matches || table.GetTitle(window_index).contains(filter_text, Qt::CaseInsensitive)) {
+                result.VisibleWindows.append(window_index);
+            }
+        }
+
+        const qsizetype& visible_window_count { result.VisibleWindows.size() - result.VisibleWindowOffsets.last() };
+
+        if((process_matches || visible_window_count) && (!windows_only || visible_window_count)) {
+            result.VisibleProcesses.append(process_index);
+            result.VisibleWindowOffsets.append(static_cast<quint32>(result.VisibleWindows.size()));
+        } else {
+            result.VisibleWindows.resize(result.VisibleWindowOffsets.last());
+        }
+    }
+
+    return result;
+}
+
+void ProcessListModel::launchUpdate() {
+    updatePending = false;
+
+    const ProcessSnapshotPtr snapshot                  { pendingSnapshot   };
+    const std::shared_ptr<const ProcessTable> table    { processTable      };
+    const ProcessTableFilter previous_filter           { tableFilter       };
+    const QString filter_text                          { pendingFilterText };
+    const bool windows_only                            { windowsOnly       };
+
+    // Removals of snapshots that were coalesced or skipped are only dropped from the icon cache along with the next table.
+    QVector<DWORD> removed_pids;
+
+    if(snapshot != nullptr) {
+        removed_pids = std::move(pendingRemovedPids);
+        pendingRemovedPids.clear();
+    }
+
+    pendingSnapshot.reset();
+
+    updateWatcher->setFuture(QtConcurrent::run([snapshot, table, previous_filter, filter_text, windows_only, removed_pids { std::move(removed_pids) }]() -> UpdateResult {
+        UpdateResult result;
+
+        // A new table invalidates the previous filter's indexes, so only a filter change can narrow the previous result.
+        if(snapshot != nullptr) {
+            result.Table = ProcessTable::FromSnapshot(*snapshot, windows_only);
+            result.Filter = ProcessTableFilter::Compute(*result.Table, filter_text, windows_only);
+            result.RemovedPids = removed_pids;
+        } else {
+            result.Table = table != nullptr ? table : std::make_shared<const ProcessTable>();
+            result.Filter = ProcessTableFilter::Compute(*result.Table, filter_text, windows_only, table != nullptr ? &previous_filter : nullptr);
+        }
+        return result;
+    }));
+}
+
+void ProcessListModel::applyUpdate() {
+    UpdateResult result { updateWatcher->result() };
+
+    for(const DWORD& pid : std::as_const(result.RemovedPids)) {
+        iconCache.remove(pid);
+    }
+
+    emit layoutAboutToBeChanged();
+
+    /* Rows are identified by PID and window handle rather than position, so that persistent indexes
+     * (the selection, the current row and expanded processes) follow their rows into the new layout.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    const QModelIndexList old_indexes { persistentIndexList() };
+    QVector<QPair<DWORD, HWND>> old_identities;
+    old_identities.reserve(old_indexes.size());
+
+    for(const QModelIndex& old_index : old_indexes) {
+        const quintptr& parent_row { old_index.internalId() };
+
+        if(parent_row == 0) {
+            old_identities.append(qMakePair(processTable->Pids[tableFilter.VisibleProcesses[old_index.row()]], HWND { nullptr }));
+        } else {
+            const quint32& window_index { tableFilter.VisibleWindows[tableFilter.VisibleWindowOffsets[parent_row - 1] + old_index.row()] };
+            old_identities.append(qMakePair(processTable->Pids[tableFilter.VisibleProcesses[parent_row - 1]], processTable->WindowHandles[window_index]));
+        }
+    }
+
+    processTable = std::move(result.Table);
+    tableFilter = std::move(result.Filter);
+
+    if(!old_indexes.isEmpty()) {
+        QHash<DWORD, qint32> process_rows;
+        process_rows.reserve(tableFilter.VisibleProcesses.size());
+
+        for(qint32 row { 0 }; row < tableFilter.VisibleProcesses.size(); ++row) {
+            process_rows.insert(processTable->Pids[tableFilter.VisibleProcesses[row]], row);
+        }
+
+        QModelIndexList new_indexes;
+        new_indexes.reserve(old_indexes.size());
+
+        for(qsizetype i { 0 }; i < old_indexes.size(); ++i) {
+            const qint32& process_row { process_rows.value(old_identities[i].first, -1) };
+            QModelIndex new_index;
+
+            if(process_row != -1 && old_identities[i].second == nullptr) {
+                new_index = createIndex(process_row, old_indexes[i].column(), quintptr { 0 });
+            } else if(process_row != -1) {
+                const quint32& window_begin { tableFilter.VisibleWindowOffsets[process_row]     };
+                const quint32& window_end   { tableFilter.VisibleWindowOffsets[process_row + 1] };
+
+                for(quint32 j { window_begin }; j < window_end; ++j) {
+                    if(processTable->WindowHandles[tableFilter.VisibleWindows[j]] == old_identities[i].second) {
+                        new_index = createIndex(static_cast<qint32>(j - window_begin), old_indexes[i].column(), static_cast<quintptr>(process_row + 1));
+                        break;
+                    }
+                }
+            }
+
+            new_indexes.append(new_index);
+        }
+
+        changePersistentIndexList(old_indexes, new_indexes);
+    }
+
+    emit layoutChanged();
+
+    if(updatePending) {
+        launchUpdate();
+    }
+}
+
+QIcon ProcessListModel::loadProcessIcon(DWORD pid) const {
+    HANDLE process_handle { OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid) };
+
+    if(process_handle == nullptr) {
+        return QIcon {};
+    }
+
+    wchar_t image_path[MAX_PATH];
+    DWORD image_path_size { MAX_PATH };
+
+    const BOOL& query_result { QueryFullProcessImageNameW(process_handle, 0, image_path, &image_path_size) };
+    CloseHandle(process_handle);
+
+    if(!query_result) {
+        return QIcon {};
+    }
+
+    static const QFileIconProvider icon_provider;
+    return icon_provider.icon(QFileInfo { QString::fromWCharArray(image_path, image_path_size) });
+}
+
+void ProcessListModel::SetSnapshot(ProcessSnapshotPtr snapshot) {
+    if(snapshot == nullptr) {
+        return;
+    }
+
+    // Every snapshot's removals are kept, as each one only lists the PIDs missing since the one before it.
+    pendingRemovedPids.append(snapshot->RemovedPids);
+
+    if(windowsOnly && !snapshot->HasWindows) {
+        return;
+    }
+
+    pendingSnapshot = std::move(snapshot);
+
+    if(updateWatcher->isRunning()) {
+        updatePending = true;
+    } else {
+        launchUpdate();
+    }
+}
+
+void ProcessListModel::SetFilterText(const QString& filter_text) {
+    pendingFilterText = filter_text;
+
+    if(updateWatcher->isRunning()) {
+        updatePending = true;
+    } else {
+        launchUpdate();
+    }
+}
+
+bool ProcessListModel::GetSelection(const QModelIndex& index, QString& out_text, HWND& out_window_handle) const {
+    if(!index.isValid()) {
+        return false;
+    }
+
+    const quintptr& parent_row { index.internalId() };
+
+    if(parent_row == 0) {
+        out_text = processTable->GetImageName(tableFilter.VisibleProcesses[index.row()]).toString();
+        out_window_handle = nullptr;
+    } else {
+        const quint32& window_index { tableFilter.VisibleWindows[tableFilter.VisibleWindowOffsets[parent_row - 1] + index.row()] };
+        out_text = processTable->GetTitle(window_index).toString();
+        out_window_handle = processTable->WindowHandles[window_index];
+    }
+
+    return true;
+}
+
+QModelIndex ProcessListModel::index(int row, int column, const QModelIndex& parent) const {
+    if(!hasIndex(row, column, parent)) {
+        return QModelIndex {};
+    }
+
+    // The internal ID of an index is zero for processes, and the row of the parent process plus one for windows.
+    return createIndex(row, column, parent.isValid() ? static_cast<quintptr>(parent.row() + 1) : quintptr { 0 });
+}
+
+QModelIndex ProcessListModel::parent(const QModelIndex& child) const {
+    if(!child.isValid() || child.internalId() == 0) {
+        return QModelIndex {};
+    }
+
+    return createIndex(static_cast<qint32>(child.internalId() - 1), 0, quintptr { 0 });
+}
+
+int ProcessListModel::rowCount(const QModelIndex& parent) const {
+    if(!parent.isValid()) {
+        return static_cast<int>(tableFilter.VisibleProcesses.size());
+    }
+
+    if(parent.internalId() != 0 || parent.column() != 0) {
+        return 0;
+    }
+
+    return static_cast<int>(tableFilter.VisibleWindowOffsets[parent.row() + 1] - tableFilter.VisibleWindowOffsets[parent.row()]);
+}
+
+int ProcessListModel::columnCount(const QModelIndex& parent) const {
+    Q_UNUSED(parent)
+    return 2;
+}
+
+QVariant ProcessListModel::data(const QModelIndex& index, int role) const {
+    if(!index.isValid()) {
+        return QVariant {};
+    }
+
+    const quintptr& parent_row { index.internalId() };
+
+    if(parent_row != 0) {
+        if(role == Qt::DisplayRole && index.column() == 0) {
+            return processTable->GetTitle(tableFilter.VisibleWindows[tableFilter.VisibleWindowOffsets[parent_row - 1] + index.row()]).toString();
+        }
+
+        return QVariant {};
+    }
+
+    const quint32& process_index { tableFilter.VisibleProcesses[index.row()] };
+
+    if(role == Qt::DisplayRole) {
+        return index.column() == 0
+                ? QVariant { processTable->GetImageName(process_index).toString() }
+                : QVariant { static_cast<quint32>(processTable->Pids[process_index]) };
+    }
+
+    if(role == Qt::DecorationRole && index.column() == 0) {
+        const DWORD& pid { processTable->Pids[process_index] };
+        auto iterator { iconCache.find(pid) };
+
+        // Failed lookups are cached too, as processes that can't be opened now won't be openable on the next paint either.
+        if(iterator == iconCache.end()) {
+            iterator = iconCache.insert(pid, loadProcessIcon(pid));
+        }
+
+        return iterator.value();
+    }
+
+    return QVariant {};
+}
+
+QVariant ProcessListModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant {};
+    }
+
+    return section == 0 ? QString { "Name" } : QString { "PID" };
+}
+
+ProcessListModel::ProcessListModel(bool windows_only, QObject* parent)
+    :
+      QAbstractItemModel    { parent                                                    },
+      windowsOnly           { windows_only                                              },
+      processTable          { std::make_shared<const ProcessTable>()                    },
+      tableFilter           { ProcessTableFilter::Compute(ProcessTable {}, {}, false)   },
+      updatePending         { false                                                     },
+      updateWatcher         { new QFutureWatcher<UpdateResult> { this }                 }
+{
+    connect(updateWatcher, &QFutureWatcher<UpdateResult>::finished,
+            this,          &ProcessListModel::applyUpdate);
+}
+
+ProcessListModel::~ProcessListModel() {
+    updateWatcher->waitForFinished();
+}
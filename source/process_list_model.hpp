@@ -0,0 +1,101 @@
+#ifndef PROCESS_LIST_MODEL_HPP
+#define PROCESS_LIST_MODEL_HPP
+
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QStringView>
+#include <QtCore/QHash>
+
+#include <QtGui/QIcon>
+
+#include <memory>
+
+#include "process_snapshot_service.hpp"
+
+/* Columnar copy of a ProcessSnapshot, laid out for fast filtering: every string lives in a single
+ * arena and is referred to by offset and length, and every other attribute is its own array. Processes
+ * are sorted case-insensitively by image name, and windows are grouped by the process that owns them.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+struct ProcessTable {
+    QString             StringArena;
+
+    QVector<DWORD>      Pids;
+    QVector<quint32>    ImageNameOffsets;
+    QVector<quint32>    ImageNameLengths;
+    QVector<quint32>    FirstWindowIndexes;    // Index of the process' first window in the window arrays.
+    QVector<quint32>    WindowCounts;
+
+    QVector<HWND>       WindowHandles;
+    QVector<quint32>    TitleOffsets;
+    QVector<quint32>    TitleLengths;
+
+    QStringView         GetImageName(qsizetype process_index) const;
+    QStringView         GetTitle(qsizetype window_index) const;
+
+    static std::shared_ptr<const ProcessTable> FromSnapshot(const ProcessSnapshot& snapshot, bool include_windows);
+};
+
+// The rows of a ProcessTable that pass a filter, with the visible windows of each visible process stored contiguously.
+struct ProcessTableFilter {
+    QString             FilterText;
+    QVector<quint32>    VisibleProcesses;           // Indexes into the ProcessTable process arrays.
+    QVector<quint32>    VisibleWindowOffsets;       // VisibleProcesses.size() + 1 prefix offsets into VisibleWindows.
+    QVector<quint32>    VisibleWindows;             // Indexes into the ProcessTable window arrays.
+
+    /* Filters the table by case-insensitive substring. When narrowing is given, and this filter's text
+     * contains the text it was computed with, only its rows are tested, as no other row can match.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    static ProcessTableFilter Compute(const ProcessTable& table, const QString& filter_text, bool windows_only, const ProcessTableFilter* narrowing = nullptr);
+};
+
+/* Tree model over a ProcessTable, with processes at the top level and their windows as children.
+ * Rebuilding the table and filtering it both happen on a worker thread; the model only swaps in
+ * the result, remapping persistent indexes so that the selection and expanded rows survive updates.
+ * Process icons are only resolved once a view asks for them, which is only ever for visible rows.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ProcessListModel : public QAbstractItemModel {
+Q_OBJECT
+
+protected:
+    struct UpdateResult {
+        std::shared_ptr<const ProcessTable>    Table;
+        ProcessTableFilter                     Filter;
+        QVector<DWORD>                         RemovedPids;
+    };
+
+    const bool                             windowsOnly;
+
+    std::shared_ptr<const ProcessTable>    processTable;
+    ProcessTableFilter                     tableFilter;
+
+    ProcessSnapshotPtr                     pendingSnapshot;
+    QVector<DWORD>                         pendingRemovedPids;
+    QString                                pendingFilterText;
+    bool                                   updatePending;
+    QFutureWatcher<UpdateResult>*          updateWatcher;
+
+    mutable QHash<DWORD, QIcon>            iconCache;
+
+    void            launchUpdate();
+    Q_SLOT void     applyUpdate();
+
+    QIcon           loadProcessIcon(DWORD pid) const;
+
+public:
+    Q_SLOT void     SetSnapshot(ProcessSnapshotPtr snapshot);
+    Q_SLOT void     SetFilterText(const QString& filter_text);
+
+    bool            GetSelection(const QModelIndex& index, QString& out_text, HWND& out_window_handle) const;
+
+    virtual QModelIndex    index(int row, int column, const QModelIndex& parent = QModelIndex {}) const override;
+    virtual QModelIndex    parent(const QModelIndex& child) const override;
+    virtual int            rowCount(const QModelIndex& parent = QModelIndex {}) const override;
+    virtual int            columnCount(const QModelIndex& parent = QModelIndex {}) const override;
+    virtual QVariant       data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    virtual QVariant       headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    explicit ProcessListModel(bool windows_only, QObject* parent = nullptr);
+    virtual ~ProcessListModel() override;
+};
+
+#endif // PROCESS_LIST_MODEL_HPP
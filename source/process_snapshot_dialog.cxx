@@ -0,0 +1,70 @@
+#include "process_snapshot_dialog.hxx"
+#include "ui_process_snapshot_dialog.h"
+
+void ProcessSnapshotDialog::emitSelection() {
+    QString selection;
+    HWND window_handle { nullptr };
+
+    if(!processListModel->GetSelection(ui->treeSnapshot->currentIndex(), selection, window_handle)) {
+        return;
+    }
+
+    if(scanScope == SCAN_SCOPE::PROCESS_MODE && window_handle == nullptr) {
+        emit treeSelectionMade(selection, nullptr);
+    } else if(scanScope == SCAN_SCOPE::WINDOW_MODE && window_handle != nullptr) {
+        emit treeSelectionMade(selection, window_handle);
+    }
+}
+
+ProcessSnapshotDialog::ProcessSnapshotDialog(ProcessSnapshotService* process_snapshot_service, SCAN_SCOPE scan_scope, QWidget* parent)
+    :
+      QDialog                   { parent                                                                },
+      ui                        { new Ui::ProcessSnapshotDialog                                         },
+      processSnapshotService    { process_snapshot_service                                              },
+      scanScope                 { scan_scope                                                            },
+      processListModel          { new ProcessListModel { scan_scope == SCAN_SCOPE::WINDOW_MODE, this }  }
+{
+    ui->setupUi(this);
+
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    setWindowFlags(
+                Qt::Dialog
+                | Qt::CustomizeWindowHint
+                | Qt::WindowTitleHint
+                | Qt::WindowCloseButtonHint
+                | Qt::WindowMaximizeButtonHint
+                );
+
+    setWindowTitle(scanScope == SCAN_SCOPE::PROCESS_MODE ? "Select Process" : "Select Window");
+    ui->treeSnapshot->setModel(processListModel);
+
+    connect(ui->leditFilter,     &QLineEdit::textChanged,
+            processListModel,    &ProcessListModel::SetFilterText);
+
+    connect(ui->treeSnapshot,    &QTreeView::doubleClicked,
+            this,                &ProcessSnapshotDialog::emitSelection);
+
+    connect(ui->btnSelect,       &QPushButton::clicked,
+            this,                &ProcessSnapshotDialog::emitSelection);
+
+    connect(ui->btnCancel,       &QPushButton::clicked,
+            this,                &ProcessSnapshotDialog::close);
+
+    connect(processSnapshotService, &ProcessSnapshotService::SnapshotPublished,
+            processListModel,       &ProcessListModel::SetSnapshot);
+
+    processSnapshotService->AddSubscriber(scanScope == SCAN_SCOPE::WINDOW_MODE);
+
+    // Windows aren't enumerated until somebody asks for them, so window mode can't start from the cached snapshot.
+    if(scanScope == SCAN_SCOPE::PROCESS_MODE && processSnapshotService->GetLatestSnapshot() != nullptr) {
+        processListModel->SetSnapshot(processSnapshotService->GetLatestSnapshot());
+    } else {
+        processSnapshotService->TakeSnapshot();
+    }
+}
+
+ProcessSnapshotDialog::~ProcessSnapshotDialog() {
+    processSnapshotService->RemoveSubscriber(scanScope == SCAN_SCOPE::WINDOW_MODE);
+    delete ui;
+}
@@ -0,0 +1,42 @@
+#ifndef PROCESS_SNAPSHOT_DIALOG_HXX
+#define PROCESS_SNAPSHOT_DIALOG_HXX
+
+#include <QtWidgets/QDialog>
+
+#include "process_snapshot_service.hpp"
+#include "process_list_model.hpp"
+
+QT_BEGIN_NAMESPACE
+namespace Ui { class ProcessSnapshotDialog; }
+QT_END_NAMESPACE
+
+/* Lets the user pick a process image name or a window title from the snapshots published by a
+ * ProcessSnapshotService, rather than enumerating processes itself. The list is a view over a
+ * ProcessListModel, which rebuilds and filters its table off the GUI thread, so the dialog stays
+ * responsive with thousands of processes and windows.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ProcessSnapshotDialog : public QDialog {
+Q_OBJECT
+
+public:
+    enum struct SCAN_SCOPE {
+        PROCESS_MODE,    // Select a process image name.
+        WINDOW_MODE      // Select the title of a visible top-level window, listed under its process.
+    };
+
+protected:
+    Ui::ProcessSnapshotDialog*    ui;
+    ProcessSnapshotService*       processSnapshotService;
+    const SCAN_SCOPE              scanScope;
+    ProcessListModel*             processListModel;
+
+    Q_SLOT void    emitSelection();
+
+public:
+    Q_SIGNAL void  treeSelectionMade(QString selection, HWND window_handle);
+
+    explicit ProcessSnapshotDialog(ProcessSnapshotService* process_snapshot_service, SCAN_SCOPE scan_scope, QWidget* parent = nullptr);
+    virtual ~ProcessSnapshotDialog() override;
+};
+
+#endif // PROCESS_SNAPSHOT_DIALOG_HXX
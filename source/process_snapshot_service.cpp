@@ -0,0 +1,272 @@
+#include "process_snapshot_service.hpp"
+#include "metrics_registry.hpp"
+#include "memory_audit.hpp"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QtDebug>
+
+#include <algorithm>
+
+namespace {
+    MetricsRegistry::Histogram& scanDurationMetric {
+        MetricsRegistry::Instance().RegisterHistogram("cursorlocker_process_scan_duration_seconds", {}, "Time taken to enumerate processes (and windows, if requested) for one snapshot.", MetricsRegistry::LatencyBucketsUs(), 1e-6)
+    };
+
+    MetricsRegistry::Counter& scanWakeupsMetric {
+        MetricsRegistry::Instance().RegisterCounter("cursorlocker_poll_wakeups_total", "source=\"process_scan\"", "Number of times a polling timer woke the process up.")
+    };
+
+    MetricsRegistry::Counter& recycledSnapshotsMetric {
+        MetricsRegistry::Instance().RegisterCounter("cursorlocker_process_snapshots_recycled_total", {}, "Number of scans that reused the buffers of an earlier snapshot instead of allocating new ones.")
+    };
+
+    MetricsRegistry::Histogram& scanAllocationsMetric {
+        MetricsRegistry::Instance().RegisterHistogram("cursorlocker_tick_heap_allocations", "tick=\"process_scan\"", "Heap allocations made on the GUI thread per polling tick, including what the subscribers did with it; only counted in debug builds.", MemoryAudit::AllocationBuckets())
+    };
+}
+
+const ProcessSnapshot::Process* ProcessSnapshot::FindProcess(DWORD pid) const {
+    const auto& process {
+        std::lower_bound(Processes.cbegin(), Processes.cend(), pid, [](const Process& process, DWORD pid) -> bool {
+            return process.Pid < pid;
+        })
+    };
+
+    return (process != Processes.cend() && process->Pid == pid) ? &(*process) : nullptr;
+}
+
+bool ProcessSnapshot::IsInSession(const Process& process) const {
+    return process.SessionId == SessionId || process.SessionId == ANY_SESSION || SessionId == ANY_SESSION;
+}
+
+bool ProcessSnapshot::ContainsImageName(const QString& image_name, bool own_session_only) const {
+    return std::any_of(Processes.cbegin(), Processes.cend(), [&](const Process& process) -> bool {
+        return process.ImageName == image_name && (!own_session_only || IsInSession(process));
+    });
+}
+
+ProcessSnapshot::ProcessSnapshot()
+    :
+      HasWindows           { false       },
+      SessionId            { ANY_SESSION },
+      SequenceNumber       { 0           },
+      EnumerationTimeNs    { 0           }
+{
+
+}
+
+
+
+std::shared_ptr<ProcessSnapshot> ProcessSnapshotService::acquireSnapshot() {
+    // Snapshots are only ever shared through shared_ptr, so a use count of 1 means no consumer, on any thread, can still read it.
+    if(spareSnapshot != nullptr && spareSnapshot.use_count() == 1) {
+        std::shared_ptr<ProcessSnapshot> snapshot { std::move(spareSnapshot) };
+
+        // Clearing keeps the capacity of the containers, unless a consumer copied one of them, in which case that copy keeps the buffer instead.
+        snapshot->Processes.clear();
+        snapshot->Windows.clear();
+        snapshot->HasWindows = false;
+        snapshot->AddedPids.clear();
+        snapshot->RemovedPids.clear();
+
+        recycledSnapshotsMetric.Increment();
+        return snapshot;
+    }
+
+    spareSnapshot.reset();
+    return std::make_shared<ProcessSnapshot>();
+}
+
+bool ProcessSnapshotService::enumerateProcesses(QVector<ProcessSnapshot::Process>& out_processes) {
+    HANDLE process_snapshot { CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0) };
+
+    if(process_snapshot == INVALID_HANDLE_VALUE) {
+        qCritical() << "Invalid handle value for snapshot of type TH32CS_SNAPPROCESS. Cannot see running tasks!";
+        return false;
+    }
+
+    PROCESSENTRY32 process_entry_32;
+    process_entry_32.dwSize = sizeof(PROCESSENTRY32);
+
+    if(Process32First(process_snapshot, &process_entry_32)) {
+        do {
+            DWORD session_id { ProcessSnapshot::ANY_SESSION };
+
+            if(!ProcessIdToSessionId(process_entry_32.th32ProcessID, &session_id)) {
+                session_id = ProcessSnapshot::ANY_SESSION;
+            }
+
+            out_processes.append({
+                process_entry_32.th32ProcessID,
+                process_entry_32.th32ParentProcessID,
+                session_id,
+                imageNames.Intern(QStringView { process_entry_32.szExeFile })
+            });
+        } while(Process32Next(process_snapshot, &process_entry_32));
+    }
+
+    CloseHandle(process_snapshot);
+
+    std::sort(out_processes.begin(), out_processes.end(), [](const ProcessSnapshot::Process& lhs, const ProcessSnapshot::Process& rhs) -> bool {
+        return lhs.Pid < rhs.Pid;
+    });
+
+    return true;
+}
+
+void ProcessSnapshotService::enumerateWindows(QVector<ProcessSnapshot::Window>& out_windows) const {
+    EnumWindows([](HWND window_handle, LPARAM l_param) -> BOOL {
+        QVector<ProcessSnapshot::Window>& windows { *reinterpret_cast<QVector<ProcessSnapshot::Window>*>(l_param) };
+
+        const qint32& title_length { GetWindowTextLength(window_handle) };
+
+        if(!IsWindowVisible(window_handle) || title_length <= 0) {
+            return TRUE;
+        }
+
+        ProcessSnapshot::Window window { window_handle, 0, QString {} };
+        GetWindowThreadProcessId(window_handle, &window.Pid);
+
+        window.Title.resize(title_length + 1);
+        window.Title.resize(GetWindowText(window_handle, reinterpret_cast<wchar_t*>(window.Title.data()), title_length + 1));
+
+        windows.append(window);
+        return TRUE;
+    }, reinterpret_cast<LPARAM>(&out_windows));
+
+    std::stable_sort(out_windows.begin(), out_windows.end(), [](const ProcessSnapshot::Window& lhs, const ProcessSnapshot::Window& rhs) -> bool {
+        return lhs.Pid < rhs.Pid;
+    });
+}
+
+void ProcessSnapshotService::updateTimerState() {
+    if(!paused && processSubscriberCount + windowSubscriberCount > 0) {
+        if(!snapshotTimer->isActive()) {
+            snapshotTimer->start();
+        }
+    } else {
+        snapshotTimer->stop();
+    }
+}
+
+void ProcessSnapshotService::TakeSnapshot() {
+    const MemoryAudit::AllocationCounter allocation_counter { scanAllocationsMetric };
+
+    QElapsedTimer enumeration_timer;
+    enumeration_timer.start();
+
+    std::shared_ptr<ProcessSnapshot> snapshot { acquireSnapshot() };
+    snapshot->SessionId = sessionId;
+
+    if(latestSnapshot != nullptr) {
+        snapshot->Processes.reserve(latestSnapshot->Processes.size() + 32);
+    }
+
+    if(!enumerateProcesses(snapshot->Processes)) {
+        return;
+    }
+
+    if(windowSubscriberCount) {
+        enumerateWindows(snapshot->Windows);
+        snapshot->HasWindows = true;
+    }
+
+    // Both process lists are sorted by PID, so the difference is a single merge pass.
+    const QVector<ProcessSnapshot::Process>& previous_processes {
+        latestSnapshot != nullptr ? latestSnapshot->Processes : QVector<ProcessSnapshot::Process> {}
+    };
+
+    auto previous { previous_processes.cbegin() };
+    auto current  { snapshot->Processes.cbegin() };
+
+    while(previous != previous_processes.cend() || current != snapshot->Processes.cend()) {
+        if(current == snapshot->Processes.cend() || (previous != previous_processes.cend() && previous->Pid < current->Pid)) {
+            snapshot->RemovedPids.append((previous++)->Pid);
+        } else if(previous == previous_processes.cend() || current->Pid < previous->Pid) {
+            snapshot->AddedPids.append((current++)->Pid);
+        } else {
+            if(previous->ImageName != current->ImageName) {
+                snapshot->RemovedPids.append(previous->Pid);
+                snapshot->AddedPids.append(current->Pid);
+            }
+
+            ++previous;
+            ++current;
+        }
+    }
+
+    snapshot->SequenceNumber = latestSnapshot != nullptr ? latestSnapshot->SequenceNumber + 1 : 0;
+    snapshot->EnumerationTimeNs = enumeration_timer.nsecsElapsed();
+    scanDurationMetric.Observe(static_cast<quint64>(snapshot->EnumerationTimeNs / 1000));
+
+    spareSnapshot = std::move(latestSnapshot);
+    latestSnapshot = std::move(snapshot);
+
+    emit SnapshotPublished(latestSnapshot);
+}
+
+void ProcessSnapshotService::AddSubscriber(bool wants_windows) {
+    ++(wants_windows ? windowSubscriberCount : processSubscriberCount);
+    updateTimerState();
+}
+
+void ProcessSnapshotService::RemoveSubscriber(bool wants_windows) {
+    quint32& subscriber_count { wants_windows ? windowSubscriberCount : processSubscriberCount };
+
+    if(subscriber_count) {
+        --subscriber_count;
+    }
+
+    updateTimerState();
+}
+
+ProcessSnapshotPtr ProcessSnapshotService::GetLatestSnapshot() const {
+    return latestSnapshot;
+}
+
+void ProcessSnapshotService::SetInterval(qint32 interval_ms) {
+    snapshotTimer->setInterval(interval_ms);
+}
+
+void ProcessSnapshotService::SetPaused(bool pause) {
+    if(paused == pause) {
+        return;
+    }
+
+    paused = pause;
+    updateTimerState();
+
+    // Anything that started or exited while paused is reported at once, rather than up to one interval later.
+    if(!paused && processSubscriberCount + windowSubscriberCount > 0) {
+        TakeSnapshot();
+    }
+}
+
+ProcessSnapshotService::ProcessSnapshotService(QObject* parent)
+    :
+      QObject                   { parent                        },
+      snapshotTimer             { new QTimer { this }           },
+      latestSnapshot            { nullptr                       },
+      spareSnapshot             { nullptr                       },
+      imageNames                {                               },
+      processSubscriberCount    { 0                             },
+      windowSubscriberCount     { 0                             },
+      sessionId                 { ProcessSnapshot::ANY_SESSION  },
+      paused                    { false                         }
+{
+    if(!ProcessIdToSessionId(GetCurrentProcessId(), &sessionId)) {
+        sessionId = ProcessSnapshot::ANY_SESSION;
+    }
+
+    snapshotTimer->setInterval(500);
+
+    connect(snapshotTimer,  &QTimer::timeout,
+            this,           []() -> void { scanWakeupsMetric.Increment(); });
+
+    connect(snapshotTimer,  &QTimer::timeout,
+            this,           &ProcessSnapshotService::TakeSnapshot);
+}
+
+ProcessSnapshotService::~ProcessSnapshotService() {
+
+}
@@ -0,0 +1,116 @@
+#ifndef PROCESS_SNAPSHOT_SERVICE_HPP
+#define PROCESS_SNAPSHOT_SERVICE_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+#include <TlHelp32.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtCore/QMetaType>
+
+#include <memory>
+
+#include "string_interner.hpp"
+
+/* An immutable picture of the running processes (and optionally their visible top-level windows)
+ * taken by ProcessSnapshotService, along with what changed since the previous snapshot. Processes
+ * and windows are sorted by PID, so lookups are binary searches. Once published, a snapshot is never
+ * modified, so it can be shared between every consumer without copying. Toolhelp snapshots cover
+ * every session on the machine, so each process is tagged with its session; on a terminal server
+ * or a multi-user kiosk, a game started by another user mustn't activate this user's lock.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+struct ProcessSnapshot {
+    struct Process {
+        DWORD      Pid;
+        DWORD      ParentPid;
+        DWORD      SessionId;     // The Windows session the process runs in, or ANY_SESSION if it couldn't be queried.
+        QString    ImageName;
+    };
+
+    struct Window {
+        HWND       Handle;
+        DWORD      Pid;
+        QString    Title;
+    };
+
+    static constexpr DWORD ANY_SESSION { 0xFFFFFFFF };
+
+    QVector<Process>    Processes;         // Sorted by Pid.
+    QVector<Window>     Windows;           // Sorted by Pid, empty unless a subscriber asked for windows.
+    bool                HasWindows;
+
+    QVector<DWORD>      AddedPids;         // PIDs present in this snapshot but not the previous one; a reused PID counts as removed and added.
+    QVector<DWORD>      RemovedPids;       // PIDs present in the previous snapshot but not this one.
+
+    DWORD               SessionId;         // The session of the process that took the snapshot.
+    quint64             SequenceNumber;
+    qint64              EnumerationTimeNs;
+
+    const Process*      FindProcess(DWORD pid) const;
+    bool                IsInSession(const Process& process) const;    // Whether the process runs in SessionId; processes with an unknown session are given the benefit of the doubt.
+    bool                ContainsImageName(const QString& image_name, bool own_session_only = true) const;
+
+    ProcessSnapshot();
+};
+
+typedef std::shared_ptr<const ProcessSnapshot> ProcessSnapshotPtr;
+Q_DECLARE_METATYPE(ProcessSnapshotPtr)
+
+/* Enumerates processes once per interval on behalf of every consumer, instead of each consumer
+ * running its own enumeration. The timer only runs while there is at least one subscriber, and
+ * windows are only enumerated while at least one subscriber asked for them. While paused, the
+ * timer is stopped regardless of subscribers; resuming takes one catch-up snapshot right away.
+ *
+ * A scan doesn't allocate once the set of processes settles: image names are interned, and the
+ * snapshot published two scans ago is reused, buffers and all, once every consumer let go of it.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class ProcessSnapshotService : public QObject {
+Q_OBJECT
+
+protected:
+    QTimer*                             snapshotTimer;
+    std::shared_ptr<ProcessSnapshot>    latestSnapshot;
+    std::shared_ptr<ProcessSnapshot>    spareSnapshot;       // The snapshot before latestSnapshot, reused by the next scan if no consumer still holds it.
+    StringInterner                      imageNames;
+
+    quint32                             processSubscriberCount;
+    quint32                             windowSubscriberCount;
+    DWORD                               sessionId;           // The session this process runs in, stamped onto every snapshot.
+    bool                                paused;
+
+    std::shared_ptr<ProcessSnapshot>    acquireSnapshot();
+    bool                                enumerateProcesses(QVector<ProcessSnapshot::Process>& out_processes);
+    void                                enumerateWindows(QVector<ProcessSnapshot::Window>& out_windows) const;
+    void                                updateTimerState();
+
+public:
+    Q_SIGNAL void         SnapshotPublished(ProcessSnapshotPtr snapshot);
+
+    Q_SLOT void           TakeSnapshot();    // Enumerates immediately and publishes, regardless of the timer.
+
+    void                  AddSubscriber(bool wants_windows = false);
+    void                  RemoveSubscriber(bool wants_windows = false);
+
+    ProcessSnapshotPtr    GetLatestSnapshot() const;
+    void                  SetInterval(qint32 interval_ms);
+    void                  SetPaused(bool pause);
+
+    explicit ProcessSnapshotService(QObject* parent = nullptr);
+    virtual ~ProcessSnapshotService() override;
+};
+
+#endif // PROCESS_SNAPSHOT_SERVICE_HPP
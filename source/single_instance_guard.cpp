@@ -0,0 +1,112 @@
+#include "single_instance_guard.hpp"
+#include "control_client.hpp"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QtDebug>
+
+// Local\ scopes the mutex to the session, matching ControlServer::DefaultServerName, which carries the session ID.
+const QString SingleInstanceGuard::DefaultMutexName { "Local\\cursor-locker-instance" };
+
+bool SingleInstanceGuard::IsPrimaryInstance() const {
+    return primaryInstance;
+}
+
+QList<QStringList> SingleInstanceGuard::OptionsToRequests(const LaunchOptions& options) {
+    QList<QStringList> requests;
+
+    if(!options.TargetImage.isEmpty()) {
+        requests.append({ "target", "image " + options.TargetImage });
+    } else if(!options.TargetTitle.isEmpty()) {
+        requests.append({ "target", "title " + options.TargetTitle });
+    } else if(!options.TargetRule.isEmpty()) {
+        requests.append({ "target", "rule " + options.TargetRule });
+    } else if(!options.Hotkey.isEmpty()) {
+        requests.append({ "target", "hotkey " + options.Hotkey });
+    } else if(!options.Method.isEmpty()) {
+        requests.append({ "method", options.Method });
+    }
+
+    // The running instance outlives this one, so it only unlocks once the duration elapses, rather than exiting.
+    if(options.LockForMs > 0) {
+        requests.append({ "lock-for", QString::number(options.LockForMs) + "ms" });
+    } else if(options.Lock) {
+        requests.append({ "lock", QString {} });
+    } else if(options.Unlock) {
+        requests.append({ "unlock", QString {} });
+    } else if(options.Toggle) {
+        requests.append({ "toggle", QString {} });
+    }
+
+    if(requests.isEmpty()) {
+        requests.append({ "show", QString {} });
+    }
+
+    return requests;
+}
+
+QString SingleInstanceGuard::UnforwardableOption(const LaunchOptions& options) {
+    if(options.WaitForProcess) {
+        return "--wait-for-process";
+    }
+
+    if(options.MemoryReport) {
+        return "--memory-report";
+    }
+
+    if(!options.RecordPath.isEmpty()) {
+        return "--record";
+    }
+
+    return QString {};
+}
+
+bool SingleInstanceGuard::ForwardToPrimaryInstance(const QList<QStringList>& requests, QString& out_error, qint32 timeout_ms) {
+    ControlClient control_client;
+    QElapsedTimer connection_timer;
+
+    connection_timer.start();
+
+    // The primary instance only starts listening once its window has been constructed.
+    while(!control_client.Connect(ControlServer::DefaultServerName, 100)) {
+        if(connection_timer.elapsed() >= timeout_ms) {
+            out_error = control_client.GetLastError();
+            return false;
+        }
+
+        QThread::msleep(25);
+    }
+
+    // Lets the primary instance bring its window to the foreground in response to "show".
+    AllowSetForegroundWindow(ASFW_ANY);
+
+    for(const QStringList& request : requests) {
+        if(!control_client.Request(request.at(0), request.at(1))) {
+            out_error = request.at(0) + ": " + control_client.GetLastError();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+SingleInstanceGuard::SingleInstanceGuard(const QString& mutex_name)
+    :
+      mutexHandle        { CreateMutexW(nullptr, TRUE, reinterpret_cast<LPCWSTR>(mutex_name.utf16())) },
+      primaryInstance    { mutexHandle == nullptr || GetLastError() != ERROR_ALREADY_EXISTS }
+{
+    // Failing open; a second instance is less harmful than no instance at all.
+    if(mutexHandle == nullptr) {
+        qInfo() << "CreateMutexW failed for the single instance guard, GetLastError() =" << GetLastError();
+    }
+}
+
+SingleInstanceGuard::~SingleInstanceGuard() {
+    if(mutexHandle != nullptr) {
+        if(primaryInstance) {
+            ReleaseMutex(mutexHandle);
+        }
+
+        CloseHandle(mutexHandle);
+    }
+}
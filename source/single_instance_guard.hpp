@@ -0,0 +1,65 @@
+#ifndef SINGLE_INSTANCE_GUARD_HPP
+#define SINGLE_INSTANCE_GUARD_HPP
+
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+
+#ifndef UNICODE
+#define UNICODE
+#endif
+
+#ifndef WIN32_MEAN_AND_LEAN
+#define WIN32_MEAN_AND_LEAN
+#endif
+
+#include <Windows.h>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include "launch_options.hpp"
+
+/* Ensures that only one instance runs per session, as two instances would fight over ClipCursor
+ * and the same hotkey IDs. The first instance owns a named mutex for as long as the guard exists;
+ * the mutex is released by the system if the process dies, so a crash never leaves a stale lock
+ * behind, unlike a lock file. Later instances hand their arguments over to the first one through
+ * the control socket and exit, before constructing a QApplication or any widgets.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class SingleInstanceGuard {
+public:
+    static const QString DefaultMutexName;
+
+protected:
+    HANDLE    mutexHandle;
+    bool      primaryInstance;
+
+public:
+    bool      IsPrimaryInstance() const;
+
+    /* Translates launch options into control requests (e.g. --lock into "lock", --lock-for 90s into
+     * "lock-for 90000ms", --target-image <name> into "target image <name>"), or a request to show the
+     * window if there are none. Options that only concern the local process (e.g. --debug, --config)
+     * aren't forwarded.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    static QList<QStringList>    OptionsToRequests(const LaunchOptions& options);
+
+    /* Returns the first option that only makes sense for a new instance, as it changes how that instance
+     * runs or exits (e.g. --wait-for-process, --memory-report), or an empty string if there's none.
+     * Such options can't be forwarded, so a second instance should refuse them instead of dropping them.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    static QString               UnforwardableOption(const LaunchOptions& options);
+
+    /* Sends the requests to the primary instance, retrying the connection for up to timeout_ms in case
+     * it's still starting up. Returns false and sets out_error if any request failed.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    static bool                  ForwardToPrimaryInstance(const QList<QStringList>& requests, QString& out_error, qint32 timeout_ms = 2000);
+
+    explicit SingleInstanceGuard(const QString& mutex_name = DefaultMutexName);
+    ~SingleInstanceGuard();
+
+    SingleInstanceGuard(const SingleInstanceGuard&) = delete;
+    SingleInstanceGuard& operator=(const SingleInstanceGuard&) = delete;
+};
+
+#endif // SINGLE_INSTANCE_GUARD_HPP
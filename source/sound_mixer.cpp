@@ -0,0 +1,297 @@
+#include "sound_mixer.hpp"
+#include "metrics_registry.hpp"
+
+#include <QtCore/QFile>
+#include <QtCore/QtEndian>
+#include <QtCore/QtDebug>
+
+#include <QtMultimedia/QMediaDevices>
+#include <QtMultimedia/QAudioDevice>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cstring>
+
+namespace {
+    MetricsRegistry::Histogram& triggerLatencyMetric {
+        MetricsRegistry::Instance().RegisterHistogram("cursorlocker_sound_trigger_latency_seconds", {}, "Time from a sound cue being triggered to its first sample reaching the audio stream, including queued audio.", MetricsRegistry::LatencyBucketsUs(), 1e-6)
+    };
+
+    qint64 steadyClockNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+/* The pull-mode source of the audio sink. It never runs dry: whenever no cue is playing it
+ * produces silence, which keeps the backend stream open and ready for the next trigger.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class SoundMixer::OutputDevice : public QIODevice {
+protected:
+    SoundMixer& soundMixer;
+
+    virtual qint64 readData(char* data, qint64 max_size) override {
+        return soundMixer.mix(reinterpret_cast<qint16*>(data), max_size / static_cast<qint64>(sizeof(qint16))) * static_cast<qint64>(sizeof(qint16));
+    }
+
+    virtual qint64 writeData(const char* data, qint64 max_size) override {
+        Q_UNUSED(data)
+        Q_UNUSED(max_size)
+        return -1;
+    }
+
+public:
+    virtual bool isSequential() const override {
+        return true;
+    }
+
+    virtual qint64 bytesAvailable() const override {
+        return std::numeric_limits<qint32>::max();
+    }
+
+    explicit OutputDevice(SoundMixer& sound_mixer)
+        :
+          soundMixer    { sound_mixer }
+    {
+
+    }
+};
+
+bool SoundMixer::decodeWav(const QString& file_path, QAudioFormat& out_format, QVector<qint16>& out_samples) {
+    QFile wav_file { file_path };
+
+    if(!wav_file.open(QFile::ReadOnly)) {
+        qWarning() << "Could not open sound file" << file_path;
+        return false;
+    }
+
+    const QByteArray& wav_data { wav_file.readAll() };
+
+    if(wav_data.size() < 12 || !wav_data.startsWith("RIFF") || wav_data.mid(8, 4) != "WAVE") {
+        qWarning() << "Sound file" << file_path << "is not a RIFF/WAVE file.";
+        return false;
+    }
+
+    bool has_format { false };
+    qsizetype chunk_offset { 12 };
+
+    // Walk the chunk list; "fmt " has to appear before "data", and everything else (LIST, fact, ...) is skipped.
+    while(chunk_offset + 8 <= wav_data.size()) {
+        const QByteArray& chunk_id { wav_data.mid(chunk_offset, 4) };
+        const quint32& chunk_size  { qFromLittleEndian<quint32>(wav_data.constData() + chunk_offset + 4) };
+        const qsizetype& chunk_data_offset { chunk_offset + 8 };
+
+        if(chunk_size > static_cast<quint64>(wav_data.size() - chunk_data_offset)) {
+            break;
+        }
+
+        if(chunk_id == "fmt " && chunk_size >= 16) {
+            const char* format_chunk { wav_data.constData() + chunk_data_offset };
+
+            const quint16& format_tag      { qFromLittleEndian<quint16>(format_chunk)      };
+            const quint16& channel_count   { qFromLittleEndian<quint16>(format_chunk + 2)  };
+            const quint32& sample_rate     { qFromLittleEndian<quint32>(format_chunk + 4)  };
+            const quint16& bits_per_sample { qFromLittleEndian<quint16>(format_chunk + 14) };
+
+            if(format_tag != 1 || bits_per_sample != 16 || channel_count == 0) {
+                qWarning() << "Sound file" << file_path << "is not 16-bit PCM, which is the only format supported.";
+                return false;
+            }
+
+            out_format.setSampleFormat(QAudioFormat::Int16);
+            out_format.setChannelCount(channel_count);
+            out_format.setSampleRate(static_cast<int>(sample_rate));
+            has_format = true;
+        } else if(chunk_id == "data" && has_format) {
+            out_samples.resize(chunk_size / sizeof(qint16));
+
+            for(qsizetype i { 0 }; i < out_samples.size(); ++i) {
+                out_samples[i] = qFromLittleEndian<qint16>(wav_data.constData() + chunk_data_offset + i * sizeof(qint16));
+            }
+
+            return true;
+        }
+
+        // Chunks are padded to an even size.
+        chunk_offset = chunk_data_offset + chunk_size + (chunk_size & 1);
+    }
+
+    qWarning() << "Sound file" << file_path << "has no PCM data.";
+    return false;
+}
+
+qint64 SoundMixer::mix(qint16* out_samples, qint64 sample_count) {
+    const quint32& triggers { pendingTriggers.exchange(0, std::memory_order_acq_rel) };
+    const bool& is_muted { muted.load(std::memory_order_relaxed) };
+
+    if(triggers && !is_muted) {
+        const qint64& now_ns { steadyClockNs() };
+        const qint64& queued_us { audioFormat.durationForBytes(audioSink->bufferSize() - audioSink->bytesFree()) };
+
+        for(size_t cue { 0 }; cue < cueSamples.size(); ++cue) {
+            if(triggers & (1u << cue)) {
+                // Retriggering a cue that's still playing restarts it, the same way QSoundEffect::play did.
+                cuePositions[cue] = 0;
+                lastTriggerLatencyUs = (now_ns - triggerTimesNs[cue].load(std::memory_order_relaxed)) / 1000 + queued_us;
+                triggerLatencyMetric.Observe(static_cast<quint64>(std::max<qint64>(lastTriggerLatencyUs, 0)));
+            }
+        }
+    }
+
+    std::fill(out_samples, out_samples + sample_count, qint16 { 0 });
+
+    for(size_t cue { 0 }; cue < cueSamples.size(); ++cue) {
+        if(cuePositions[cue] < 0) {
+            continue;
+        }
+
+        if(is_muted) {
+            cuePositions[cue] = -1;
+            continue;
+        }
+
+        const QVector<qint16>& samples { cueSamples[cue] };
+        const qsizetype& mix_count { std::min<qsizetype>(sample_count, samples.size() - cuePositions[cue]) };
+
+        for(qsizetype i { 0 }; i < mix_count; ++i) {
+            const qint32& mixed_sample { out_samples[i] + samples[cuePositions[cue] + i] };
+            out_samples[i] = static_cast<qint16>(std::clamp<qint32>(mixed_sample, std::numeric_limits<qint16>::min(), std::numeric_limits<qint16>::max()));
+        }
+
+        cuePositions[cue] += mix_count;
+
+        if(cuePositions[cue] >= samples.size()) {
+            cuePositions[cue] = -1;
+        }
+    }
+
+    return sample_count;
+}
+
+bool SoundMixer::LoadCue(SOUND_CUE cue, const QString& file_path) {
+    if(cue >= SOUND_CUE::COUNT || outputThread.isRunning()) {
+        return false;
+    }
+
+    QAudioFormat cue_format;
+    QVector<qint16> samples;
+
+    if(!decodeWav(file_path, cue_format, samples)) {
+        return false;
+    }
+
+    // Every cue is mixed into the same stream, so they have to agree on a format; the first one loaded decides it.
+    if(!audioFormat.isValid()) {
+        audioFormat = cue_format;
+    } else if(cue_format != audioFormat) {
+        qWarning() << "Sound file" << file_path << "doesn't match the format of the previously loaded sounds, and was not loaded.";
+        return false;
+    }
+
+    cueSamples[static_cast<size_t>(cue)] = std::move(samples);
+    return true;
+}
+
+void SoundMixer::Trigger(SOUND_CUE cue) {
+    if(cue >= SOUND_CUE::COUNT || muted.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    triggerTimesNs[static_cast<size_t>(cue)].store(steadyClockNs(), std::memory_order_relaxed);
+    pendingTriggers.fetch_or(1u << static_cast<quint32>(cue), std::memory_order_release);
+}
+
+void SoundMixer::SetMuted(bool state) {
+    muted = state;
+}
+
+bool SoundMixer::IsMuted() const {
+    return muted;
+}
+
+qint64 SoundMixer::GetLastTriggerLatencyUs() const {
+    return lastTriggerLatencyUs;
+}
+
+bool SoundMixer::Start(qint32 buffer_duration_ms) {
+    if(outputThread.isRunning() || !audioFormat.isValid()) {
+        return false;
+    }
+
+    outputThread.start(QThread::TimeCriticalPriority);
+
+    bool started { false };
+
+    QMetaObject::invokeMethod(outputContext, [this, buffer_duration_ms, &started]() -> void {
+        const QAudioDevice& output_device { QMediaDevices::defaultAudioOutput() };
+
+        if(!output_device.isFormatSupported(audioFormat)) {
+            qWarning() << "The default audio output device" << output_device.description() << "doesn't support the format of the sound files.";
+        }
+
+        outputDevice = new OutputDevice { *this };
+        outputDevice->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+        audioSink = new QAudioSink { output_device, audioFormat };
+        audioSink->setBufferSize(audioFormat.bytesForDuration(buffer_duration_ms * 1000));
+        audioSink->start(outputDevice);
+
+        started = audioSink->error() == QAudio::NoError;
+
+        qInfo() << "Started sound mixer output stream on" << output_device.description()
+                << "with a buffer of" << audioSink->bufferSize() << "bytes:" << (started ? "success" : "failure");
+    }, Qt::BlockingQueuedConnection);
+
+    if(!started) {
+        Stop();
+    }
+
+    return started;
+}
+
+void SoundMixer::Stop() {
+    if(!outputThread.isRunning()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(outputContext, [this]() -> void {
+        audioSink->stop();
+
+        delete audioSink;
+        delete outputDevice;
+
+        audioSink = nullptr;
+        outputDevice = nullptr;
+    }, Qt::BlockingQueuedConnection);
+
+    outputThread.quit();
+    outputThread.wait();
+}
+
+bool SoundMixer::IsRunning() const {
+    return outputThread.isRunning();
+}
+
+SoundMixer::SoundMixer()
+    :
+      outputContext           { new QObject },
+      audioSink               { nullptr     },
+      outputDevice            { nullptr     },
+      pendingTriggers         { 0           },
+      muted                   { false       },
+      lastTriggerLatencyUs    { -1          }
+{
+    cuePositions.fill(-1);
+
+    for(std::atomic<qint64>& trigger_time_ns : triggerTimesNs) {
+        trigger_time_ns = 0;
+    }
+
+    outputThread.setObjectName("SoundMixerOutput");
+    outputContext->moveToThread(&outputThread);
+}
+
+SoundMixer::~SoundMixer() {
+    Stop();
+    delete outputContext;
+}
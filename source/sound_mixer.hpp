@@ -0,0 +1,98 @@
+#ifndef SOUND_MIXER_HPP
+#define SOUND_MIXER_HPP
+
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <array>
+#include <atomic>
+
+// Every sound cue the mixer can play. The underlying value doubles as the index into the mixer's cue tables.
+enum struct SOUND_CUE : quint8 {
+    LOCK_ACTIVATED         =   0,
+    LOCK_DEACTIVATED       =   1,
+    WINDOW_GRABBER_TICK    =   2,
+
+    COUNT
+};
+
+#ifndef CURSORLOCKER_NO_SOUND
+
+#include <QtMultimedia/QAudioFormat>
+#include <QtMultimedia/QAudioSink>
+
+/* Plays short sound cues through a single persistent audio stream. Every cue is decoded into PCM
+ * once when it's loaded, and the stream is kept open and fed silence in between cues, so that
+ * triggering a cue never has to wait for a backend stream to open. Trigger is a single atomic
+ * operation, and may be called from any thread, including the low-level keyboard hook thread.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class SoundMixer {
+protected:
+    class OutputDevice;
+
+    QThread                  outputThread;      // Owns the audio sink, so that the GUI thread being busy never starves the stream.
+    QObject*                 outputContext;     // Lives on outputThread; used to run the sink setup and teardown there.
+    QAudioSink*              audioSink;         // Only touched on outputThread.
+    OutputDevice*            outputDevice;      // Only touched on outputThread.
+    QAudioFormat             audioFormat;       // The format shared by every cue, taken from the first cue loaded.
+
+    std::array<QVector<qint16>, static_cast<size_t>(SOUND_CUE::COUNT)>       cueSamples;
+    std::array<qsizetype, static_cast<size_t>(SOUND_CUE::COUNT)>             cuePositions;      // Only touched on outputThread; -1 if the cue isn't playing.
+    std::array<std::atomic<qint64>, static_cast<size_t>(SOUND_CUE::COUNT)>   triggerTimesNs;    // steady_clock time of the most recent trigger of each cue.
+
+    std::atomic<quint32>     pendingTriggers;   // Bitmask of cues triggered since the output thread last mixed.
+    std::atomic<bool>        muted;
+    std::atomic<qint64>      lastTriggerLatencyUs;
+
+    static bool              decodeWav(const QString& file_path, QAudioFormat& out_format, QVector<qint16>& out_samples);
+    qint64                   mix(qint16* out_samples, qint64 sample_count);
+
+public:
+    bool                     LoadCue(SOUND_CUE cue, const QString& file_path);
+
+    void                     Trigger(SOUND_CUE cue);
+    void                     SetMuted(bool state);
+    bool                     IsMuted() const;
+
+    /* Time between the most recent trigger and its first sample reaching the audio backend, plus the
+     * audio that was already queued ahead of it at that point, in microseconds; or -1 if nothing was
+     * played yet. This doesn't include the latency of the backend and device themselves.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    qint64                   GetLastTriggerLatencyUs() const;
+
+    bool                     Start(qint32 buffer_duration_ms = 20);
+    void                     Stop();
+    bool                     IsRunning() const;
+
+    SoundMixer();
+    ~SoundMixer();
+};
+
+#else
+
+/* Stands in for the mixer in builds configured with CONFIG+=no_sound, which leave out the
+ * Qt Multimedia libraries and the cues entirely. Only the muted state is kept, for the UI.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class SoundMixer {
+protected:
+    std::atomic<bool>    muted { false };
+
+public:
+    bool      LoadCue(SOUND_CUE, const QString&)    { return false; }
+
+    void      Trigger(SOUND_CUE)                    { }
+    void      SetMuted(bool state)                  { muted = state; }
+    bool      IsMuted() const                       { return muted; }
+
+    qint64    GetLastTriggerLatencyUs() const       { return -1; }
+
+    bool      Start(qint32 = 20)                    { return false; }
+    void      Stop()                                { }
+    bool      IsRunning() const                     { return false; }
+};
+
+#endif // CURSORLOCKER_NO_SOUND
+
+#endif // SOUND_MIXER_HPP
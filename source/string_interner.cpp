@@ -0,0 +1,34 @@
+#include "string_interner.hpp"
+#include "metrics_registry.hpp"
+
+namespace {
+    MetricsRegistry::Counter& internHitsMetric    { MetricsRegistry::Instance().RegisterCounter("cursorlocker_string_intern_lookups_total", "result=\"hit\"", "Number of interned string lookups, by whether the string was already interned.") };
+    MetricsRegistry::Counter& internMissesMetric  { MetricsRegistry::Instance().RegisterCounter("cursorlocker_string_intern_lookups_total", "result=\"miss\"", "Number of interned string lookups, by whether the string was already interned.") };
+}
+
+QString StringInterner::Intern(QStringView string) {
+    const size_t& hash { qHash(string) };
+
+    for(auto entry { strings.constFind(hash) }; entry != strings.constEnd() && entry.key() == hash; ++entry) {
+        if(entry.value() == string) {
+            internHitsMetric.Increment();
+            return entry.value();
+        }
+    }
+
+    internMissesMetric.Increment();
+
+    if(strings.size() >= MAX_ENTRIES) {
+        Clear();
+    }
+
+    return strings.insert(hash, string.toString()).value();
+}
+
+qsizetype StringInterner::GetSize() const {
+    return strings.size();
+}
+
+void StringInterner::Clear() {
+    strings.clear();
+}
@@ -0,0 +1,28 @@
+#ifndef STRING_INTERNER_HPP
+#define STRING_INTERNER_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QStringView>
+#include <QtCore/QMultiHash>
+
+/* Hands out a single shared QString per distinct string, so that the strings a polling loop sees
+ * over and over again, such as the image names of processes that were already running during the
+ * previous scan, cost no allocation after the first time. Lookups hash the QStringView they're
+ * given, so a string that was seen before is never copied into a new QString just to find it. The
+ * table is cleared once it holds MAX_ENTRIES strings; the QStrings that were handed out stay
+ * valid regardless, as they're implicitly shared.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class StringInterner {
+public:
+    static constexpr qsizetype MAX_ENTRIES { 4096 };
+
+protected:
+    QMultiHash<size_t, QString>    strings;    // qHash of the string -> every interned string with that hash.
+
+public:
+    QString        Intern(QStringView string);
+    qsizetype      GetSize() const;
+    void           Clear();
+};
+
+#endif // STRING_INTERNER_HPP
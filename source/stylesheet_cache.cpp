@@ -0,0 +1,176 @@
+#include "stylesheet_cache.hpp"
+#include "metrics_registry.hpp"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFile>
+
+#include <QtWidgets/QStyle>
+
+namespace {
+    MetricsRegistry::Histogram& repolishTimeMetric       { MetricsRegistry::Instance().RegisterHistogram("cursorlocker_stylesheet_repolish_seconds", {}, "Time spent repolishing a line edit after its text changed.", MetricsRegistry::LatencyBucketsUs(), 1e-6) };
+    MetricsRegistry::Counter&   repolishesSkippedMetric  { MetricsRegistry::Instance().RegisterCounter("cursorlocker_stylesheet_repolishes_skipped_total", {}, "Line edit text changes that didn't need a repolish.") };
+}
+
+const QString StylesheetCache::EmbeddedDefaultPath { ":/styles/indigo.qss" };
+
+StylesheetCache::LOAD_RESULT StylesheetCache::Load(const QString& path, const Stylesheet*& out_stylesheet, QString& out_error) {
+    const QFileInfo stylesheet_info { path };
+
+    if(!stylesheet_info.exists() || !stylesheet_info.isFile()) {
+        return LOAD_RESULT::NOT_FOUND;
+    }
+
+    const QString& absolute_path { stylesheet_info.absoluteFilePath() };
+    const auto& existing_entry { entries.constFind(absolute_path) };
+
+    if(existing_entry != entries.constEnd() && existing_entry->LastModified == stylesheet_info.lastModified() && existing_entry->SourceSize == stylesheet_info.size()) {
+        out_stylesheet = &existing_entry.value();
+        return LOAD_RESULT::CACHED;
+    }
+
+    QFile stylesheet_file { absolute_path };
+
+    if(!stylesheet_file.open(QFile::ReadOnly | QFile::Text)) {
+        return LOAD_RESULT::IO_ERROR;
+    }
+
+    const QByteArray& source { stylesheet_file.readAll() };
+    stylesheet_file.close();
+
+    Stylesheet stylesheet {
+        stylesheet_info.lastModified(),
+        stylesheet_info.size(),
+        QCryptographicHash::hash(source, QCryptographicHash::Sha1),
+        QString {}
+    };
+
+    // Touched, but not modified; the compiled text is still good.
+    if(existing_entry != entries.constEnd() && existing_entry->ContentHash == stylesheet.ContentHash) {
+        stylesheet.Compiled = existing_entry->Compiled;
+        out_stylesheet = &entries.insert(absolute_path, stylesheet).value();
+        return LOAD_RESULT::CACHED;
+    }
+
+    if(!Compile(source, stylesheet.Compiled, out_error)) {
+        entries.remove(absolute_path);
+        return LOAD_RESULT::INVALID;
+    }
+
+    out_stylesheet = &entries.insert(absolute_path, stylesheet).value();
+    return LOAD_RESULT::COMPILED;
+}
+
+bool StylesheetCache::Compile(const QByteArray& source, QString& out_compiled, QString& out_error) {
+    const QString& text { QString::fromUtf8(source) };
+
+    // Whitespace next to these is never significant. Colons are only included on their right-hand side, as a
+    // space before one separates a widget from a descendant's pseudo-state or subcontrol, e.g. "QMenu ::item".
+    static const QString& separators_either_side { "{};,>" };
+
+    QString compiled;
+    compiled.reserve(text.size());
+
+    qsizetype brace_depth { 0 };
+    qsizetype line_number { 1 };
+    qsizetype string_start_line { 0 };
+    QChar     string_quote { };
+    bool      pending_space { false };
+
+    for(qsizetype i { 0 }; i < text.size(); ++i) {
+        const QChar& character { text.at(i) };
+
+        if(character == '\n') {
+            ++line_number;
+        }
+
+        if(!string_quote.isNull()) {
+            compiled.append(character);
+
+            if(character == '\\' && i + 1 < text.size()) {
+                compiled.append(text.at(++i));
+            } else if(character == string_quote) {
+                string_quote = QChar {};
+            } else if(character == '\n') {
+                out_error = QString { "Unterminated string starting on line %1" }.arg(string_start_line);
+                return false;
+            }
+
+            continue;
+        }
+
+        if(character == '/' && i + 1 < text.size() && text.at(i + 1) == '*') {
+            const qsizetype& comment_end { text.indexOf("*/", i + 2) };
+
+            if(comment_end < 0) {
+                out_error = QString { "Unterminated comment starting on line %1" }.arg(line_number);
+                return false;
+            }
+
+            line_number += QStringView { text }.mid(i, comment_end - i).count('\n');
+            i = comment_end + 1;
+            pending_space = true;    // A comment separates tokens just like whitespace does.
+            continue;
+        }
+
+        if(character.isSpace()) {
+            pending_space = true;
+            continue;
+        }
+
+        if(pending_space && !compiled.isEmpty()) {
+            const QChar& previous_character { compiled.back() };
+
+            if(!separators_either_side.contains(previous_character) && previous_character != ':' && !separators_either_side.contains(character)) {
+                compiled.append(' ');
+            }
+        }
+
+        pending_space = false;
+
+        if(character == '"' || character == '\'') {
+            string_quote = character;
+            string_start_line = line_number;
+        } else if(character == '{') {
+            ++brace_depth;
+        } else if(character == '}' && --brace_depth < 0) {
+            out_error = QString { "Unmatched closing brace on line %1" }.arg(line_number);
+            return false;
+        }
+
+        compiled.append(character);
+    }
+
+    if(!string_quote.isNull()) {
+        out_error = QString { "Unterminated string starting on line %1" }.arg(string_start_line);
+        return false;
+    }
+
+    if(brace_depth) {
+        out_error = QString { "%1 unclosed brace(s) at the end of the stylesheet" }.arg(brace_depth);
+        return false;
+    }
+
+    out_compiled = compiled;
+    return true;
+}
+
+void StylesheetCache::RepolishOnEmptinessChange(QLineEdit* line_edit) {
+    line_edit->setProperty("empty", line_edit->text().isEmpty());
+
+    QObject::connect(line_edit, &QLineEdit::textChanged, line_edit, [line_edit](const QString& text) -> void {
+        if(line_edit->property("empty").toBool() == text.isEmpty()) {
+            repolishesSkippedMetric.Increment();
+            return;
+        }
+
+        QElapsedTimer repolish_timer;
+        repolish_timer.start();
+
+        line_edit->setProperty("empty", text.isEmpty());
+        line_edit->style()->polish(line_edit);
+
+        repolishTimeMetric.Observe(static_cast<quint64>(repolish_timer.nsecsElapsed() / 1000));
+    });
+}
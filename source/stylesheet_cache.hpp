@@ -0,0 +1,55 @@
+#ifndef STYLESHEET_CACHE_HPP
+#define STYLESHEET_CACHE_HPP
+
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QHash>
+
+#include <QtWidgets/QLineEdit>
+
+/* Loads QSS stylesheets once and keeps them compiled: comments and redundant whitespace are
+ * stripped and the result is validated (balanced braces, terminated strings and comments) in a
+ * single pass. Entries are keyed by absolute path, and revalidated against the file's size and
+ * modification time, so reloading the settings doesn't even read the file unless it changed; if
+ * it was merely touched, the content hash still avoids compiling it again. Callers can compare
+ * ContentHash against what they applied last, to skip redundant setStyleSheet calls altogether.
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+class StylesheetCache {
+public:
+    static const QString EmbeddedDefaultPath;    // The default stylesheet, if it was compiled into the binary's resources.
+
+    enum struct LOAD_RESULT : quint8 {
+        CACHED,
+        COMPILED,
+        NOT_FOUND,
+        IO_ERROR,
+        INVALID
+    };
+
+    struct Stylesheet {
+        QDateTime     LastModified;
+        qint64        SourceSize;
+        QByteArray    ContentHash;    // Of the source, not the compiled text.
+        QString       Compiled;
+    };
+
+protected:
+    QHash<QString, Stylesheet>    entries;
+
+public:
+    /* Returns the compiled stylesheet at path through out_stylesheet, which stays valid until the next call
+     * for the same path. On INVALID, out_error describes the first problem found, with its line number.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    LOAD_RESULT          Load(const QString& path, const Stylesheet*& out_stylesheet, QString& out_error);
+
+    static bool          Compile(const QByteArray& source, QString& out_compiled, QString& out_error);
+
+    /* Replaces a textChanged -> style()->polish connection. QSS selectors can only tell an empty line edit
+     * apart from a non-empty one (e.g. [text=""]), so the widget is only repolished when that flips, rather
+     * than on every keystroke; the state is also exposed as the "empty" dynamic property for stylesheets.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    static void          RepolishOnEmptinessChange(QLineEdit* line_edit);
+};
+
+#endif // STYLESHEET_CACHE_HPP
@@ -0,0 +1,68 @@
+#include "vkid_table.hpp"
+
+bool VkidTable::ParseVkid(QStringView text, quint32& out_vkid) {
+    text = text.trimmed();
+
+    const auto& parse_hex_digits {
+        [](QStringView digits, quint32& out_value) -> bool {
+            if(digits.isEmpty() || digits.size() > 2) {
+                return false;
+            }
+
+            out_value = 0;
+
+            for(const QChar& digit : digits) {
+                const char16_t& character { digit.unicode() };
+                out_value <<= 4;
+
+                if(character >= '0' && character <= '9')         out_value |= character - '0';
+                else if(character >= 'a' && character <= 'f')    out_value |= character - 'a' + 10;
+                else if(character >= 'A' && character <= 'F')    out_value |= character - 'A' + 10;
+                else return false;
+            }
+
+            return true;
+        }
+    };
+
+    quint32 vkid { 0 };
+    bool parsed { false };
+
+    if(text.startsWith(u"0x", Qt::CaseInsensitive)) {
+        parsed = parse_hex_digits(text.mid(2), vkid);
+    } else {
+        if(text.startsWith(u"VK_", Qt::CaseInsensitive)) {
+            text = text.mid(3);
+        }
+
+        // Every name is short and ASCII, so it's copied into a stack buffer to be compared against the table.
+        std::array<char, 24> name_buffer {};
+
+        if(!text.isEmpty() && static_cast<size_t>(text.size()) <= name_buffer.size()) {
+            bool is_ascii { true };
+
+            for(qsizetype i { 0 }; i < text.size(); ++i) {
+                is_ascii &= text[i].unicode() < 0x80;
+                name_buffer[i] = static_cast<char>(text[i].unicode());
+            }
+
+            const Entry* entry { is_ascii ? FromName(std::string_view { name_buffer.data(), static_cast<size_t>(text.size()) }) : nullptr };
+
+            if(entry != nullptr) {
+                vkid = entry->Vkid;
+                parsed = true;
+            }
+        }
+
+        if(!parsed) {
+            parsed = parse_hex_digits(text, vkid);
+        }
+    }
+
+    if(!parsed || vkid == 0x00 || vkid == 0xFF) {
+        return false;
+    }
+
+    out_vkid = vkid;
+    return true;
+}
@@ -0,0 +1,352 @@
+#ifndef VKID_TABLE_HPP
+#define VKID_TABLE_HPP
+
+#include <QtCore/QStringView>
+#include <QtCore/QtGlobal>
+
+#include <array>
+#include <string_view>
+
+/* Static VKID <-> name <-> X11 keysym tables. Everything is built at compile time, including the
+ * name and keysym indexes used for binary searches and the "0x??" strings used for display, so that
+ * parsing, formatting and translating VKIDs never allocates. A keysym of 0 means that the key has no
+ * unambiguous X11 equivalent (e.g. mouse buttons, or the generic Shift/Ctrl/Alt VKIDs, whose keysyms
+ * belong to their left-hand counterparts).
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+namespace VkidTable {
+    struct Entry {
+        quint8              Vkid;
+        const char*         Name;           // The VK_ constant name without its prefix, e.g. "NUMPAD0".
+        const char*         Description;
+        quint32             Keysym;
+    };
+
+    inline constexpr Entry Entries[] {
+        { 0x01, "LBUTTON",               "Left mouse button",               0x00000000 },
+        { 0x02, "RBUTTON",               "Right mouse button",              0x00000000 },
+        { 0x03, "CANCEL",                "Control-break processing",        0x0000FF69 },
+        { 0x04, "MBUTTON",               "Middle mouse button",             0x00000000 },
+        { 0x05, "XBUTTON1",              "X1 mouse button",                 0x00000000 },
+        { 0x06, "XBUTTON2",              "X2 mouse button",                 0x00000000 },
+        { 0x08, "BACK",                  "Backspace",                       0x0000FF08 },
+        { 0x09, "TAB",                   "Tab",                             0x0000FF09 },
+        { 0x0C, "CLEAR",                 "Clear",                           0x0000FF0B },
+        { 0x0D, "RETURN",                "Enter",                           0x0000FF0D },
+        { 0x10, "SHIFT",                 "Shift",                           0x00000000 },
+        { 0x11, "CONTROL",               "Ctrl",                            0x00000000 },
+        { 0x12, "MENU",                  "Alt",                             0x00000000 },
+        { 0x13, "PAUSE",                 "Pause",                           0x0000FF13 },
+        { 0x14, "CAPITAL",               "Caps Lock",                       0x0000FFE5 },
+        { 0x15, "KANA",                  "IME Kana / Hangul mode",          0x0000FF2D },
+        { 0x16, "IME_ON",                "IME On",                          0x00000000 },
+        { 0x17, "JUNJA",                 "IME Junja mode",                  0x00000000 },
+        { 0x18, "FINAL",                 "IME final mode",                  0x00000000 },
+        { 0x19, "KANJI",                 "IME Kanji / Hanja mode",          0x0000FF21 },
+        { 0x1A, "IME_OFF",               "IME Off",                         0x00000000 },
+        { 0x1B, "ESCAPE",                "Esc",                             0x0000FF1B },
+        { 0x1C, "CONVERT",               "IME convert",                     0x0000FF23 },
+        { 0x1D, "NONCONVERT",            "IME nonconvert",                  0x0000FF22 },
+        { 0x1E, "ACCEPT",                "IME accept",                      0x00000000 },
+        { 0x1F, "MODECHANGE",            "IME mode change request",         0x0000FF7E },
+        { 0x20, "SPACE",                 "Spacebar",                        0x00000020 },
+        { 0x21, "PRIOR",                 "Page Up",                         0x0000FF55 },
+        { 0x22, "NEXT",                  "Page Down",                       0x0000FF56 },
+        { 0x23, "END",                   "End",                             0x0000FF57 },
+        { 0x24, "HOME",                  "Home",                            0x0000FF50 },
+        { 0x25, "LEFT",                  "Left Arrow",                      0x0000FF51 },
+        { 0x26, "UP",                    "Up Arrow",                        0x0000FF52 },
+        { 0x27, "RIGHT",                 "Right Arrow",                     0x0000FF53 },
+        { 0x28, "DOWN",                  "Down Arrow",                      0x0000FF54 },
+        { 0x29, "SELECT",                "Select",                          0x0000FF60 },
+        { 0x2A, "PRINT",                 "Print",                           0x00000000 },
+        { 0x2B, "EXECUTE",               "Execute",                         0x0000FF62 },
+        { 0x2C, "SNAPSHOT",              "Print Screen",                    0x0000FF61 },
+        { 0x2D, "INSERT",                "Insert",                          0x0000FF63 },
+        { 0x2E, "DELETE",                "Delete",                          0x0000FFFF },
+        { 0x2F, "HELP",                  "Help",                            0x0000FF6A },
+        { 0x30, "0",                     "0 key",                           0x00000030 },
+        { 0x31, "1",                     "1 key",                           0x00000031 },
+        { 0x32, "2",                     "2 key",                           0x00000032 },
+        { 0x33, "3",                     "3 key",                           0x00000033 },
+        { 0x34, "4",                     "4 key",                           0x00000034 },
+        { 0x35, "5",                     "5 key",                           0x00000035 },
+        { 0x36, "6",                     "6 key",                           0x00000036 },
+        { 0x37, "7",                     "7 key",                           0x00000037 },
+        { 0x38, "8",                     "8 key",                           0x00000038 },
+        { 0x39, "9",                     "9 key",                           0x00000039 },
+        { 0x41, "A",                     "A key",                           0x00000061 },
+        { 0x42, "B",                     "B key",                           0x00000062 },
+        { 0x43, "C",                     "C key",                           0x00000063 },
+        { 0x44, "D",                     "D key",                           0x00000064 },
+        { 0x45, "E",                     "E key",                           0x00000065 },
+        { 0x46, "F",                     "F key",                           0x00000066 },
+        { 0x47, "G",                     "G key",                           0x00000067 },
+        { 0x48, "H",                     "H key",                           0x00000068 },
+        { 0x49, "I",                     "I key",                           0x00000069 },
+        { 0x4A, "J",                     "J key",                           0x0000006A },
+        { 0x4B, "K",                     "K key",                           0x0000006B },
+        { 0x4C, "L",                     "L key",                           0x0000006C },
+        { 0x4D, "M",                     "M key",                           0x0000006D },
+        { 0x4E, "N",                     "N key",                           0x0000006E },
+        { 0x4F, "O",                     "O key",                           0x0000006F },
+        { 0x50, "P",                     "P key",                           0x00000070 },
+        { 0x51, "Q",                     "Q key",                           0x00000071 },
+        { 0x52, "R",                     "R key",                           0x00000072 },
+        { 0x53, "S",                     "S key",                           0x00000073 },
+        { 0x54, "T",                     "T key",                           0x00000074 },
+        { 0x55, "U",                     "U key",                           0x00000075 },
+        { 0x56, "V",                     "V key",                           0x00000076 },
+        { 0x57, "W",                     "W key",                           0x00000077 },
+        { 0x58, "X",                     "X key",                           0x00000078 },
+        { 0x59, "Y",                     "Y key",                           0x00000079 },
+        { 0x5A, "Z",                     "Z key",                           0x0000007A },
+        { 0x5B, "LWIN",                  "Left Windows key",                0x0000FFEB },
+        { 0x5C, "RWIN",                  "Right Windows key",               0x0000FFEC },
+        { 0x5D, "APPS",                  "Applications key",                0x0000FF67 },
+        { 0x5F, "SLEEP",                 "Computer Sleep",                  0x1008FF2F },
+        { 0x60, "NUMPAD0",               "Numpad 0",                        0x0000FFB0 },
+        { 0x61, "NUMPAD1",               "Numpad 1",                        0x0000FFB1 },
+        { 0x62, "NUMPAD2",               "Numpad 2",                        0x0000FFB2 },
+        { 0x63, "NUMPAD3",               "Numpad 3",                        0x0000FFB3 },
+        { 0x64, "NUMPAD4",               "Numpad 4",                        0x0000FFB4 },
+        { 0x65, "NUMPAD5",               "Numpad 5",                        0x0000FFB5 },
+        { 0x66, "NUMPAD6",               "Numpad 6",                        0x0000FFB6 },
+        { 0x67, "NUMPAD7",               "Numpad 7",                        0x0000FFB7 },
+        { 0x68, "NUMPAD8",               "Numpad 8",                        0x0000FFB8 },
+        { 0x69, "NUMPAD9",               "Numpad 9",                        0x0000FFB9 },
+        { 0x6A, "MULTIPLY",              "Numpad *",                        0x0000FFAA },
+        { 0x6B, "ADD",                   "Numpad +",                        0x0000FFAB },
+        { 0x6C, "SEPARATOR",             "Numpad separator",                0x0000FFAC },
+        { 0x6D, "SUBTRACT",              "Numpad -",                        0x0000FFAD },
+        { 0x6E, "DECIMAL",               "Numpad .",                        0x0000FFAE },
+        { 0x6F, "DIVIDE",                "Numpad /",                        0x0000FFAF },
+        { 0x70, "F1",                    "F1",                              0x0000FFBE },
+        { 0x71, "F2",                    "F2",                              0x0000FFBF },
+        { 0x72, "F3",                    "F3",                              0x0000FFC0 },
+        { 0x73, "F4",                    "F4",                              0x0000FFC1 },
+        { 0x74, "F5",                    "F5",                              0x0000FFC2 },
+        { 0x75, "F6",                    "F6",                              0x0000FFC3 },
+        { 0x76, "F7",                    "F7",                              0x0000FFC4 },
+        { 0x77, "F8",                    "F8",                              0x0000FFC5 },
+        { 0x78, "F9",                    "F9",                              0x0000FFC6 },
+        { 0x79, "F10",                   "F10",                             0x0000FFC7 },
+        { 0x7A, "F11",                   "F11",                             0x0000FFC8 },
+        { 0x7B, "F12",                   "F12",                             0x0000FFC9 },
+        { 0x7C, "F13",                   "F13",                             0x0000FFCA },
+        { 0x7D, "F14",                   "F14",                             0x0000FFCB },
+        { 0x7E, "F15",                   "F15",                             0x0000FFCC },
+        { 0x7F, "F16",                   "F16",                             0x0000FFCD },
+        { 0x80, "F17",                   "F17",                             0x0000FFCE },
+        { 0x81, "F18",                   "F18",                             0x0000FFCF },
+        { 0x82, "F19",                   "F19",                             0x0000FFD0 },
+        { 0x83, "F20",                   "F20",                             0x0000FFD1 },
+        { 0x84, "F21",                   "F21",                             0x0000FFD2 },
+        { 0x85, "F22",                   "F22",                             0x0000FFD3 },
+        { 0x86, "F23",                   "F23",                             0x0000FFD4 },
+        { 0x87, "F24",                   "F24",                             0x0000FFD5 },
+        { 0x90, "NUMLOCK",               "Num Lock",                        0x0000FF7F },
+        { 0x91, "SCROLL",                "Scroll Lock",                     0x0000FF14 },
+        { 0xA0, "LSHIFT",                "Left Shift",                      0x0000FFE1 },
+        { 0xA1, "RSHIFT",                "Right Shift",                     0x0000FFE2 },
+        { 0xA2, "LCONTROL",              "Left Ctrl",                       0x0000FFE3 },
+        { 0xA3, "RCONTROL",              "Right Ctrl",                      0x0000FFE4 },
+        { 0xA4, "LMENU",                 "Left Alt",                        0x0000FFE9 },
+        { 0xA5, "RMENU",                 "Right Alt",                       0x0000FFEA },
+        { 0xA6, "BROWSER_BACK",          "Browser Back",                    0x1008FF26 },
+        { 0xA7, "BROWSER_FORWARD",       "Browser Forward",                 0x1008FF27 },
+        { 0xA8, "BROWSER_REFRESH",       "Browser Refresh",                 0x1008FF29 },
+        { 0xA9, "BROWSER_STOP",          "Browser Stop",                    0x1008FF28 },
+        { 0xAA, "BROWSER_SEARCH",        "Browser Search",                  0x1008FF1B },
+        { 0xAB, "BROWSER_FAVORITES",     "Browser Favorites",               0x1008FF30 },
+        { 0xAC, "BROWSER_HOME",          "Browser Start and Home",          0x1008FF18 },
+        { 0xAD, "VOLUME_MUTE",           "Volume Mute",                     0x1008FF12 },
+        { 0xAE, "VOLUME_DOWN",           "Volume Down",                     0x1008FF11 },
+        { 0xAF, "VOLUME_UP",             "Volume Up",                       0x1008FF13 },
+        { 0xB0, "MEDIA_NEXT_TRACK",      "Next Track",                      0x1008FF17 },
+        { 0xB1, "MEDIA_PREV_TRACK",      "Previous Track",                  0x1008FF16 },
+        { 0xB2, "MEDIA_STOP",            "Stop Media",                      0x1008FF15 },
+        { 0xB3, "MEDIA_PLAY_PAUSE",      "Play/Pause Media",                0x1008FF14 },
+        { 0xB4, "LAUNCH_MAIL",           "Start Mail",                      0x1008FF19 },
+        { 0xB5, "LAUNCH_MEDIA_SELECT",   "Select Media",                    0x1008FF32 },
+        { 0xB6, "LAUNCH_APP1",           "Start Application 1",             0x1008FF40 },
+        { 0xB7, "LAUNCH_APP2",           "Start Application 2",             0x1008FF41 },
+        { 0xBA, "OEM_1",                 "; : (US layout)",                 0x0000003B },
+        { 0xBB, "OEM_PLUS",              "+",                               0x0000003D },
+        { 0xBC, "OEM_COMMA",             ",",                               0x0000002C },
+        { 0xBD, "OEM_MINUS",             "-",                               0x0000002D },
+        { 0xBE, "OEM_PERIOD",            ".",                               0x0000002E },
+        { 0xBF, "OEM_2",                 "/ ? (US layout)",                 0x0000002F },
+        { 0xC0, "OEM_3",                 "` ~ (US layout)",                 0x00000060 },
+        { 0xDB, "OEM_4",                 "[ { (US layout)",                 0x0000005B },
+        { 0xDC, "OEM_5",                 "\\ | (US layout)",                0x0000005C },
+        { 0xDD, "OEM_6",                 "] } (US layout)",                 0x0000005D },
+        { 0xDE, "OEM_7",                 "' \" (US layout)",                0x00000027 },
+        { 0xDF, "OEM_8",                 "Miscellaneous",                   0x00000000 },
+        { 0xE2, "OEM_102",               "< > or \\ | (102-key layout)",    0x0000003C },
+        { 0xE5, "PROCESSKEY",            "IME PROCESS key",                 0x00000000 },
+        { 0xE7, "PACKET",                "Unicode packet",                  0x00000000 },
+        { 0xF6, "ATTN",                  "Attn",                            0x00000000 },
+        { 0xF7, "CRSEL",                 "CrSel",                           0x00000000 },
+        { 0xF8, "EXSEL",                 "ExSel",                           0x00000000 },
+        { 0xF9, "EREOF",                 "Erase EOF",                       0x00000000 },
+        { 0xFA, "PLAY",                  "Play",                            0x00000000 },
+        { 0xFB, "ZOOM",                  "Zoom",                            0x00000000 },
+        { 0xFC, "NONAME",                "Reserved",                        0x00000000 },
+        { 0xFD, "PA1",                   "PA1",                             0x00000000 },
+        { 0xFE, "OEM_CLEAR",             "Clear",                           0x00000000 },
+    };
+
+    inline constexpr size_t EntryCount { sizeof(Entries) / sizeof(Entry) };
+
+    namespace Detail {
+        constexpr char ToUpper(char character) {
+            return (character >= 'a' && character <= 'z') ? static_cast<char>(character - 'a' + 'A') : character;
+        }
+
+        // Case insensitive comparison, <0, 0 or >0 in the same manner as strcmp.
+        constexpr int CompareNames(std::string_view lhs, std::string_view rhs) {
+            for(size_t i { 0 }; i < lhs.size() && i < rhs.size(); ++i) {
+                const char& lhs_upper { ToUpper(lhs[i]) };
+                const char& rhs_upper { ToUpper(rhs[i]) };
+
+                if(lhs_upper != rhs_upper) {
+                    return lhs_upper < rhs_upper ? -1 : 1;
+                }
+            }
+
+            return lhs.size() == rhs.size() ? 0 : (lhs.size() < rhs.size() ? -1 : 1);
+        }
+
+        constexpr std::array<qint16, 256> BuildVkidIndex() {
+            std::array<qint16, 256> vkid_index {};
+
+            for(size_t i { 0 }; i < vkid_index.size(); ++i) {
+                vkid_index[i] = -1;
+            }
+
+            for(size_t i { 0 }; i < EntryCount; ++i) {
+                vkid_index[Entries[i].Vkid] = static_cast<qint16>(i);
+            }
+
+            return vkid_index;
+        }
+
+        constexpr std::array<quint8, EntryCount> BuildNameIndex() {
+            std::array<quint8, EntryCount> name_index {};
+
+            for(size_t i { 0 }; i < EntryCount; ++i) {
+                name_index[i] = static_cast<quint8>(i);
+
+                // Insertion sort, which is stable and trivially constexpr.
+                for(size_t j { i }; j > 0 && CompareNames(Entries[name_index[j]].Name, Entries[name_index[j - 1]].Name) < 0; --j) {
+                    const quint8 swap_buffer { name_index[j] };
+                    name_index[j] = name_index[j - 1];
+                    name_index[j - 1] = swap_buffer;
+                }
+            }
+
+            return name_index;
+        }
+
+        constexpr size_t CountKeysyms() {
+            size_t keysym_count { 0 };
+
+            for(size_t i { 0 }; i < EntryCount; ++i) {
+                keysym_count += Entries[i].Keysym != 0;
+            }
+
+            return keysym_count;
+        }
+
+        constexpr std::array<quint8, CountKeysyms()> BuildKeysymIndex() {
+            std::array<quint8, CountKeysyms()> keysym_index {};
+            size_t keysym_count { 0 };
+
+            for(size_t i { 0 }; i < EntryCount; ++i) {
+                if(!Entries[i].Keysym) {
+                    continue;
+                }
+
+                keysym_index[keysym_count] = static_cast<quint8>(i);
+
+                for(size_t j { keysym_count }; j > 0 && Entries[keysym_index[j]].Keysym < Entries[keysym_index[j - 1]].Keysym; --j) {
+                    const quint8 swap_buffer { keysym_index[j] };
+                    keysym_index[j] = keysym_index[j - 1];
+                    keysym_index[j - 1] = swap_buffer;
+                }
+
+                ++keysym_count;
+            }
+
+            return keysym_index;
+        }
+
+        constexpr std::array<std::array<char, 5>, 256> BuildHexStrings() {
+            constexpr const char* hex_digits { "0123456789ABCDEF" };
+            std::array<std::array<char, 5>, 256> hex_strings {};
+
+            for(size_t i { 0 }; i < hex_strings.size(); ++i) {
+                hex_strings[i][0] = '0';
+                hex_strings[i][1] = 'x';
+                hex_strings[i][2] = hex_digits[i >> 4];
+                hex_strings[i][3] = hex_digits[i & 0xF];
+                hex_strings[i][4] = '\0';
+            }
+
+            return hex_strings;
+        }
+
+        inline constexpr std::array<qint16, 256>                   VkidIndex     { BuildVkidIndex()   };
+        inline constexpr std::array<quint8, EntryCount>            NameIndex     { BuildNameIndex()   };
+        inline constexpr std::array<quint8, CountKeysyms()>        KeysymIndex   { BuildKeysymIndex() };
+        inline constexpr std::array<std::array<char, 5>, 256>      HexStrings    { BuildHexStrings()  };
+    }
+
+    constexpr const Entry* FromVkid(quint32 vkid) {
+        return (vkid < Detail::VkidIndex.size() && Detail::VkidIndex[vkid] >= 0) ? &Entries[Detail::VkidIndex[vkid]] : nullptr;
+    }
+
+    constexpr const Entry* FromName(std::string_view name) {
+        size_t lower_bound { 0 }, upper_bound { Detail::NameIndex.size() };
+
+        while(lower_bound < upper_bound) {
+            const size_t& middle { lower_bound + (upper_bound - lower_bound) / 2 };
+            const int& comparison { Detail::CompareNames(Entries[Detail::NameIndex[middle]].Name, name) };
+
+            if(comparison == 0) return &Entries[Detail::NameIndex[middle]];
+            if(comparison < 0)  lower_bound = middle + 1;
+            else                upper_bound = middle;
+        }
+
+        return nullptr;
+    }
+
+    constexpr const Entry* FromKeysym(quint32 keysym) {
+        size_t lower_bound { 0 }, upper_bound { Detail::KeysymIndex.size() };
+
+        while(lower_bound < upper_bound) {
+            const size_t& middle { lower_bound + (upper_bound - lower_bound) / 2 };
+            const quint32& middle_keysym { Entries[Detail::KeysymIndex[middle]].Keysym };
+
+            if(middle_keysym == keysym) return &Entries[Detail::KeysymIndex[middle]];
+            if(middle_keysym < keysym)  lower_bound = middle + 1;
+            else                        upper_bound = middle;
+        }
+
+        return nullptr;
+    }
+
+    // Returns a static, null terminated "0x??" string, with two uppercase hexadecimal digits of the VKID's low byte.
+    constexpr const char* ToHexString(quint32 vkid) {
+        return Detail::HexStrings[vkid & 0xFF].data();
+    }
+
+    /* Parses a VKID from "0x6A" style hexadecimal, a VK_ name with or without its prefix (e.g. "F5",
+     * "VK_MULTIPLY", "k"), or bare hexadecimal digits (e.g. "6A") as a fallback, without allocating.
+     * Names take precedence over bare hexadecimal, so "A" is VK_A rather than 0x0A. Returns false if
+     * the text isn't any of those, or if the value is outside of 0x01 - 0xFE.
+     * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+    bool ParseVkid(QStringView text, quint32& out_vkid);
+}
+
+#endif // VKID_TABLE_HPP
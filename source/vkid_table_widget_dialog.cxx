@@ -1,11 +1,44 @@
 #include "vkid_table_widget_dialog.hxx"
 #include "ui_vkid_table_widget_dialog.h"
 
+void VkidTableWidgetDialog::populateTableFromVkidTable() {
+    ui->tableVkids->setColumnCount(4);
+    ui->tableVkids->setHorizontalHeaderLabels({ "VKID", "Name", "Description", "X11 Keysym" });
+    ui->tableVkids->setRowCount(static_cast<qint32>(VkidTable::EntryCount));
+
+    for(size_t row { 0 }; row < VkidTable::EntryCount; ++row) {
+        const VkidTable::Entry& entry { VkidTable::Entries[row] };
+
+        const QString& keysym_string {
+            entry.Keysym ? QString { "0x%1" }.arg(entry.Keysym, 4, 16, QChar { '0' }) : QString {}
+        };
+
+        ui->tableVkids->setItem(static_cast<qint32>(row), 0, new QTableWidgetItem { QLatin1String { VkidTable::ToHexString(entry.Vkid) } });
+        ui->tableVkids->setItem(static_cast<qint32>(row), 1, new QTableWidgetItem { QLatin1String { entry.Name }                          });
+        ui->tableVkids->setItem(static_cast<qint32>(row), 2, new QTableWidgetItem { QString::fromUtf8(entry.Description)                  });
+        ui->tableVkids->setItem(static_cast<qint32>(row), 3, new QTableWidgetItem { keysym_string                                         });
+    }
+
+    ui->tableVkids->resizeColumnsToContents();
+    ui->tableVkids->horizontalHeader()->setStretchLastSection(true);
+}
+
+void VkidTableWidgetDialog::filterTableRows(const QString& filter) {
+    for(qint32 row { 0 }; row < ui->tableVkids->rowCount(); ++row) {
+        bool row_matches { filter.isEmpty() };
+
+        for(qint32 column { 0 }; column < ui->tableVkids->columnCount() && !row_matches; ++column) {
+            row_matches = ui->tableVkids->item(row, column)->text().contains(filter, Qt::CaseInsensitive);
+        }
+
+        ui->tableVkids->setRowHidden(row, !row_matches);
+    }
+}
+
 VkidTableWidgetDialog::VkidTableWidgetDialog(QWidget* parent)
     :
       QDialog            { parent                        },
-      ui                 { new Ui::VkidTableWidgetDialog },
-      vkidTableWidget    { new VkidTableWidget { this }  }
+      ui                 { new Ui::VkidTableWidgetDialog }
 
 {
     ui->setupUi(this);
@@ -19,7 +52,11 @@ VkidTableWidgetDialog::VkidTableWidgetDialog(QWidget* parent)
                 | Qt::WindowMaximizeButtonHint
                 );
 
-    ui->verticalLayoutVkidTableWidgetPlaceholder->addLayout(vkidTableWidget);
+    populateTableFromVkidTable();
+
+    connect(ui->leditFilter,    &QLineEdit::textChanged,
+            this,               &VkidTableWidgetDialog::filterTableRows);
+
     setAttribute(Qt::WA_DeleteOnClose);
 }
 
@@ -2,8 +2,10 @@
 #define VKID_TABLE_WIDGET_DIALOG_HXX
 
 #include <QtWidgets/QDialog>
+#include <QtWidgets/QTableWidget>
+#include <QtWidgets/QHeaderView>
 
-#include <vkid_table_widget.hpp>
+#include "vkid_table.hpp"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class VkidTableWidgetDialog; }
@@ -13,7 +15,9 @@ class VkidTableWidgetDialog : public QDialog {
 Q_OBJECT
 protected:
     Ui::VkidTableWidgetDialog*    ui;
-    VkidTableWidget*              vkidTableWidget;
+
+    void          populateTableFromVkidTable();               // Fills tableVkids with one row per VkidTable::Entries entry.
+    Q_SLOT void   filterTableRows(const QString& filter);     // Hides the rows that don't contain the filter text in any column.
 
 public:
     explicit VkidTableWidgetDialog(QWidget* parent = nullptr);